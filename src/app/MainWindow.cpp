@@ -28,6 +28,7 @@
 #include <QShortcut>
 #include <QStandardPaths>
 #include <QTime>
+#include <QTimer>
 #include <QToolTip>
 #include <QtGlobal>
 
@@ -36,6 +37,9 @@
 namespace
 {
 constexpr auto uiEventSource{ "ui" };
+
+// Tabs of playlists not loaded yet show a placeholder with the id of the playlist
+constexpr auto pendingPlaylistIdProperty{ "pendingPlaylistId" };
 }
 
 MainWindow::MainWindow(QSettings &settings, LibraryManager &libraryManager, PlaylistManager &playlistManager, MediaPlayer &mediaPlayer)
@@ -74,13 +78,20 @@ MainWindow::MainWindow(QSettings &settings, LibraryManager &libraryManager, Play
     }
 
     restoreLastPlaylist();
+    loadPlaylistTab(getCurrentPlaylistTabIndex());
     enablePlaylistChangeTracking();
+    startBackgroundPlaylistLoading();
 
     QCoreApplication::instance()->installEventFilter(this);
 }
 
 MainWindow::~MainWindow() = default;
 
+void MainWindow::onAutoPlaylistChange(const AutoPlaylistChange &change)
+{
+    emit autoPlaylistChanged(change);
+}
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     settings_.setValue(config::geometryKey, saveGeometry());
@@ -240,6 +251,51 @@ void MainWindow::setupMenu()
             }
         });
 
+    fileMenu->addAction("Import playlist...", this,
+        [this]()
+        {
+            const auto filename = QFileDialog::getOpenFileName(this, "Import playlist",
+                QStandardPaths::standardLocations(QStandardPaths::HomeLocation).at(0),
+                "Playlists (*.m3u *.m3u8 *.pls *.xspf)");
+
+            if(filename.isEmpty())
+            {
+                return;
+            }
+
+            const auto index = playlistManager_.importPlaylist(filename);
+            if(not index)
+            {
+                qWarning() << "Playlist could not be imported from" << filename;
+                return;
+            }
+
+            const auto newTabIndex = setupPlaylistTab(*playlistManager_.get(*index));
+            if(newTabIndex != -1)
+            {
+                ui.playlist->setCurrentIndex(newTabIndex);
+            }
+        });
+
+    fileMenu->addAction("Export playlist...", this,
+        [this]()
+        {
+            const auto playlistId = getPlaylistIdByTabIndex(getCurrentPlaylistTabIndex());
+            if(not playlistId)
+            {
+                return;
+            }
+
+            const auto filename = QFileDialog::getSaveFileName(this, "Export playlist",
+                QStandardPaths::standardLocations(QStandardPaths::HomeLocation).at(0),
+                "M3U playlist (*.m3u8);;PLS playlist (*.pls);;XSPF playlist (*.xspf)");
+
+            if(not filename.isEmpty() and not playlistManager_.exportPlaylist(*playlistId, filename))
+            {
+                qWarning() << "Playlist could not be exported to" << filename;
+            }
+        });
+
     fileMenu->addAction("Preferences");
 
     auto *exitAction = fileMenu->addAction("Exit", this,
@@ -478,6 +534,21 @@ EscapableLineEdit *MainWindow::createPlaylistSearchWidget()
 }
 
 int MainWindow::setupPlaylistTab(Playlist &playlist)
+{
+    return ui.playlist->addTab(createPlaylistWidget(playlist), playlist.getName());
+}
+
+int MainWindow::setupPendingPlaylistTab(const PlaylistInfo &info)
+{
+    auto placeholder = std::make_unique<QLabel>(
+        info.trackCount ? QString{ "Loading %1 tracks..." }.arg(*info.trackCount) : QString{ "Loading..." });
+    placeholder->setAlignment(Qt::AlignCenter);
+    placeholder->setProperty(pendingPlaylistIdProperty, info.id.value);
+
+    return ui.playlist->addTab(std::move(placeholder), info.name);
+}
+
+std::unique_ptr<PlaylistWidget> MainWindow::createPlaylistWidget(Playlist &playlist)
 {
     const auto playlistId = playlist.getPlaylistId();
 
@@ -504,7 +575,22 @@ int MainWindow::setupPlaylistTab(Playlist &playlist)
             }
         });
 
+    connect(this, &MainWindow::autoPlaylistChanged, playlistModel.get(),
+        [playlistId, model = playlistModel.get()](const AutoPlaylistChange &change)
+        {
+            if(playlistId == change.playlistId)
+            {
+                model->onAutoPlaylistChange(change);
+            }
+        });
+
+
+    // Track and duration columns follow the widest strings the model keeps, rows are not measured
+    connect(playlistModel.get(), &PlaylistModel::widestStringChanged, playlistWidget.get(),
+        [widget = playlistWidget.get(), model = playlistModel.get()](int column)
+        { widget->fitColumnToText(column, model->getWidestString(column)); });
 
+    const auto *sourceModel = playlistModel.get();
     filterModel->setSourceModel(playlistModel.release());
 
     connect(playlistWidget.get(), &PlaylistWidget::itemPicked, this,
@@ -524,11 +610,16 @@ int MainWindow::setupPlaylistTab(Playlist &playlist)
     auto *header = playlistWidget->header();
     header->setSectionResizeMode(PlaylistColumn::NOW_PLAYING, QHeaderView::ResizeMode::Fixed);
     header->setSectionResizeMode(PlaylistColumn::ARTIST_ALBUM, QHeaderView::ResizeMode::Stretch);
-    header->setSectionResizeMode(PlaylistColumn::TRACK, QHeaderView::ResizeMode::ResizeToContents);
+    header->setSectionResizeMode(PlaylistColumn::TRACK, QHeaderView::ResizeMode::Fixed);
     header->setSectionResizeMode(PlaylistColumn::TITLE, QHeaderView::ResizeMode::Stretch);
-    header->setSectionResizeMode(PlaylistColumn::DURATION, QHeaderView::ResizeMode::ResizeToContents);
+    header->setSectionResizeMode(PlaylistColumn::DURATION, QHeaderView::ResizeMode::Fixed);
+
+    for(const auto column : { PlaylistColumn::TRACK, PlaylistColumn::DURATION })
+    {
+        playlistWidget->fitColumnToText(column, sourceModel->getWidestString(column));
+    }
 
-    return ui.playlist->addTab(std::move(playlistWidget), playlist.getName());
+    return playlistWidget;
 }
 
 void MainWindow::setupGlobalShortcuts()
@@ -726,7 +817,7 @@ void MainWindow::playMediaFromPlaylist(PlaylistId playlistId, std::size_t index)
         return;
     }
 
-    qDebug() << "Playing media:" << track->path;
+    qDebug() << "Playing media:" << track->path.toString();
 
     mediaPlayer_.setTrack(*track);
     mediaPlayer_.play();
@@ -801,13 +892,72 @@ void MainWindow::onMediaFinish(PlaylistId playlistId)
 
 void MainWindow::loadPlaylists()
 {
-    auto &playlists = playlistManager_.getAll();
-    for(auto &playlist : playlists)
+    for(const auto &info : playlistManager_.getPlaylistInfos())
+    {
+        if(auto *playlist = info.isLoaded ? playlistManager_.get(info.id) : nullptr; playlist)
+        {
+            setupPlaylistTab(*playlist);
+        }
+        else
+        {
+            setupPendingPlaylistTab(info);
+        }
+    }
+
+    // Playlist is loaded before anything else reacts to the tab change
+    connect(ui.playlist->tabBar(), &MultilineTabBar::currentChanged, this, &MainWindow::loadPlaylistTab);
+}
+
+void MainWindow::loadPlaylistTab(int tabIndex)
+{
+    auto *placeholder = ui.playlist->widget(tabIndex);
+    if(not placeholder or not placeholder->property(pendingPlaylistIdProperty).isValid())
+    {
+        return;
+    }
+
+    const PlaylistId playlistId{ placeholder->property(pendingPlaylistIdProperty).toUInt() };
+    auto *playlist = playlistManager_.get(playlistId);
+    if(not playlist)
+    {
+        qWarning() << "Playlist could not be loaded:" << ui.playlist->tabBar()->tabText(tabIndex);
+        placeholder->setProperty(pendingPlaylistIdProperty, QVariant{});
+        qobject_cast<QLabel *>(placeholder)->setText("Playlist could not be loaded");
+        return;
+    }
+
+    const auto isCurrent = tabIndex == getCurrentPlaylistTabIndex();
+    auto *playlistWidget = createPlaylistWidget(*playlist).release();
+    ui.playlist->replaceWidget(tabIndex, std::unique_ptr<QWidget>(playlistWidget));
+
+    if(isCurrent)
     {
-        setupPlaylistTab(playlist.second);
+        playlistWidget->setFocus(Qt::FocusReason::NoFocusReason);
     }
 }
 
+void MainWindow::startBackgroundPlaylistLoading()
+{
+    // One playlist per event loop iteration, so that the window stays responsive in between
+    auto *timer = new QTimer(this);
+    connect(timer, &QTimer::timeout, this,
+        [this, timer]()
+        {
+            for(int tabIndex = 0; tabIndex < ui.playlist->count(); ++tabIndex)
+            {
+                if(ui.playlist->widget(tabIndex)->property(pendingPlaylistIdProperty).isValid())
+                {
+                    loadPlaylistTab(tabIndex);
+                    return;
+                }
+            }
+
+            timer->deleteLater();
+        });
+
+    timer->start(0);
+}
+
 void MainWindow::enablePlaylistChangeTracking()
 {
     // Tracking cannot be enabled before playlists are loaded
@@ -879,18 +1029,23 @@ std::optional<PlaylistId> MainWindow::getPlaylistIdByTabIndex(int tabIndex)
     {
         return playlist->getPlaylistId();
     }
+
+    if(const auto *widget = ui.playlist->widget(tabIndex); widget)
+    {
+        if(const auto pendingId = widget->property(pendingPlaylistIdProperty); pendingId.isValid())
+        {
+            return PlaylistId{ pendingId.toUInt() };
+        }
+    }
+
     return std::nullopt;
 }
 
 std::optional<int> MainWindow::getTabIndexByPlaylistName(const QString &name)
 {
-    for(int tabIndex = 0; tabIndex < ui.playlist->count(); ++tabIndex)
+    if(const auto playlistId = playlistManager_.findByName(name); playlistId)
     {
-        const auto *playlist = getPlaylistByTabIndex(tabIndex);
-        if(playlist && name == playlist->getName())
-        {
-            return tabIndex;
-        }
+        return getTabIndexByPlaylistId(*playlistId);
     }
 
     return std::nullopt;
@@ -900,8 +1055,7 @@ std::optional<int> MainWindow::getTabIndexByPlaylistId(PlaylistId playlistId)
 {
     for(int tabIndex = 0; tabIndex < ui.playlist->count(); ++tabIndex)
     {
-        const auto *playlist = getPlaylistByTabIndex(tabIndex);
-        if(playlist && playlistId == playlist->getPlaylistId())
+        if(playlistId == getPlaylistIdByTabIndex(tabIndex))
         {
             return tabIndex;
         }
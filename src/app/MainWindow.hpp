@@ -1,5 +1,6 @@
 #pragma once
 
+#include "AutoPlaylistUpdater.hpp"
 #include "MediaPlayer.hpp"
 #include "Playlist.hpp"
 
@@ -14,6 +15,7 @@
 
 class Playlist;
 class PlaylistWidget;
+struct PlaylistInfo;
 class PlaylistManager;
 class LibraryManager;
 class MultilineTabWidget;
@@ -31,6 +33,9 @@ public:
     explicit MainWindow(QSettings &, LibraryManager &, PlaylistManager &, MediaPlayer &);
     ~MainWindow();
 
+    // Shows a change the updater made to an auto playlist in its open view
+    void onAutoPlaylistChange(const AutoPlaylistChange &);
+
 protected:
     void closeEvent(QCloseEvent *) override;
     bool eventFilter(QObject *, QEvent *) override;
@@ -44,6 +49,8 @@ private:
     void setupAlbumsBrowser();
     void setupPlaylistWidget();
     int setupPlaylistTab(Playlist &);
+    std::unique_ptr<PlaylistWidget> createPlaylistWidget(Playlist &);
+    int setupPendingPlaylistTab(const PlaylistInfo &);
 
     EscapableLineEdit *createPlaylistSearchWidget();
 
@@ -64,6 +71,8 @@ private:
 
     void onMediaFinish(PlaylistId playlistId);
     void loadPlaylists();
+    void loadPlaylistTab(int tabIndex);
+    void startBackgroundPlaylistLoading();
     void enablePlaylistChangeTracking();
 
     void restoreLastPlaylist();
@@ -81,6 +90,7 @@ signals:
     void removeDuplicates(PlaylistId);
     void updateSearchResult(QString);
     void playlistInsertRequest(PlaylistId, QStringList);
+    void autoPlaylistChanged(const AutoPlaylistChange &);
 
 private slots:
     void onPlaylistSearchCanceled();
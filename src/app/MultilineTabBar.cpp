@@ -3,6 +3,7 @@
 #include <QApplication>
 #include <QBoxLayout>
 #include <QPainter>
+#include <QSignalBlocker>
 #include <QStyleOptionTab>
 #include <QStylePainter>
 #include <QTimer>
@@ -328,3 +329,28 @@ std::unique_ptr<QWidget> MultilineTabWidget::removeTab(int tabIndex)
     }
     return widget;
 }
+
+std::unique_ptr<QWidget> MultilineTabWidget::replaceWidget(int tabIndex, std::unique_ptr<QWidget> widget)
+{
+    auto *previous = stack_->widget(tabIndex);
+    if(not previous or not widget)
+    {
+        return nullptr;
+    }
+
+    const auto isCurrent = stack_->currentIndex() == tabIndex;
+
+    {
+        // Removal would otherwise remove the tab as well, see privRemoveTab
+        const QSignalBlocker blocker{ stack_ };
+        stack_->insertWidget(tabIndex, widget.release());
+        stack_->removeWidget(previous);
+    }
+
+    if(isCurrent)
+    {
+        stack_->setCurrentIndex(tabIndex);
+    }
+
+    return std::unique_ptr<QWidget>(previous);
+}
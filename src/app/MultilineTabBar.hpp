@@ -97,6 +97,9 @@ public:
     int addTab(std::unique_ptr<QWidget> widget, QString tabText);
     std::unique_ptr<QWidget> removeTab(int tabIndex);
 
+    // Swaps the page of a tab, the tab itself stays in place
+    std::unique_ptr<QWidget> replaceWidget(int tabIndex, std::unique_ptr<QWidget> widget);
+
     int currentIndex()
     {
         return tabBar_->currentIndex();
@@ -3,22 +3,809 @@
 #include "Playlist.hpp"
 #include "PlaylistModel.hpp"
 
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace
+{
+// Tracks resolved at once, the batches go on while they fit the frame budget
+constexpr std::size_t resolveBatchSize{ 256 };
+constexpr qint64 resolveFrameBudgetNs{ 8'000'000 };
+} // namespace
+
 PlaylistFilterModel::PlaylistFilterModel(QObject *parent)
-: QSortFilterProxyModel{ parent }
+: QAbstractProxyModel{ parent }
+, engine{ [this](auto generation, auto matches, bool finished)
+    {
+        // Results are computed on worker threads, the model is updated on its own thread
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, matches = std::move(matches), finished]() mutable
+            { onFilterResults(generation, std::move(matches), finished); },
+            Qt::QueuedConnection);
+    } }
+{
+    resolveTimer.setSingleShot(true);
+    resolveTimer.setInterval(0);
+    connect(&resolveTimer, &QTimer::timeout, this, &PlaylistFilterModel::resolveQueuedTracks);
+}
+
+void PlaylistFilterModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
-    setDynamicSortFilter(true);
+    beginResetModel();
+
+    if(this->sourceModel())
+    {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+
+    engine.cancel();
+    pendingGeneration.reset();
+    pendingInsertion.reset();
+    resolveTimer.stop();
+    queuedRefinement.reset();
+    resolvedTracks = 0;
+    acceptedRows.clear();
+    visibleRows = 0;
+    filtered = false;
+
+    QAbstractProxyModel::setSourceModel(sourceModel);
+
+    playlistModel = qobject_cast<PlaylistModel *>(sourceModel);
+    playlist = playlistModel ? &playlistModel->getPlaylist() : nullptr;
+    onPlaylistChanged();
+
+    if(sourceModel)
+    {
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeInserted, this,
+            &PlaylistFilterModel::onSourceRowsAboutToBeInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted, this,
+            &PlaylistFilterModel::onSourceRowsInserted);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+            &PlaylistFilterModel::onSourceRowsAboutToBeRemoved);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved, this,
+            &PlaylistFilterModel::onSourceRowsRemoved);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeMoved, this,
+            &PlaylistFilterModel::onSourceRowsAboutToBeMoved);
+        connect(sourceModel, &QAbstractItemModel::rowsMoved, this,
+            &PlaylistFilterModel::onSourceRowsMoved);
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this,
+            &PlaylistFilterModel::onSourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::headerDataChanged, this,
+            &PlaylistFilterModel::headerDataChanged);
+        connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this,
+            &PlaylistFilterModel::onSourceLayoutAboutToBeChanged);
+        connect(sourceModel, &QAbstractItemModel::layoutChanged, this,
+            &PlaylistFilterModel::onSourceLayoutChanged);
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this,
+            &PlaylistFilterModel::onSourceModelAboutToBeReset);
+        connect(sourceModel, &QAbstractItemModel::modelReset, this,
+            &PlaylistFilterModel::onSourceModelReset);
+    }
+
+    endResetModel();
+
+    if(not query.isEmpty())
+    {
+        startFilter(false);
+    }
 }
 
 void PlaylistFilterModel::setFilterQuery(QString query)
 {
-    this->query = query;
-    invalidateFilter();
+    FilterQuery compiled{ query };
+
+    if(compiled.isEmpty())
+    {
+        engine.cancel();
+        pendingGeneration.reset();
+        pendingInsertion.reset();
+        resolveTimer.stop();
+        queuedRefinement.reset();
+        this->query = std::move(compiled);
+        setAcceptedRows(false, {});
+        return;
+    }
+
+    // Only complete results can be narrowed down
+    const auto refinement =
+        filtered and not isFiltering() and compiled.isRefinementOf(displayedQuery);
+
+    this->query = std::move(compiled);
+    startFilter(refinement);
+}
+
+QModelIndex PlaylistFilterModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if(not proxyIndex.isValid() or not sourceModel()) return {};
+
+    return sourceModel()->index(mapRowToSource(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex PlaylistFilterModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if(not sourceIndex.isValid()) return {};
+
+    if(not filtered)
+    {
+        return index(sourceIndex.row(), sourceIndex.column());
+    }
+
+    const auto it = std::lower_bound(acceptedRows.cbegin(), acceptedRows.cend(), sourceIndex.row());
+    if(it == acceptedRows.cend() or *it != sourceIndex.row())
+    {
+        return {};
+    }
+
+    return index(static_cast<int>(std::distance(acceptedRows.cbegin(), it)), sourceIndex.column());
+}
+
+QModelIndex PlaylistFilterModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if(parent.isValid() or row < 0 or column < 0 or row >= rowCount() or column >= columnCount())
+    {
+        return {};
+    }
+
+    return createIndex(row, column);
+}
+
+QModelIndex PlaylistFilterModel::parent(const QModelIndex &) const
+{
+    return {};
+}
+
+int PlaylistFilterModel::rowCount(const QModelIndex &parent) const
+{
+    if(parent.isValid() or not sourceModel()) return 0;
+
+    return filtered ? visibleRows : sourceModel()->rowCount();
+}
+
+int PlaylistFilterModel::columnCount(const QModelIndex &parent) const
+{
+    if(parent.isValid() or not sourceModel()) return 0;
+
+    return sourceModel()->columnCount();
+}
+
+bool PlaylistFilterModel::hasChildren(const QModelIndex &parent) const
+{
+    return rowCount(parent) > 0;
+}
+
+bool PlaylistFilterModel::canFetchMore(const QModelIndex &parent) const
+{
+    if(parent.isValid() or not sourceModel()) return false;
+
+    if(filtered and visibleRows == static_cast<int>(acceptedRows.size()))
+    {
+        return false;
+    }
+
+    return sourceModel()->canFetchMore({});
+}
+
+void PlaylistFilterModel::fetchMore(const QModelIndex &parent)
+{
+    if(parent.isValid() or not sourceModel()) return;
+
+    // Fetched source rows might not match, keep fetching until a match shows up
+    const auto previousRowCount = rowCount();
+    do
+    {
+        sourceModel()->fetchMore({});
+    } while(filtered and rowCount() == previousRowCount and canFetchMore({}));
+}
+
+bool PlaylistFilterModel::removeRows(int row, int count, const QModelIndex &parent)
+{
+    if(parent.isValid() or not sourceModel() or row < 0 or count <= 0 or row + count > rowCount())
+    {
+        return false;
+    }
+
+    if(not filtered)
+    {
+        return sourceModel()->removeRows(row, count);
+    }
+
+    // Consecutive proxy rows can be scattered in the source, remove runs from the end
+    const std::vector<int> sourceRows(acceptedRows.cbegin() + row, acceptedRows.cbegin() + row + count);
+
+    auto removed = true;
+    for(auto end = sourceRows.size(); end > 0;)
+    {
+        auto begin = end - 1;
+        while(begin > 0 and sourceRows[begin - 1] + 1 == sourceRows[begin])
+        {
+            --begin;
+        }
+
+        removed = sourceModel()->removeRows(sourceRows[begin], static_cast<int>(end - begin)) and removed;
+        end = begin;
+    }
+
+    return removed;
+}
+
+void PlaylistFilterModel::onFilterResults(PlaylistFilterEngine::Generation generation,
+    std::vector<std::size_t> matches,
+    bool finished)
+{
+    if(pendingInsertion and pendingInsertion->generation == generation)
+    {
+        insertAcceptedRows(pendingInsertion->first, matches);
+        if(finished) pendingInsertion.reset();
+        return;
+    }
+
+    if(pendingGeneration != generation) return;
+
+    if(not pendingResultsShown)
+    {
+        pendingResultsShown = true;
+        displayedQuery = query;
+        setAcceptedRows(true, std::vector<int>(matches.cbegin(), matches.cend()));
+    }
+    else
+    {
+        appendAcceptedRows(matches);
+    }
+
+    if(finished)
+    {
+        pendingGeneration.reset();
+    }
+}
+
+void PlaylistFilterModel::startFilter(bool refinement)
+{
+    if(not playlist) return;
+
+    // Inserted tracks are covered by the new results
+    pendingInsertion.reset();
+    pendingResultsShown = false;
+
+    if(resolvedTracks < playlist->getTrackCount())
+    {
+        // Displayed results stay until the query runs over the resolved playlist
+        engine.cancel();
+        pendingGeneration.reset();
+        queuedRefinement = refinement;
+        resolveTimer.start();
+        return;
+    }
+
+    queuedRefinement.reset();
+
+    if(refinement)
+    {
+        std::vector<std::size_t> candidates(acceptedRows.cbegin(), acceptedRows.cend());
+        pendingGeneration = engine.filter(getSnapshot(), query, std::move(candidates));
+    }
+    else
+    {
+        pendingGeneration = engine.filter(getSnapshot(), query);
+    }
+}
+
+bool PlaylistFilterModel::isFiltering() const
+{
+    return pendingGeneration or pendingInsertion or queuedRefinement;
+}
+
+void PlaylistFilterModel::resolveQueuedTracks()
+{
+    if(not playlistModel or not queuedRefinement) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto trackCount = playlist->getTrackCount();
+    while(resolvedTracks < trackCount and timer.nsecsElapsed() < resolveFrameBudgetNs)
+    {
+        const auto count = std::min(resolveBatchSize, trackCount - resolvedTracks);
+        playlistModel->resolveTracks(resolvedTracks, count);
+        resolvedTracks += count;
+    }
+
+    if(resolvedTracks < trackCount)
+    {
+        resolveTimer.start();
+        return;
+    }
+
+    startFilter(*queuedRefinement);
+}
+
+void PlaylistFilterModel::setAcceptedRows(bool filter, std::vector<int> rows)
+{
+    if(not filter and not filtered) return;
+
+    // Shown rows are changed with row removals and insertions so views keep their selection,
+    // accepted rows not fetched yet are not shown and are replaced silently
+    const auto fetchedRows = sourceModel()->rowCount();
+    if(filtered)
+    {
+        acceptedRows.resize(visibleRows);
+    }
+    else
+    {
+        acceptedRows.resize(fetchedRows);
+        std::iota(acceptedRows.begin(), acceptedRows.end(), 0);
+        visibleRows = fetchedRows;
+        filtered = true;
+    }
+
+    if(not filter)
+    {
+        rows.resize(fetchedRows);
+        std::iota(rows.begin(), rows.end(), 0);
+    }
+
+    const auto accepted = [&rows](int sourceRow)
+    { return std::binary_search(rows.cbegin(), rows.cend(), sourceRow); };
+
+    // Rows before a removed run keep their position, runs are removed from the end
+    for(auto end = visibleRows; end > 0; --end)
+    {
+        if(accepted(acceptedRows[end - 1])) continue;
+
+        auto begin = end - 1;
+        while(begin > 0 and not accepted(acceptedRows[begin - 1]))
+        {
+            --begin;
+        }
+
+        beginRemoveRows({}, begin, end - 1);
+        acceptedRows.erase(acceptedRows.cbegin() + begin, acceptedRows.cbegin() + end);
+        visibleRows -= end - begin;
+        endRemoveRows();
+
+        end = begin;
+    }
+
+    // Remaining rows are a subset of the new ones, missing fetched rows are inserted in runs
+    const auto shownEnd = std::lower_bound(rows.cbegin(), rows.cend(), fetchedRows);
+    auto proxyRow = 0;
+
+    for(auto it = rows.cbegin(); it != shownEnd;)
+    {
+        if(proxyRow < visibleRows and acceptedRows[proxyRow] == *it)
+        {
+            ++proxyRow;
+            ++it;
+            continue;
+        }
+
+        auto runEnd = std::next(it);
+        while(runEnd != shownEnd and (proxyRow == visibleRows or *runEnd != acceptedRows[proxyRow]))
+        {
+            ++runEnd;
+        }
+
+        const auto count = static_cast<int>(std::distance(it, runEnd));
+        beginInsertRows({}, proxyRow, proxyRow + count - 1);
+        acceptedRows.insert(acceptedRows.cbegin() + proxyRow, it, runEnd);
+        visibleRows += count;
+        endInsertRows();
+
+        proxyRow += count;
+        it = runEnd;
+    }
+
+    filtered = filter;
+    acceptedRows = filter ? std::move(rows) : std::vector<int>{};
+}
+
+void PlaylistFilterModel::appendAcceptedRows(const std::vector<std::size_t> &rows)
+{
+    acceptedRows.insert(acceptedRows.end(), rows.cbegin(), rows.cend());
+    showFetchedRows();
+}
+
+void PlaylistFilterModel::insertAcceptedRows(std::size_t first, const std::vector<std::size_t> &rows)
+{
+    if(rows.empty()) return;
+
+    // Matches are ascending and between accepted rows around the inserted tracks
+    const auto firstRow = static_cast<int>(first + rows.front());
+    const auto position = std::lower_bound(acceptedRows.cbegin(), acceptedRows.cend(), firstRow);
+    const auto proxyRow = static_cast<int>(std::distance(acceptedRows.cbegin(), position));
+
+    const auto fetchedRows = static_cast<std::size_t>(sourceModel()->rowCount());
+    const auto shownRows = static_cast<int>(std::distance(rows.cbegin(),
+        std::lower_bound(rows.cbegin(), rows.cend(), fetchedRows - std::min(first, fetchedRows))));
+
+    if(shownRows > 0)
+    {
+        beginInsertRows({}, proxyRow, proxyRow + shownRows - 1);
+    }
+
+    std::vector<int> sourceRows;
+    sourceRows.reserve(rows.size());
+    std::transform(rows.cbegin(), rows.cend(), std::back_inserter(sourceRows),
+        [first](std::size_t row) { return static_cast<int>(first + row); });
+
+    acceptedRows.insert(position, sourceRows.cbegin(), sourceRows.cend());
+    visibleRows += shownRows;
+
+    if(shownRows > 0)
+    {
+        endInsertRows();
+    }
+}
+
+void PlaylistFilterModel::remapMovedRows(const TrackRunMove &move)
+{
+    const auto first = static_cast<int>(move.first);
+    const auto count = static_cast<int>(move.count);
+    const auto end = first + count;
+    const auto destination = static_cast<int>(move.destination);
+
+    // Accepted rows keep their order except for the moved ones, which are rotated past the rows
+    // between them and the destination
+    const auto begin = std::lower_bound(acceptedRows.begin(), acceptedRows.end(), first);
+    const auto movedEnd = std::lower_bound(begin, acceptedRows.end(), end);
+
+    if(destination > first)
+    {
+        const auto stayedEnd = std::lower_bound(movedEnd, acceptedRows.end(), destination);
+        std::for_each(begin, movedEnd, [shift = destination - end](int &row) { row += shift; });
+        std::for_each(movedEnd, stayedEnd, [count](int &row) { row -= count; });
+        std::rotate(begin, movedEnd, stayedEnd);
+    }
+    else
+    {
+        const auto stayedBegin = std::lower_bound(acceptedRows.begin(), begin, destination);
+        std::for_each(stayedBegin, begin, [count](int &row) { row += count; });
+        std::for_each(begin, movedEnd, [shift = first - destination](int &row) { row -= shift; });
+        std::rotate(stayedBegin, begin, movedEnd);
+    }
+}
+
+void PlaylistFilterModel::showFetchedRows()
+{
+    const auto newVisibleRows = countVisibleRows();
+    if(newVisibleRows <= visibleRows) return;
+
+    beginInsertRows({}, visibleRows, newVisibleRows - 1);
+    visibleRows = newVisibleRows;
+    endInsertRows();
+}
+
+int PlaylistFilterModel::countVisibleRows() const
+{
+    if(not sourceModel()) return 0;
+
+    const auto fetchedRows = sourceModel()->rowCount();
+    const auto it = std::lower_bound(acceptedRows.cbegin(), acceptedRows.cend(), fetchedRows);
+    return static_cast<int>(std::distance(acceptedRows.cbegin(), it));
+}
+
+int PlaylistFilterModel::mapRowToSource(int proxyRow) const
+{
+    return filtered ? acceptedRows[proxyRow] : proxyRow;
+}
+
+std::pair<int, int> PlaylistFilterModel::mapRangeFromSource(int first, int last) const
+{
+    const auto begin = std::lower_bound(acceptedRows.cbegin(), acceptedRows.cend(), first);
+    const auto end = std::lower_bound(begin, acceptedRows.cend(), last + 1);
+
+    return { static_cast<int>(std::distance(acceptedRows.cbegin(), begin)),
+        std::min(visibleRows, static_cast<int>(std::distance(acceptedRows.cbegin(), end))) };
+}
+
+void PlaylistFilterModel::onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last)
+{
+    if(parent.isValid() or filtered) return;
+
+    beginInsertRows({}, first, last);
+}
+
+void PlaylistFilterModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if(parent.isValid()) return;
+
+    const auto fetched = playlist and playlist->getTrackCount() == knownTrackCount;
+
+    if(not fetched)
+    {
+        resolvedTracks = std::min(resolvedTracks, static_cast<std::size_t>(first));
+    }
+
+    if(filtered)
+    {
+        // Tracks inserted past the fetched rows were not reported, positions of accepted rows are unknown
+        const auto insertedOnly = playlist
+            and playlist->getTrackCount() == knownTrackCount + static_cast<std::size_t>(last - first + 1);
+
+        if(fetched)
+        {
+            showFetchedRows();
+        }
+        else if(insertedOnly)
+        {
+            filterInsertedRows(first, last);
+        }
+        else
+        {
+            beginRefilter();
+            endRefilter();
+        }
+
+        return;
+    }
+
+    endInsertRows();
+
+    if(not fetched)
+    {
+        onPlaylistChanged();
+        if(isFiltering()) startFilter(false);
+    }
+}
+
+void PlaylistFilterModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if(parent.isValid()) return;
+
+    if(not filtered)
+    {
+        beginRemoveRows({}, first, last);
+        removingRows = true;
+        return;
+    }
+
+    const auto [proxyFirst, proxyEnd] = mapRangeFromSource(first, last);
+    if(proxyFirst < proxyEnd)
+    {
+        beginRemoveRows({}, proxyFirst, proxyEnd - 1);
+        removingRows = true;
+    }
+}
+
+void PlaylistFilterModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if(parent.isValid()) return;
+
+    // Resolved tracks after the removed ones shift unless other tracks were removed unreported
+    const auto removedCount = static_cast<std::size_t>(last - first + 1);
+    const auto reported = playlist and playlist->getTrackCount() + removedCount == knownTrackCount;
+    const auto firstTrack = static_cast<std::size_t>(first);
+
+    if(reported and resolvedTracks > firstTrack)
+    {
+        resolvedTracks = std::max(firstTrack, resolvedTracks - std::min(resolvedTracks, removedCount));
+    }
+    else if(not reported)
+    {
+        resolvedTracks = std::min(resolvedTracks, firstTrack);
+    }
+
+    if(filtered)
+    {
+        // Remaining rows stay accepted, only their source positions shift
+        const auto begin = std::lower_bound(acceptedRows.begin(), acceptedRows.end(), first);
+        const auto end = std::lower_bound(begin, acceptedRows.end(), last + 1);
+        const auto count = last - first + 1;
+
+        std::for_each(end, acceptedRows.end(), [count](int &row) { row -= count; });
+        acceptedRows.erase(begin, end);
+        visibleRows = countVisibleRows();
+    }
+
+    if(removingRows)
+    {
+        removingRows = false;
+        endRemoveRows();
+    }
+
+    onPlaylistChanged();
+    if(isFiltering()) startFilter(false);
+}
+
+void PlaylistFilterModel::onSourceRowsAboutToBeMoved(const QModelIndex &sourceParent,
+    int first,
+    int last,
+    const QModelIndex &destinationParent,
+    int destinationRow)
+{
+    if(sourceParent.isValid() or destinationParent.isValid()) return;
+
+    resolvedTracks = std::min(resolvedTracks, static_cast<std::size_t>(std::min(first, destinationRow)));
+
+    if(filtered)
+    {
+        movedRows = TrackRunMove{ static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1),
+            static_cast<std::size_t>(destinationRow) };
+
+        // Accepted rows among the moved ones are consecutive in the proxy as well
+        const auto [proxyFirst, proxyEnd] = mapRangeFromSource(first, last);
+        const auto proxyDestination = static_cast<int>(std::distance(acceptedRows.cbegin(),
+            std::lower_bound(acceptedRows.cbegin(), acceptedRows.cend(), destinationRow)));
+
+        movingRows = proxyFirst < proxyEnd and beginMoveRows({}, proxyFirst, proxyEnd - 1, {}, proxyDestination);
+        return;
+    }
+
+    beginMoveRows({}, first, last, {}, destinationRow);
+}
+
+void PlaylistFilterModel::onSourceRowsMoved()
+{
+    if(filtered and movedRows)
+    {
+        remapMovedRows(*movedRows);
+        movedRows.reset();
+
+        if(movingRows)
+        {
+            movingRows = false;
+            endMoveRows();
+        }
+
+        onPlaylistChanged();
+        if(isFiltering()) startFilter(false);
+        return;
+    }
+
+    endMoveRows();
+    onPlaylistChanged();
+    if(isFiltering()) startFilter(false);
+}
+
+void PlaylistFilterModel::onSourceDataChanged(const QModelIndex &topLeft,
+    const QModelIndex &bottomRight,
+    const QList<int> &roles)
+{
+    // Only resolved rows are reported and the snapshot is taken of a resolved playlist,
+    // it stays valid
+    if(not filtered)
+    {
+        emit dataChanged(mapFromSource(topLeft), mapFromSource(bottomRight), roles);
+        return;
+    }
+
+    const auto [proxyFirst, proxyEnd] = mapRangeFromSource(topLeft.row(), bottomRight.row());
+    if(proxyFirst < proxyEnd)
+    {
+        emit dataChanged(index(proxyFirst, topLeft.column()), index(proxyEnd - 1, bottomRight.column()), roles);
+    }
+}
+
+void PlaylistFilterModel::onSourceLayoutAboutToBeChanged()
+{
+    resolvedTracks = 0;
+
+    if(filtered)
+    {
+        beginRefilter();
+        return;
+    }
+
+    emit layoutAboutToBeChanged();
+
+    layoutProxyIndexes = persistentIndexList();
+    for(const auto &proxyIndex : layoutProxyIndexes)
+    {
+        layoutSourceIndexes.push_back(mapToSource(proxyIndex));
+    }
+}
+
+void PlaylistFilterModel::onSourceLayoutChanged()
+{
+    if(filtered)
+    {
+        endRefilter();
+        return;
+    }
+
+    QModelIndexList newIndexes;
+    newIndexes.reserve(layoutSourceIndexes.size());
+
+    for(const auto &sourceIndex : layoutSourceIndexes)
+    {
+        newIndexes.push_back(mapFromSource(sourceIndex));
+    }
+
+    changePersistentIndexList(layoutProxyIndexes, newIndexes);
+    layoutProxyIndexes.clear();
+    layoutSourceIndexes.clear();
+
+    emit layoutChanged();
+
+    onPlaylistChanged();
+    if(isFiltering()) startFilter(false);
+}
+
+void PlaylistFilterModel::onSourceModelAboutToBeReset()
+{
+    resolvedTracks = 0;
+    beginResetModel();
+}
+
+void PlaylistFilterModel::onSourceModelReset()
+{
+    if(filtered)
+    {
+        endRefilter();
+        return;
+    }
+
+    onPlaylistChanged();
+    endResetModel();
+
+    if(isFiltering()) startFilter(false);
+}
+
+void PlaylistFilterModel::filterInsertedRows(int first, int last)
+{
+    const auto count = last - first + 1;
+
+    // Accepted rows after the inserted ones shift, visible ones stay visible as the source grew
+    const auto begin = std::lower_bound(acceptedRows.begin(), acceptedRows.end(), first);
+    std::for_each(begin, acceptedRows.end(), [count](int &row) { row += count; });
+
+    onPlaylistChanged();
+
+    // Streamed results are of the previous playlist, filtering it again covers the inserted tracks
+    if(isFiltering())
+    {
+        startFilter(false);
+        return;
+    }
+
+    const auto firstTrack = static_cast<std::size_t>(first);
+    const auto trackCount = static_cast<std::size_t>(count);
+    playlistModel->resolveTracks(firstTrack, trackCount);
+
+    if(resolvedTracks == firstTrack)
+    {
+        resolvedTracks += trackCount;
+    }
+
+    pendingInsertion = PendingInsertion{
+        engine.filter(PlaylistFilterEngine::createSnapshot(playlist->getTracks(), firstTrack, trackCount),
+            displayedQuery),
+        firstTrack
+    };
+}
+
+void PlaylistFilterModel::beginRefilter()
+{
+    beginResetModel();
+}
+
+void PlaylistFilterModel::endRefilter()
+{
+    acceptedRows.clear();
+    visibleRows = 0;
+    onPlaylistChanged();
+
+    endResetModel();
+
+    startFilter(false);
+}
+
+void PlaylistFilterModel::onPlaylistChanged()
+{
+    snapshot.reset();
+    knownTrackCount = playlist ? playlist->getTrackCount() : 0;
 }
 
-bool PlaylistFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &) const
+std::shared_ptr<const PlaylistFilterSnapshot> PlaylistFilterModel::getSnapshot()
 {
-    if(query.isEmpty()) return true;
+    // Tracks are resolved before, see resolveQueuedTracks
+    if(not snapshot)
+    {
+        snapshot = PlaylistFilterEngine::createSnapshot(playlist->getTracks());
+    }
 
-    const auto playlistModel = qobject_cast<PlaylistModel *>(sourceModel());
-    return playlistModel->getPlaylist().matchesFilterQuery(sourceRow, query);
+    return snapshot;
 }
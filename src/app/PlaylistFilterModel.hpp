@@ -1,19 +1,130 @@
 #pragma once
 
-#include <QSortFilterProxyModel>
+#include "FilterQuery.hpp"
+#include "PlaylistFilterEngine.hpp"
+#include "TrackIndexMapping.hpp"
 
-class PlaylistFilterModel final : public QSortFilterProxyModel
+#include <QAbstractProxyModel>
+#include <QTimer>
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+class Playlist;
+class PlaylistModel;
+
+// Shows rows of a PlaylistModel matching the search query.
+// Queries are evaluated by PlaylistFilterEngine off the GUI thread, previous results
+// stay visible until the first chunk of new ones arrives. Lazily loaded tracks are resolved
+// through the source model in batches between events before the first query runs over them.
+// Inserted, removed and moved source rows update the accepted rows in place,
+// only inserted tracks are filtered again.
+class PlaylistFilterModel final : public QAbstractProxyModel
 {
     Q_OBJECT
 
 public:
     explicit PlaylistFilterModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
     void setFilterQuery(QString query);
 
-protected:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &) const override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+private:
+    void onFilterResults(PlaylistFilterEngine::Generation, std::vector<std::size_t> matches, bool finished);
+
+    void startFilter(bool refinement);
+    bool isFiltering() const;
+    void resolveQueuedTracks();
+    void setAcceptedRows(bool filter, std::vector<int> rows);
+    void appendAcceptedRows(const std::vector<std::size_t> &rows);
+    void insertAcceptedRows(std::size_t first, const std::vector<std::size_t> &rows);
+    void remapMovedRows(const TrackRunMove &);
+    void showFetchedRows();
+    int countVisibleRows() const;
+    int mapRowToSource(int proxyRow) const;
+    std::pair<int, int> mapRangeFromSource(int first, int last) const;
+
+    void onSourceRowsAboutToBeInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsAboutToBeMoved(const QModelIndex &sourceParent,
+        int first,
+        int last,
+        const QModelIndex &destinationParent,
+        int destinationRow);
+    void onSourceRowsMoved();
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onSourceLayoutAboutToBeChanged();
+    void onSourceLayoutChanged();
+    void onSourceModelAboutToBeReset();
+    void onSourceModelReset();
+
+    // Filters the tracks inserted into the playlist with the displayed query
+    void filterInsertedRows(int first, int last);
+
+    // Filtered rows cannot follow arbitrary source changes, results are computed again
+    void beginRefilter();
+    void endRefilter();
+
+    void onPlaylistChanged();
+    std::shared_ptr<const PlaylistFilterSnapshot> getSnapshot();
 
 private:
-    QString query;
+    PlaylistModel *playlistModel{ nullptr };
+    const Playlist *playlist{ nullptr };
+    PlaylistFilterEngine engine;
+
+    // Tracks before the cursor are resolved. Queries wait for the rest, the queued one
+    // is kept as whether it refines the displayed results.
+    QTimer resolveTimer;
+    std::size_t resolvedTracks{ 0 };
+    std::optional<bool> queuedRefinement;
+
+    FilterQuery query;
+    FilterQuery displayedQuery;
+    std::optional<PlaylistFilterEngine::Generation> pendingGeneration;
+    bool pendingResultsShown{ false };
+
+    // Tracks inserted into a filtered playlist are filtered on their own, matches are relative to
+    // the first one. Further changes of the playlist before they finish filter it all again.
+    struct PendingInsertion
+    {
+        PlaylistFilterEngine::Generation generation;
+        std::size_t first;
+    };
+    std::optional<PendingInsertion> pendingInsertion;
+
+    // Source rows accepted by the displayed query over the whole playlist, ascending.
+    // Rows not fetched by the source model yet are kept but not shown.
+    std::vector<int> acceptedRows;
+    int visibleRows{ 0 };
+    bool filtered{ false };
+
+    // Snapshot is shared by queries until the playlist changes,
+    // rows appended by fetchMore keep the track count intact
+    std::shared_ptr<const PlaylistFilterSnapshot> snapshot;
+    std::size_t knownTrackCount{ 0 };
+
+    bool removingRows{ false };
+    std::optional<TrackRunMove> movedRows;
+    bool movingRows{ false };
+    QModelIndexList layoutProxyIndexes;
+    QList<QPersistentModelIndex> layoutSourceIndexes;
 };
@@ -6,4 +6,18 @@ PlaylistHeader::PlaylistHeader(PlaylistWidget *playlistWidget)
 : QHeaderView{ Qt::Horizontal, playlistWidget }
 {
     setSectionsMovable(true);
+
+    // Clicking a section sorts the playlist itself, clicking it again reverses the order
+    setSectionsClickable(true);
+    setSortIndicator(-1, Qt::AscendingOrder);
+    setSortIndicatorShown(true);
+
+    connect(this, &QHeaderView::sortIndicatorChanged, this,
+        [this](int section, Qt::SortOrder order)
+        {
+            if(model() and section >= 0)
+            {
+                model()->sort(section, order);
+            }
+        });
 }
@@ -1,12 +1,17 @@
 #include "PlaylistModel.hpp"
 
+#include "AutoPlaylistUpdater.hpp"
 #include "Playlist.hpp"
+#include "PlaylistTracksMimeData.hpp"
 
 #include <QDataStream>
-#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QLatin1String>
 #include <QMimeData>
+#include <QStringView>
 #include <QUrl>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <vector>
@@ -22,32 +27,180 @@ constexpr std::array<const char *, 5> labels = {
     "Duration",
 };
 
-constexpr auto playlistIndexesMimeType{ "application/playlist.indexes" };
+// Most significant key first, only the first one follows the requested order
+std::vector<PlaylistSortCriterion> getSortCriteria(int column, Qt::SortOrder order)
+{
+    switch(column)
+    {
+    case PlaylistColumn::NOW_PLAYING:
+        return { { PlaylistSortKey::Path, order } };
+
+    case PlaylistColumn::ARTIST_ALBUM:
+        return { { PlaylistSortKey::Artist, order }, { PlaylistSortKey::Album },
+            { PlaylistSortKey::TrackNumber }, { PlaylistSortKey::Title } };
+
+    case PlaylistColumn::TRACK:
+        return { { PlaylistSortKey::TrackNumber, order }, { PlaylistSortKey::Title } };
+
+    case PlaylistColumn::TITLE:
+        return { { PlaylistSortKey::Title, order }, { PlaylistSortKey::Artist } };
+
+    case PlaylistColumn::DURATION:
+        return { { PlaylistSortKey::Duration, order } };
+    }
+
+    return {};
+}
+
+// Rows around the displayed ones resolved in the same batch, so that scrolling finds them ready
+constexpr int resolvePrefetchRows{ 128 };
+
+// Rows are fetched in batches so that views lay out large playlists progressively
+constexpr std::size_t minimumFetchBatchSize{ 50 };
+constexpr std::size_t maximumFetchBatchSize{ 64 * 1024 };
+
+// Part of a 60 Hz frame that notifying views about fetched rows may take
+constexpr qint64 fetchFrameBudgetNs{ 8'000'000 };
+
+// Tracks resolved at once before sorting, the batches go on while they fit the frame budget
+constexpr std::size_t sortResolveBatchSize{ 256 };
+constexpr qint64 sortFrameBudgetNs{ 8'000'000 };
+
+// Scrolling keeps going for a while, rows it reaches in these frames are fetched ahead
+constexpr int fetchFramesAhead{ 4 };
+
+// Power of two above the number of rows of any viewport plus rows scrolled within a frame
+constexpr std::size_t displayStringsCacheSize{ 512 };
+
+// Appends decimal digits of the number, left padded with zeros, without temporary strings
+void appendNumber(QString &text, long long number, int width = 1)
+{
+    if(number < 0)
+    {
+        text.append(QChar{ '-' });
+        number = -number;
+    }
+
+    std::array<char16_t, 20> digits{};
+    int count{ 0 };
+    do
+    {
+        digits[count++] = static_cast<char16_t>(u'0' + number % 10);
+        number /= 10;
+    } while(number > 0 and count < static_cast<int>(digits.size()));
+
+    for(int padding = count; padding < width; ++padding)
+    {
+        text.append(QChar{ '0' });
+    }
+
+    while(count > 0)
+    {
+        text.append(QChar{ digits[--count] });
+    }
+}
+
+// File name without the last suffix, as QFileInfo::completeBaseName
+void appendBaseName(QString &text, const QString &fileName)
+{
+    const auto suffix = fileName.lastIndexOf('.');
+    text.append(suffix < 0 ? QStringView{ fileName } : QStringView{ fileName }.left(suffix));
+}
+
+// Buffers of reused cache entries are overwritten in place
+void formatArtistAlbum(QString &text, const MetaDataHandle &metaData)
+{
+    text.resize(0);
+
+    const auto append = [&text](const QString &value)
+    {
+        if(value.isEmpty())
+        {
+            text.append(QChar{ '?' });
+        }
+        else
+        {
+            text.append(value);
+        }
+    };
 
-std::vector<std::size_t> decodePlaylistIndexesMimeData(const QMimeData &mimeData)
+    if(not metaData)
+    {
+        text.append(QLatin1String{ "? - ?" });
+        return;
+    }
+
+    append(metaData->artist);
+    text.append(QLatin1String{ " - " });
+    append(metaData->albumName);
+}
+
+void formatTrack(QString &text, const MetaDataHandle &metaData)
 {
-    QByteArray encodedData = mimeData.data(playlistIndexesMimeType);
-    QDataStream stream(&encodedData, QIODevice::ReadOnly);
+    text.resize(0);
 
-    std::vector<std::size_t> indexes;
-    while(!stream.atEnd())
+    constexpr int missingData{ -1 };
+    if(not metaData or missingData == metaData->trackNumber)
     {
-        int row{ -1 };
-        stream >> row;
-        indexes.emplace_back(static_cast<std::size_t>(row));
+        return;
     }
 
-    // Remove duplicated rows, QModelIndexList contains indexes for all columns
-    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    if(missingData != metaData->discNumber)
+    {
+        appendNumber(text, metaData->discNumber);
+        text.append(QChar{ '.' });
+    }
+
+    appendNumber(text, metaData->trackNumber, 2);
+}
+
+void formatTitle(QString &text, const TrackPath &filepath, const MetaDataHandle &metaData)
+{
+    if(metaData and not metaData->title.isEmpty())
+    {
+        // Shares the data of the record
+        text = metaData->title;
+        return;
+    }
+
+    text.resize(0);
+    appendBaseName(text, filepath.getFileName());
+}
+
+void formatDuration(QString &text, const MetaDataHandle &metaData)
+{
+    text.resize(0);
+
+    if(not metaData)
+    {
+        return;
+    }
+
+    const auto duration = metaData->duration.count();
+    appendNumber(text, duration / 60);
+    text.append(QChar{ ':' });
+    appendNumber(text, duration % 60, 2);
+}
 
-    return indexes;
+QVariant toVariant(const QString &text)
+{
+    return text.isEmpty() ? QVariant{} : QVariant{ text };
 }
 } // namespace
 
 PlaylistModel::PlaylistModel(Playlist &playlist, QObject *parent)
 : QAbstractListModel{ parent }
 , playlist_{ playlist }
+, fetchBatchSize_{ minimumFetchBatchSize }
+, displayStrings_(displayStringsCacheSize)
 {
+    resolveTimer_.setSingleShot(true);
+    resolveTimer_.setInterval(0);
+    connect(&resolveTimer_, &QTimer::timeout, this, &PlaylistModel::resolvePendingRows);
+
+    sortTimer_.setSingleShot(true);
+    sortTimer_.setInterval(0);
+    connect(&sortTimer_, &QTimer::timeout, this, &PlaylistModel::resolveSortedTracks);
 }
 
 int PlaylistModel::rowCount(const QModelIndex &) const
@@ -96,33 +249,39 @@ QVariant PlaylistModel::data(const QModelIndex &index, int role) const
     if(Qt::DisplayRole == role)
     {
         const auto *track = playlist_.getTrack(row);
-        const auto &metaData = track->audioMetaData;
 
-        switch(col)
+        if(const auto *record = track->audioMetaData.getRecord(); record and not record->isResolved)
         {
-        case PlaylistColumn::NOW_PLAYING:
+            requestResolve(row);
+        }
+
+        if(PlaylistColumn::NOW_PLAYING == col)
         {
-            return row == currentTrackIndex ? QString{ '>' } : "";
+            return row == currentTrackIndex ? QStringLiteral(">") : QString{};
         }
 
+        const auto &strings = getDisplayStrings(row, *track);
+
+        switch(col)
+        {
         case PlaylistColumn::TITLE:
         {
-            return dataTitle(track->path, metaData);
+            return strings.title;
         }
 
         case PlaylistColumn::ARTIST_ALBUM:
         {
-            return dataArtistAlbum(metaData);
+            return strings.artistAlbum;
         }
 
         case PlaylistColumn::TRACK:
         {
-            return dataTrack(metaData);
+            return toVariant(strings.track);
         }
 
         case PlaylistColumn::DURATION:
         {
-            return dataDuration(metaData);
+            return toVariant(strings.duration);
         }
         }
 
@@ -147,67 +306,232 @@ void PlaylistModel::fetchMore(const QModelIndex &parent)
 {
     if(parent.isValid()) return;
 
-    const qint64 remainder = playlist_.getTrackCount() - fetched_;
-    const qint64 fetchCount = std::min<qint64>(50, remainder);
+    fetchRows(std::max(fetchBatchSize_, fetchMinimum_));
+}
 
-    if(fetchCount <= 0) return;
+void PlaylistModel::setFetchHint(int visibleRows, int scrolledRowsPerFrame)
+{
+    const auto rows = std::max(0, visibleRows) + fetchFramesAhead * std::max(0, scrolledRowsPerFrame);
+    fetchMinimum_ = std::min(static_cast<std::size_t>(rows), maximumFetchBatchSize);
+}
+
+void PlaylistModel::fetchUpTo(int row)
+{
+    if(row < 0) return;
+
+    const auto count = static_cast<std::size_t>(row) + 1;
+    if(count > fetched_)
+    {
+        fetchRows(count - fetched_);
+    }
+}
 
-    beginInsertRows(QModelIndex(), fetched_, fetched_ + fetchCount - 1);
+void PlaylistModel::fetchRows(std::size_t count)
+{
+    const auto trackCount = playlist_.getTrackCount();
+    if(fetched_ >= trackCount) return;
+
+    const auto fetchCount = std::min(count, trackCount - fetched_);
+    if(fetchCount == 0) return;
+
+    updateWidestStrings(fetched_, fetchCount);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    beginInsertRows(QModelIndex(), static_cast<int>(fetched_), static_cast<int>(fetched_ + fetchCount - 1));
     fetched_ += fetchCount;
     endInsertRows();
+
+    // Consecutive fetches grow the batch while views handle it quickly,
+    // so that scrolling through a huge playlist takes few rounds of relayout
+    const auto elapsed = timer.nsecsElapsed();
+    if(elapsed * 2 < fetchFrameBudgetNs and fetchCount >= fetchBatchSize_)
+    {
+        fetchBatchSize_ = std::min(fetchBatchSize_ * 2, maximumFetchBatchSize);
+    }
+    else if(elapsed > fetchFrameBudgetNs)
+    {
+        fetchBatchSize_ = std::max(fetchBatchSize_ / 2, minimumFetchBatchSize);
+    }
 }
 
 bool PlaylistModel::removeRows(int first, int count, const QModelIndex &parent)
 {
+    if(isReadOnly() or parent.isValid() or first < 0 or count <= 0 or first + count > rowCount())
+    {
+        return false;
+    }
+
     beginRemoveRows(parent, first, first + count - 1);
 
     playlist_.removeTracks(first, count);
     fetched_ -= count;
+    invalidateDisplayStrings(first);
 
     endRemoveRows();
 
     return true;
 }
 
+void PlaylistModel::sort(int column, Qt::SortOrder order)
+{
+    if(getSortCriteria(column, order).empty() or isReadOnly())
+    {
+        return;
+    }
+
+    // Tracks resolved for a previous request stay resolved
+    sortColumn_ = column;
+    sortOrder_ = order;
+    resolveSortedTracks();
+}
+
+void PlaylistModel::resolveSortedTracks()
+{
+    if(not sortColumn_) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Resolving through the model reports the widest strings of the tracks
+    const auto trackCount = playlist_.getTrackCount();
+    while(sortResolvedTracks_ < trackCount and timer.nsecsElapsed() < sortFrameBudgetNs)
+    {
+        const auto count = std::min(sortResolveBatchSize, trackCount - sortResolvedTracks_);
+        resolveTracks(sortResolvedTracks_, count);
+        sortResolvedTracks_ += count;
+    }
+
+    if(sortResolvedTracks_ < trackCount)
+    {
+        sortTimer_.start();
+        return;
+    }
+
+    // Tracks shifted by changes in the meantime are looked up by the playlist, see sortTracks
+    const auto criteria = getSortCriteria(*sortColumn_, sortOrder_);
+    sortColumn_.reset();
+    sortResolvedTracks_ = 0;
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    applyTrackIndexMapping(playlist_.sortTracks(criteria));
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
 Qt::ItemFlags PlaylistModel::flags(const QModelIndex &index) const
 {
+    const Qt::ItemFlags dropEnabled = isReadOnly() ? Qt::NoItemFlags : Qt::ItemIsDropEnabled;
+
     if(index.isValid())
     {
-        return Qt::ItemIsSelectable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled | Qt::ItemIsEnabled;
+        return Qt::ItemIsSelectable | Qt::ItemIsDragEnabled | dropEnabled | Qt::ItemIsEnabled;
     }
     else
     {
-        return Qt::ItemIsDropEnabled | Qt::ItemIsEnabled;
+        return dropEnabled | Qt::ItemIsEnabled;
     }
 }
 
+Qt::DropActions PlaylistModel::supportedDragActions() const
+{
+    // Tracks of an auto playlist can only be copied out of it
+    return isReadOnly() ? Qt::CopyAction : Qt::CopyAction | Qt::MoveAction;
+}
+
 Qt::DropActions PlaylistModel::supportedDropActions() const
 {
     return Qt::CopyAction | Qt::MoveAction;
 }
 
-QMimeData *PlaylistModel::mimeData(const QModelIndexList &indexes) const
+const QString &PlaylistModel::getWidestString(int column) const
 {
-    auto mimeData = std::make_unique<QMimeData>();
+    static const QString none;
+
+    switch(column)
+    {
+    case PlaylistColumn::TRACK: return widestTrack_;
+    case PlaylistColumn::DURATION: return widestDuration_;
+    }
+
+    return none;
+}
+
+void PlaylistModel::updateWidestStrings(std::size_t first, std::size_t count)
+{
+    const auto &tracks = playlist_.getTracks();
+    const auto last = std::min(first + std::min(count, tracks.size()), tracks.size());
+
+    // Only lengths are compared, digits are equally wide in the fonts used for these columns
+    QString text;
+    bool trackChanged{ false };
+    bool durationChanged{ false };
+
+    for(auto index = first; index < last; ++index)
+    {
+        const auto &metaData = tracks[index].audioMetaData;
+        if(not metaData)
+        {
+            continue;
+        }
+
+        formatTrack(text, metaData);
+        if(text.size() > widestTrack_.size())
+        {
+            widestTrack_ = text;
+            trackChanged = true;
+        }
+
+        formatDuration(text, metaData);
+        if(text.size() > widestDuration_.size())
+        {
+            widestDuration_ = text;
+            durationChanged = true;
+        }
+    }
+
+    if(trackChanged)
+    {
+        emit widestStringChanged(PlaylistColumn::TRACK);
+    }
+
+    if(durationChanged)
+    {
+        emit widestStringChanged(PlaylistColumn::DURATION);
+    }
+}
 
-    QByteArray encodedData;
-    QDataStream stream(&encodedData, QIODevice::WriteOnly);
+QMimeData *PlaylistModel::mimeData(const QModelIndexList &indexes) const
+{
+    std::vector<TrackRange> rows;
+    rows.reserve(indexes.size());
 
     for(const auto &index : indexes)
     {
         if(index.isValid())
         {
-            stream << index.row();
+            rows.push_back(TrackRange{ static_cast<std::size_t>(index.row()), 1 });
         }
     }
 
-    mimeData->setData(playlistIndexesMimeType, encodedData);
+    return createMimeData(std::move(rows));
+}
+
+QMimeData *PlaylistModel::createMimeData(std::vector<TrackRange> rows) const
+{
+    return new PlaylistTracksMimeData{ *this, std::move(rows) };
+}
+
+QMimeData *PlaylistModel::createClipboardData(std::vector<TrackRange> rows) const
+{
+    auto mimeData = std::make_unique<PlaylistTracksMimeData>(*this, std::move(rows));
+    mimeData->takeSnapshot();
     return mimeData.release();
 }
 
 bool PlaylistModel::canDropMimeData(const QMimeData *mimeData, Qt::DropAction, int, int, const QModelIndex &) const
 {
-    return mimeData->hasUrls() or mimeData->hasFormat(playlistIndexesMimeType);
+    return not isReadOnly() and (mimeData->hasUrls() or mimeData->hasFormat(PlaylistTracksMimeData::mimeType));
 }
 
 bool PlaylistModel::dropMimeData(const QMimeData *mimeData, Qt::DropAction action, int row, int, const QModelIndex &parent)
@@ -217,41 +541,39 @@ bool PlaylistModel::dropMimeData(const QMimeData *mimeData, Qt::DropAction actio
         return true;
     }
 
-    int beginRow{ 0 };
-    if(row != -1)
+    if(isReadOnly())
+    {
+        return false;
+    }
+
+    // Tracks past the fetched rows are not shown, dropping after the last row appends to the playlist
+    int beginRow{ static_cast<int>(playlist_.getTrackCount()) };
+    if(row != -1 and row < rowCount(QModelIndex()))
     {
         beginRow = row;
     }
-    else if(parent.isValid())
+    else if(row == -1 and parent.isValid())
     {
         beginRow = parent.row();
     }
-    else
+
+    const auto rows = PlaylistTracksMimeData::decodeRows(*mimeData);
+    const auto *tracksMimeData = qobject_cast<const PlaylistTracksMimeData *>(mimeData);
+
+    if(rows and rows->playlistId == playlist_.getPlaylistId() and Qt::MoveAction == action)
     {
-        beginRow = rowCount(QModelIndex());
+        moveTrackRanges(rows->ranges, beginRow);
     }
-
-    if(mimeData->hasUrls())
+    else if(tracksMimeData)
     {
-        // Cannot beginInsert because the amount of elements added is unknown
-        // due to URLs sometimes being directories
-        beginResetModel();
-
-        const auto &filepaths = mimeData->urls();
-        playlist_.insertTracks(beginRow, std::vector<QUrl>{ filepaths.cbegin(), filepaths.cend() });
-
-        endResetModel();
+        // Tracks of another playlist or copies, their metadata is already known
+        onTracksInserted(playlist_.insertTracks(beginRow, tracksMimeData->getTracks()));
     }
-    else if(mimeData->hasFormat(playlistIndexesMimeType))
+    else if(mimeData->hasUrls())
     {
-        // beginMoveRows could be used here but it would require split into
-        // consecutive index views
-        beginResetModel();
-
-        auto itemsToMove = decodePlaylistIndexesMimeData(*mimeData);
-        playlist_.moveTracks(std::move(itemsToMove), beginRow);
-
-        endResetModel();
+        const auto &filepaths = mimeData->urls();
+        const std::vector<QUrl> urls{ filepaths.cbegin(), filepaths.cend() };
+        onTracksInserted(playlist_.insertTracks(beginRow, urls));
     }
     else
     {
@@ -262,91 +584,240 @@ bool PlaylistModel::dropMimeData(const QMimeData *mimeData, Qt::DropAction actio
     return true;
 }
 
-QVariant PlaylistModel::roleAlignment(int column) const
+void PlaylistModel::moveTrackRanges(const std::vector<TrackRange> &ranges, int beginRow)
 {
-    switch(column)
+    if(ranges.empty())
     {
-    case PlaylistColumn::NOW_PLAYING:
-        return Qt::AlignCenter;
+        return;
+    }
 
-    case PlaylistColumn::TRACK:
-    case PlaylistColumn::DURATION:
-        return Qt::Alignment{ Qt::AlignRight | Qt::AlignVCenter }.toInt();
+    const auto &lastRange = ranges.back();
+    const auto withinFetched = static_cast<std::size_t>(beginRow) <= fetched_ and
+        lastRange.first + lastRange.count <= fetched_;
+
+    std::vector<std::size_t> itemsToMove;
+    for(const auto &range : ranges)
+    {
+        const auto end = std::min(range.first + range.count, playlist_.getTrackCount());
+        for(auto row = range.first; row < end; ++row)
+        {
+            itemsToMove.push_back(row);
+        }
     }
 
-    return Qt::Alignment{ Qt::AlignLeft | Qt::AlignVCenter }.toInt();
+    if(withinFetched)
+    {
+        onTracksMoved(playlist_.moveTracks(std::move(itemsToMove), beginRow));
+    }
+    else
+    {
+        // Rows not fetched yet cannot be moved, the reorder is reported as a layout change
+        emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+        applyTrackIndexMapping(playlist_.moveTracks(std::move(itemsToMove), beginRow).mapping);
+        emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+    }
 }
 
-QVariant PlaylistModel::dataTitle(const QString &filepath, const std::optional<AudioMetaData> &metaData) const
+void PlaylistModel::applyTrackIndexMapping(const TrackIndexMapping &mapping)
 {
-    if(metaData and not metaData->title.isEmpty())
+    if(not mapping.newIndexes.empty())
     {
-        return metaData->title;
+        const auto first = static_cast<int>(mapping.first);
+        invalidateDisplayStrings(first, first + static_cast<int>(mapping.newIndexes.size()) - 1);
     }
 
-    return QFileInfo(filepath).completeBaseName();
+    // Persistent indexes are remapped so that selection and current index follow the tracks
+    const auto oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+
+    for(const auto &oldIndex : oldIndexes)
+    {
+        newIndexes.push_back(index(static_cast<int>(mapping.map(oldIndex.row())), oldIndex.column()));
+    }
+
+    changePersistentIndexList(oldIndexes, newIndexes);
 }
 
-QVariant PlaylistModel::dataArtistAlbum(const std::optional<AudioMetaData> &metaData) const
+void PlaylistModel::onTracksInserted(const TrackRange &inserted)
 {
-    if(not metaData)
+    if(inserted.count == 0)
+    {
+        return;
+    }
+
+    invalidateDisplayStrings(static_cast<int>(inserted.first));
+    updateWidestStrings(inserted.first, inserted.count);
+
+    // Tracks inserted past the fetched rows are fetched later
+    if(inserted.first > fetched_)
     {
-        return "? - ?";
+        return;
     }
 
-    const QString artist{ metaData->artist.isEmpty() ? "?" : metaData->artist };
-    const QString album{ metaData->albumName.isEmpty() ? "?" : metaData->albumName };
-    return artist + " - " + album;
+    const auto first = static_cast<int>(inserted.first);
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(inserted.count) - 1);
+    fetched_ += inserted.count;
+    endInsertRows();
 }
 
-QVariant PlaylistModel::dataDuration(const std::optional<AudioMetaData> &metaData) const
+void PlaylistModel::onTracksMoved(const TrackMoves &moves)
 {
-    if(not metaData)
+    if(moves.mapping.newIndexes.empty())
     {
-        return {};
+        return;
     }
 
-    const auto duration = metaData->duration.count();
-    const auto minutes = duration / 60;
-    const auto seconds = duration % 60;
-    return QString{ "%1:%2" }.arg(minutes).arg(seconds, 2, 10, QChar('0'));
+    const auto first = static_cast<int>(moves.mapping.first);
+    invalidateDisplayStrings(first, first + static_cast<int>(moves.mapping.newIndexes.size()) - 1);
+
+    // Each run is reported in positions left by the previous ones, as the playlist reported them
+    for(const auto &run : moves.runs)
+    {
+        const auto runFirst = static_cast<int>(run.first);
+        const auto runLast = runFirst + static_cast<int>(run.count) - 1;
+        if(beginMoveRows(QModelIndex(), runFirst, runLast, QModelIndex(), static_cast<int>(run.destination)))
+        {
+            endMoveRows();
+        }
+    }
 }
 
-QVariant PlaylistModel::dataTrack(const std::optional<AudioMetaData> &metaData) const
+void PlaylistModel::onTracksRemoved(const std::vector<TrackRange> &removed)
 {
-    if(not metaData)
+    if(removed.empty())
     {
-        return {};
+        return;
     }
 
-    constexpr int missingData{ -1 };
-    if(missingData != metaData->trackNumber)
-    {
-        const auto track = QString{ "%1" }.arg(metaData->trackNumber, 2, 10, QChar('0'));
+    invalidateDisplayStrings(static_cast<int>(removed.front().first));
 
-        if(missingData != metaData->discNumber)
+    // From the last range, positions of the preceding ones stay valid
+    for(auto range = removed.crbegin(); range != removed.crend(); ++range)
+    {
+        if(range->first >= fetched_)
         {
-            return QString{ "%1.%2" }.arg(metaData->discNumber).arg(track);
+            continue;
         }
 
-        return track;
+        const auto count = std::min(range->count, fetched_ - range->first);
+        const auto first = static_cast<int>(range->first);
+
+        beginRemoveRows(QModelIndex(), first, first + static_cast<int>(count) - 1);
+        fetched_ -= count;
+        endRemoveRows();
     }
+}
 
-    return {};
+void PlaylistModel::requestResolve(int row) const
+{
+    if(not resolveTimer_.isActive())
+    {
+        resolveFirst_ = row;
+        resolveLast_ = row;
+        resolveTimer_.start();
+        return;
+    }
+
+    resolveFirst_ = std::min(resolveFirst_, row);
+    resolveLast_ = std::max(resolveLast_, row);
+}
+
+void PlaylistModel::resolvePendingRows()
+{
+    const auto first = std::max(0, resolveFirst_ - resolvePrefetchRows);
+    const auto last = resolveLast_ + resolvePrefetchRows;
+
+    resolveTracks(static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1));
+}
+
+bool PlaylistModel::resolveTracks(std::size_t first, std::size_t count)
+{
+    if(not playlist_.resolveTracks(first, count))
+    {
+        return false;
+    }
+
+    updateWidestStrings(first, count);
+
+    // Tracks may be not fetched yet
+    const auto fetchedRows = static_cast<std::size_t>(rowCount());
+    if(first < fetchedRows and count > 0)
+    {
+        const auto last = first + std::min(count, fetchedRows - first) - 1;
+        emit dataChanged(index(static_cast<int>(first), 0), index(static_cast<int>(last), columnCount() - 1));
+    }
+
+    return true;
+}
+
+bool PlaylistModel::isReadOnly() const
+{
+    return playlist_.getAutoQuery().has_value();
+}
+
+QVariant PlaylistModel::roleAlignment(int column) const
+{
+    switch(column)
+    {
+    case PlaylistColumn::NOW_PLAYING:
+        return Qt::AlignCenter;
+
+    case PlaylistColumn::TRACK:
+    case PlaylistColumn::DURATION:
+        return Qt::Alignment{ Qt::AlignRight | Qt::AlignVCenter }.toInt();
+    }
+
+    return Qt::Alignment{ Qt::AlignLeft | Qt::AlignVCenter }.toInt();
+}
+
+const PlaylistModel::DisplayStrings &PlaylistModel::getDisplayStrings(int row, const PlaylistTrack &track) const
+{
+    const auto &metaData = track.audioMetaData;
+    const auto *record = metaData.getRecord();
+    const auto revision = record ? record->revision : std::uint32_t{ 0 };
+
+    auto &strings = displayStrings_[static_cast<std::size_t>(row) % displayStrings_.size()];
+
+    // Record identity catches tracks replaced without the model knowing
+    if(strings.row == row and strings.record == record and strings.revision == revision)
+    {
+        return strings;
+    }
+
+    strings.row = row;
+    strings.record = record;
+    strings.revision = revision;
+
+    formatArtistAlbum(strings.artistAlbum, metaData);
+    formatTrack(strings.track, metaData);
+    formatTitle(strings.title, track.path, metaData);
+    formatDuration(strings.duration, metaData);
+
+    return strings;
+}
+
+void PlaylistModel::invalidateDisplayStrings(int first, int last)
+{
+    for(auto &strings : displayStrings_)
+    {
+        if(strings.row >= first and strings.row <= last)
+        {
+            strings.row = -1;
+        }
+    }
 }
 
 void PlaylistModel::onDuplicateRemoveRequest()
 {
-    beginResetModel();
-    playlist_.removeDuplicates();
-    endResetModel();
+    if(isReadOnly()) return;
+
+    onTracksRemoved(playlist_.removeDuplicates());
 }
 
 void PlaylistModel::onInsertRequest(QStringList filenames)
 {
-    // Cannot beginInsert because the amount of elements added is unknown
-    // due to URLs sometimes being directories
-    beginResetModel();
+    if(isReadOnly()) return;
 
     std::vector<QUrl> filepaths;
     filepaths.reserve(filenames.size());
@@ -354,7 +825,15 @@ void PlaylistModel::onInsertRequest(QStringList filenames)
     std::transform(filenames.begin(), filenames.end(), std::back_inserter(filepaths),
         [](QString filename) { return QUrl::fromUserInput(filename); });
 
-    playlist_.insertTracks(playlist_.getTrackCount(), filepaths);
+    onTracksInserted(playlist_.insertTracks(playlist_.getTrackCount(), filepaths));
+}
+
+void PlaylistModel::onAutoPlaylistChange(const AutoPlaylistChange &change)
+{
+    if(change.removed.count != 0)
+    {
+        onTracksRemoved({ change.removed });
+    }
 
-    endResetModel();
+    onTracksInserted(change.inserted);
 }
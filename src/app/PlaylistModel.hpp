@@ -1,9 +1,14 @@
 #pragma once
 
 #include <QAbstractListModel>
+#include <QString>
 #include <QStringList>
+#include <QTimer>
 
+#include <cstdint>
+#include <limits>
 #include <optional>
+#include <vector>
 
 enum PlaylistColumn
 {
@@ -15,8 +20,14 @@ enum PlaylistColumn
 };
 
 class Playlist;
-struct AudioMetaData;
-
+struct AutoPlaylistChange;
+struct PlaylistTrack;
+struct TrackIndexMapping;
+struct TrackMoves;
+struct TrackRange;
+struct MetaDataRecord;
+
+// Rows of an auto playlist follow its query only, they cannot be dropped, removed or sorted
 class PlaylistModel final : public QAbstractListModel
 {
     Q_OBJECT
@@ -29,6 +40,39 @@ public:
         return playlist_;
     }
 
+    const Playlist &getPlaylist() const
+    {
+        return playlist_;
+    }
+
+    // Rows fetched at once by fetchMore cover the visible rows and the rows scrolled through
+    // in the next few frames, and grow while notifying views fits the frame budget
+    void setFetchHint(int visibleRows, int scrolledRowsPerFrame);
+
+    // Fetches all rows up to the given one in a single batch, e.g. on a jump to the end
+    void fetchUpTo(int row);
+
+    // Drag payload of the rows, built from selection ranges without listing every index
+    QMimeData *createMimeData(std::vector<TrackRange> rows) const;
+
+    // Same as above with the tracks copied right away, for the clipboard
+    QMimeData *createClipboardData(std::vector<TrackRange> rows) const;
+
+    // Looks up metadata of lazily loaded tracks in range [first, first + count), fetched rows among
+    // them are reported as changed. Returns false if all of them were resolved already.
+    bool resolveTracks(std::size_t first, std::size_t count);
+
+    // Longest formatted string of the TRACK or DURATION column among fetched, inserted and resolved
+    // tracks, columns are sized by it without measuring their rows. Tracks are not scanned up front,
+    // the string grows as rows reach the views.
+    const QString &getWidestString(int column) const;
+
+    // Reports a change the updater already made to the auto playlist
+    void onAutoPlaylistChange(const AutoPlaylistChange &);
+
+signals:
+    void widestStringChanged(int column);
+
 protected:
     int rowCount(const QModelIndex & = QModelIndex()) const override;
     int columnCount(const QModelIndex & = QModelIndex()) const override;
@@ -41,7 +85,10 @@ protected:
 
     bool removeRows(int, int, const QModelIndex &) override;
 
+    void sort(int column, Qt::SortOrder = Qt::AscendingOrder) override;
+
     Qt::ItemFlags flags(const QModelIndex &) const override;
+    Qt::DropActions supportedDragActions() const override;
     Qt::DropActions supportedDropActions() const override;
 
     QMimeData *mimeData(const QModelIndexList &) const override;
@@ -49,11 +96,49 @@ protected:
     bool dropMimeData(const QMimeData *, Qt::DropAction, int row, int column, const QModelIndex &) override;
 
 private:
+    // Column strings of a row, formatted once and kept while the row stays in the cache.
+    // Strings of missing values are empty.
+    struct DisplayStrings
+    {
+        int row{ -1 };
+        const MetaDataRecord *record{ nullptr };
+        std::uint32_t revision{ 0 };
+
+        QString artistAlbum;
+        QString track;
+        QString title;
+        QString duration;
+    };
+
+    bool isReadOnly() const;
+
     QVariant roleAlignment(int column) const;
-    QVariant dataTitle(const QString &filepath, const std::optional<AudioMetaData> &) const;
-    QVariant dataArtistAlbum(const std::optional<AudioMetaData> &) const;
-    QVariant dataDuration(const std::optional<AudioMetaData> &) const;
-    QVariant dataTrack(const std::optional<AudioMetaData> &) const;
+
+    const DisplayStrings &getDisplayStrings(int row, const PlaylistTrack &) const;
+
+    // Drops cached strings of rows in range [first, last]
+    void invalidateDisplayStrings(int first, int last = std::numeric_limits<int>::max());
+
+    void fetchRows(std::size_t count);
+
+    void updateWidestStrings(std::size_t first, std::size_t count);
+
+    // Moves rows of the playlist dropped on it
+    void moveTrackRanges(const std::vector<TrackRange> &, int beginRow);
+
+    void applyTrackIndexMapping(const TrackIndexMapping &);
+
+    // Report changes made by the playlist with the exact rows they affected
+    void onTracksInserted(const TrackRange &);
+    void onTracksMoved(const TrackMoves &);
+    void onTracksRemoved(const std::vector<TrackRange> &);
+
+    // Rows shown with unresolved metadata are resolved together once painting is done
+    void requestResolve(int row) const;
+    void resolvePendingRows();
+
+    // Sorting reads metadata of every track, it is applied once tracks are resolved in batches
+    void resolveSortedTracks();
 
 public slots:
     void onDuplicateRemoveRequest();
@@ -62,4 +147,23 @@ public slots:
 private:
     Playlist &playlist_;
     std::size_t fetched_{ 0 };
+    std::size_t fetchBatchSize_;
+    std::size_t fetchMinimum_{ 0 };
+
+    mutable QTimer resolveTimer_;
+    mutable int resolveFirst_{ 0 };
+    mutable int resolveLast_{ -1 };
+
+    // Tracks before the cursor are resolved for the requested sort, the last request wins
+    QTimer sortTimer_;
+    std::size_t sortResolvedTracks_{ 0 };
+    std::optional<int> sortColumn_;
+    Qt::SortOrder sortOrder_{ Qt::AscendingOrder };
+
+    // Direct mapped by row, any window of consecutive rows up to the cache size fits without
+    // evictions so scrolling formats each row once
+    mutable std::vector<DisplayStrings> displayStrings_;
+
+    QString widestTrack_;
+    QString widestDuration_;
 };
@@ -0,0 +1,112 @@
+#include "PlaylistTracksMimeData.hpp"
+
+#include "PlaylistModel.hpp"
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QUrl>
+
+#include <algorithm>
+
+namespace
+{
+QByteArray encodeRows(PlaylistId playlistId, const std::vector<TrackRange> &rows)
+{
+    QByteArray encodedData;
+    QDataStream stream(&encodedData, QIODevice::WriteOnly);
+
+    // Playlist ids are meaningful only in the process that started the drag
+    stream << static_cast<qint64>(QCoreApplication::applicationPid()) << playlistId.value
+           << static_cast<quint32>(rows.size());
+
+    for(const auto &range : rows)
+    {
+        stream << static_cast<quint64>(range.first) << static_cast<quint64>(range.count);
+    }
+
+    return encodedData;
+}
+} // namespace
+
+PlaylistTracksMimeData::PlaylistTracksMimeData(const PlaylistModel &source, std::vector<TrackRange> rows)
+: source_{ &source }
+, rows_{ mergeTrackRanges(std::move(rows)) }
+{
+    setData(mimeType, encodeRows(source.getPlaylist().getPlaylistId(), rows_));
+}
+
+void PlaylistTracksMimeData::takeSnapshot()
+{
+    snapshot_ = getTracks();
+
+    QList<QUrl> urls;
+    urls.reserve(static_cast<qsizetype>(snapshot_->size()));
+    for(const auto &track : *snapshot_)
+    {
+        urls.push_back(QUrl::fromLocalFile(track.path.toString()));
+    }
+    setUrls(urls);
+}
+
+std::vector<PlaylistTrack> PlaylistTracksMimeData::getTracks() const
+{
+    if(snapshot_)
+    {
+        return *snapshot_;
+    }
+
+    if(not source_)
+    {
+        return {};
+    }
+
+    const auto &tracks = source_->getPlaylist().getTracks();
+
+    std::vector<PlaylistTrack> selected;
+    for(const auto &range : rows_)
+    {
+        const auto first = std::min(range.first, tracks.size());
+        const auto last = std::min(range.first + range.count, tracks.size());
+        selected.insert(selected.end(), tracks.cbegin() + first, tracks.cbegin() + last);
+    }
+
+    return selected;
+}
+
+std::optional<PlaylistTracksMimeData::Rows> PlaylistTracksMimeData::decodeRows(const QMimeData &mimeData)
+{
+    if(not mimeData.hasFormat(mimeType))
+    {
+        return std::nullopt;
+    }
+
+    const QByteArray encodedData = mimeData.data(mimeType);
+    QDataStream stream(encodedData);
+
+    qint64 processId{ 0 };
+    Rows rows{ PlaylistId{ 0 }, {} };
+    quint32 rangeCount{ 0 };
+    stream >> processId >> rows.playlistId.value >> rangeCount;
+
+    if(stream.status() != QDataStream::Ok or processId != QCoreApplication::applicationPid())
+    {
+        return std::nullopt;
+    }
+
+    for(quint32 i = 0; i < rangeCount; ++i)
+    {
+        quint64 first{ 0 };
+        quint64 count{ 0 };
+        stream >> first >> count;
+
+        if(stream.status() != QDataStream::Ok)
+        {
+            return std::nullopt;
+        }
+
+        rows.ranges.push_back(TrackRange{ first, count });
+    }
+
+    rows.ranges = mergeTrackRanges(std::move(rows.ranges));
+    return rows;
+}
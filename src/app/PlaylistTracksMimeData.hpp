@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Playlist.hpp"
+
+#include <QMimeData>
+#include <QPointer>
+
+#include <optional>
+#include <vector>
+
+class PlaylistModel;
+
+// Rows of a playlist handed over within the process, by drag and drop or through the clipboard.
+// Tracks are inserted with their metadata handles, without loading the files again.
+// Rows are also serialized as sorted disjoint ranges tagged with the source playlist.
+class PlaylistTracksMimeData final : public QMimeData
+{
+    Q_OBJECT
+
+public:
+    static constexpr auto mimeType{ "application/playlist.rows" };
+
+    PlaylistTracksMimeData(const PlaylistModel &source, std::vector<TrackRange> rows);
+
+    // Copies the tracks and adds their URLs, the source may change or be gone when pasted
+    void takeSnapshot();
+
+    // Tracks of the rows, empty if the source playlist is gone and no snapshot was taken
+    std::vector<PlaylistTrack> getTracks() const;
+
+    struct Rows
+    {
+        PlaylistId playlistId;
+        std::vector<TrackRange> ranges;
+    };
+
+    // Rows of the serialized format, nullopt if missing or dragged from another process
+    static std::optional<Rows> decodeRows(const QMimeData &);
+
+private:
+    QPointer<const PlaylistModel> source_;
+    std::vector<TrackRange> rows_;
+    std::optional<std::vector<PlaylistTrack>> snapshot_;
+};
@@ -1,28 +1,62 @@
 #include "PlaylistWidget.hpp"
 
 #include "Playlist.hpp"
+#include "PlaylistModel.hpp"
 
+#include <QAbstractProxyModel>
+#include <QApplication>
+#include <QClipboard>
+#include <QDrag>
+#include <QGuiApplication>
+#include <QHeaderView>
+#include <QKeyEvent>
 #include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
 #include <QShortcut>
+#include <QStyle>
+#include <QStyleOption>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+constexpr qint64 frameIntervalMs{ 16 };
+
+// Scrolling paused for longer than this starts measuring its velocity again
+constexpr qint64 scrollPauseMs{ 250 };
+
+// Rows kept per column of the text cache, more than a viewport shows
+constexpr int cachedRowsPerColumn{ 512 };
+
+constexpr int cellMargin{ 3 };
+constexpr int rowMargin{ 4 };
+
+// Dragging closer than this to the edge of the viewport scrolls it
+constexpr int dragScrollMargin{ 16 };
+} // namespace
 
 PlaylistWidget::PlaylistWidget(Playlist &playlist, QWidget *parent)
-: QTreeView{ parent }
+: QAbstractScrollArea{ parent }
 , playlist_{ playlist }
+, rowHeight_{ fontMetrics().height() + rowMargin }
 {
-    setAllColumnsShowFocus(true);
-    setAlternatingRowColors(true);
-    setUniformRowHeights(true);
-    setItemsExpandable(false);
-    setExpandsOnDoubleClick(false);
-    setRootIsDecorated(false);
     setFrameShape(QFrame::NoFrame);
-    setSelectionMode(ExtendedSelection);
-    setDropIndicatorShown(true);
-    setDragDropMode(DragDrop);
-    setDragEnabled(true);
+    setFocusPolicy(Qt::StrongFocus);
+    setAcceptDrops(true);
+    viewport()->setAcceptDrops(true);
 
     enablePlayTrackShortcut();
     enableDeleteTrackShortcut();
+    enableCopyPasteShortcuts();
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &PlaylistWidget::onVerticalScroll);
+    connect(verticalScrollBar(), &QScrollBar::actionTriggered, this, &PlaylistWidget::onVerticalScrollAction);
+
+    // Without tracking the dragged position is only applied on release
+    connect(verticalScrollBar(), &QScrollBar::sliderReleased, this,
+        [this]() { onVerticalScrollAction(QAbstractSlider::SliderMove); });
 }
 
 const Playlist &PlaylistWidget::getPlaylist() const
@@ -30,67 +64,717 @@ const Playlist &PlaylistWidget::getPlaylist() const
     return playlist_;
 }
 
+void PlaylistWidget::setModel(QAbstractItemModel *model)
+{
+    if(model_)
+    {
+        disconnect(model_, nullptr, this, nullptr);
+        disconnect(model_, nullptr, viewport(), nullptr);
+    }
+
+    model_ = model;
+    selection_.clear();
+    cells_.clear();
+
+    if(header_)
+    {
+        header_->setModel(model_);
+    }
+
+    if(model_)
+    {
+        connect(model_, &QAbstractItemModel::rowsInserted, this, &PlaylistWidget::onRowsInserted);
+        connect(model_, &QAbstractItemModel::rowsRemoved, this, &PlaylistWidget::onRowsRemoved);
+        connect(model_, &QAbstractItemModel::rowsMoved, this, &PlaylistWidget::onRowsMoved);
+        connect(model_, &QAbstractItemModel::layoutAboutToBeChanged, this,
+            &PlaylistWidget::onLayoutAboutToBeChanged);
+        connect(model_, &QAbstractItemModel::layoutChanged, this, &PlaylistWidget::onLayoutChanged);
+        connect(model_, &QAbstractItemModel::modelReset, this, &PlaylistWidget::onModelReset);
+        connect(model_, &QAbstractItemModel::dataChanged, viewport(), qOverload<>(&QWidget::update));
+    }
+
+    updateGeometries();
+    updateFetchHint();
+}
+
+QAbstractItemModel *PlaylistWidget::model() const
+{
+    return model_;
+}
+
+void PlaylistWidget::setHeader(QHeaderView *header)
+{
+    delete header_;
+    header_ = header;
+
+    if(not header_)
+    {
+        setViewportMargins(0, 0, 0, 0);
+        return;
+    }
+
+    header_->setParent(this);
+    header_->setModel(model_);
+    header_->show();
+
+    connect(header_, &QHeaderView::sectionResized, viewport(), qOverload<>(&QWidget::update));
+    connect(header_, &QHeaderView::sectionMoved, viewport(), qOverload<>(&QWidget::update));
+    connect(header_, &QHeaderView::geometriesChanged, this, &PlaylistWidget::updateGeometries);
+    connect(header_, &QHeaderView::sectionResized, this, &PlaylistWidget::updateGeometries);
+
+    updateGeometries();
+}
+
+QHeaderView *PlaylistWidget::header() const
+{
+    return header_;
+}
+
+void PlaylistWidget::setColumnWidth(int column, int width)
+{
+    if(header_)
+    {
+        header_->resizeSection(column, width);
+    }
+}
+
+void PlaylistWidget::fitColumnToText(int column, const QString &text)
+{
+    if(header_)
+    {
+        const auto textWidth = fontMetrics().horizontalAdvance(text) + 2 * cellMargin;
+        header_->resizeSection(column, std::max(header_->sectionSizeHint(column), textWidth));
+    }
+}
+
+void PlaylistWidget::paintEvent(QPaintEvent *)
+{
+    if(not model_ or not header_)
+    {
+        return;
+    }
+
+    QPainter painter{ viewport() };
+
+    const auto offset = verticalScrollBar()->value();
+    const auto firstRow = offset / rowHeight_;
+    const auto lastRow = std::min(getRowCount() - 1, (offset + viewport()->height()) / rowHeight_);
+
+    for(auto row = firstRow; row <= lastRow; ++row)
+    {
+        paintRow(painter, row, row * rowHeight_ - offset);
+    }
+
+    if(dropRow_)
+    {
+        const auto y = *dropRow_ * rowHeight_ - offset;
+        painter.setPen(QPen{ palette().color(QPalette::Text), 2 });
+        painter.drawLine(0, y, viewport()->width(), y);
+    }
+}
+
+void PlaylistWidget::paintRow(QPainter &painter, int row, int top)
+{
+    const QRect rowRect{ 0, top, viewport()->width(), rowHeight_ };
+    const auto colorGroup = hasFocus() ? QPalette::Active : QPalette::Inactive;
+    const auto selected = selection_.contains(static_cast<std::size_t>(row));
+
+    if(selected)
+    {
+        painter.fillRect(rowRect, palette().brush(colorGroup, QPalette::Highlight));
+    }
+    else if(row % 2)
+    {
+        painter.fillRect(rowRect, palette().brush(colorGroup, QPalette::AlternateBase));
+    }
+
+    painter.setPen(palette().color(colorGroup, selected ? QPalette::HighlightedText : QPalette::Text));
+
+    for(auto visualIndex = 0; visualIndex < header_->count(); ++visualIndex)
+    {
+        const auto column = header_->logicalIndex(visualIndex);
+        const auto x = header_->sectionViewportPosition(column);
+        const auto width = header_->sectionSize(column);
+        if(header_->isSectionHidden(column) or x + width < 0 or x > rowRect.right())
+        {
+            continue;
+        }
+
+        const QRect cellRect{ x + cellMargin, top, width - 2 * cellMargin, rowHeight_ };
+        const auto &cell = getCell(row, column, cellRect.width());
+        const auto textSize = cell.staticText.size();
+
+        auto textX = static_cast<qreal>(cellRect.left());
+        if(cell.alignment & Qt::AlignRight)
+        {
+            textX = cellRect.right() + 1 - textSize.width();
+        }
+        else if(cell.alignment & Qt::AlignHCenter)
+        {
+            textX = cellRect.left() + (cellRect.width() - textSize.width()) / 2;
+        }
+
+        painter.drawStaticText(QPointF{ textX, top + (rowHeight_ - textSize.height()) / 2 }, cell.staticText);
+    }
+
+    if(hasFocus() and selection_.getCurrent() == static_cast<std::size_t>(row))
+    {
+        QStyleOptionFocusRect option;
+        option.initFrom(this);
+        option.rect = rowRect;
+        option.backgroundColor = palette().color(colorGroup, selected ? QPalette::Highlight : QPalette::Base);
+        style()->drawPrimitive(QStyle::PE_FrameFocusRect, &option, &painter, this);
+    }
+}
+
+const PlaylistWidget::CachedCell &PlaylistWidget::getCell(int row, int column, int width)
+{
+    const auto columnCount = static_cast<std::size_t>(model_->columnCount());
+    if(cells_.size() != columnCount * cachedRowsPerColumn)
+    {
+        cells_.assign(columnCount * cachedRowsPerColumn, CachedCell{});
+    }
+
+    auto &cell = cells_[static_cast<std::size_t>(column) * cachedRowsPerColumn + row % cachedRowsPerColumn];
+
+    // Model keeps its strings formatted, comparing them is cheaper than laying them out again
+    const auto index = model_->index(row, column);
+    const auto text = model_->data(index).toString();
+    if(cell.row == row and cell.width == width and cell.text == text)
+    {
+        return cell;
+    }
+
+    if(cell.row != row)
+    {
+        cell.alignment = Qt::Alignment::fromInt(model_->data(index, Qt::TextAlignmentRole).toInt());
+    }
+
+    cell.row = row;
+    cell.width = width;
+    cell.text = text;
+    cell.staticText.setTextFormat(Qt::PlainText);
+    cell.staticText.setText(fontMetrics().elidedText(text, Qt::ElideRight, std::max(0, width)));
+    cell.staticText.prepare(QTransform{}, font());
+
+    return cell;
+}
+
+void PlaylistWidget::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateGeometries();
+    updateFetchHint();
+    fetchMissingRows();
+}
+
+void PlaylistWidget::showEvent(QShowEvent *event)
+{
+    QAbstractScrollArea::showEvent(event);
+    fetchMissingRows();
+}
+
+void PlaylistWidget::scrollContentsBy(int dx, int)
+{
+    if(header_ and dx)
+    {
+        header_->setOffset(horizontalScrollBar()->value());
+    }
+
+    viewport()->update();
+    fetchMissingRows();
+}
+
+void PlaylistWidget::updateGeometries()
+{
+    const auto headerHeight = header_ ? header_->sizeHint().height() : 0;
+    setViewportMargins(0, headerHeight, 0, 0);
+
+    if(header_)
+    {
+        const auto viewportGeometry = viewport()->geometry();
+        header_->setGeometry(viewportGeometry.left(), viewportGeometry.top() - headerHeight,
+            viewportGeometry.width(), headerHeight);
+    }
+
+    const auto viewportHeight = viewport()->height();
+    verticalScrollBar()->setRange(0, std::max(0, getRowCount() * rowHeight_ - viewportHeight));
+    verticalScrollBar()->setPageStep(viewportHeight);
+    verticalScrollBar()->setSingleStep(rowHeight_);
+
+    const auto contentWidth = header_ ? header_->length() : 0;
+    const auto viewportWidth = viewport()->width();
+    horizontalScrollBar()->setRange(0, std::max(0, contentWidth - viewportWidth));
+    horizontalScrollBar()->setPageStep(viewportWidth);
+
+    viewport()->update();
+}
+
+int PlaylistWidget::getRowCount() const
+{
+    return model_ ? model_->rowCount() : 0;
+}
+
+int PlaylistWidget::rowAt(int y) const
+{
+    const auto row = (y + verticalScrollBar()->value()) / rowHeight_;
+    return y >= 0 and row < getRowCount() ? row : -1;
+}
+
+void PlaylistWidget::ensureVisible(int row)
+{
+    const auto top = row * rowHeight_;
+    const auto offset = verticalScrollBar()->value();
+
+    if(top < offset)
+    {
+        verticalScrollBar()->setValue(top);
+    }
+    else if(top + rowHeight_ > offset + viewport()->height())
+    {
+        verticalScrollBar()->setValue(top + rowHeight_ - viewport()->height());
+    }
+}
+
+void PlaylistWidget::setCurrentRow(int row, Qt::KeyboardModifiers modifiers)
+{
+    const auto selectedRow = static_cast<std::size_t>(row);
+    if(modifiers & Qt::ShiftModifier)
+    {
+        selection_.extendTo(selectedRow);
+    }
+    else if(modifiers & Qt::ControlModifier)
+    {
+        selection_.toggle(selectedRow);
+    }
+    else
+    {
+        selection_.select(selectedRow);
+    }
+
+    ensureVisible(row);
+    viewport()->update();
+}
+
+void PlaylistWidget::mousePressEvent(QMouseEvent *event)
+{
+    if(Qt::LeftButton != event->button())
+    {
+        return QAbstractScrollArea::mousePressEvent(event);
+    }
+
+    pressPosition_ = event->position().toPoint();
+    pressedRow_.reset();
+
+    const auto row = rowAt(pressPosition_.y());
+    dragPending_ = row >= 0 and selection_.contains(static_cast<std::size_t>(row));
+
+    if(row < 0)
+    {
+        selection_.clear();
+        viewport()->update();
+    }
+    else if(dragPending_ and not(event->modifiers() & (Qt::ShiftModifier | Qt::ControlModifier)))
+    {
+        // Selection is kept for dragging all selected rows
+        pressedRow_ = row;
+    }
+    else
+    {
+        setCurrentRow(row, event->modifiers());
+    }
+}
+
+void PlaylistWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if(not dragPending_ or not(event->buttons() & Qt::LeftButton))
+    {
+        return QAbstractScrollArea::mouseMoveEvent(event);
+    }
+
+    if((event->position().toPoint() - pressPosition_).manhattanLength() >= QApplication::startDragDistance())
+    {
+        dragPending_ = false;
+        pressedRow_.reset();
+        startDrag();
+    }
+}
+
+void PlaylistWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if(pressedRow_)
+    {
+        setCurrentRow(*pressedRow_, Qt::NoModifier);
+    }
+
+    pressedRow_.reset();
+    dragPending_ = false;
+
+    QAbstractScrollArea::mouseReleaseEvent(event);
+}
+
 void PlaylistWidget::mouseDoubleClickEvent(QMouseEvent *event)
 {
     if(Qt::LeftButton != event->button())
     {
-        return QTreeView::mouseDoubleClickEvent(event);
+        return QAbstractScrollArea::mouseDoubleClickEvent(event);
     }
 
-    const auto index = indexAt(event->pos());
-    if(index.isValid())
+    const auto row = rowAt(event->position().toPoint().y());
+    if(row >= 0)
     {
-        emit itemPicked(index.row());
+        emit itemPicked(row);
         update();
     }
 }
 
-void PlaylistWidget::timerEvent(QTimerEvent *event)
+void PlaylistWidget::keyPressEvent(QKeyEvent *event)
 {
-    // Skip `fetchMoreTimer` to avoid fetching for invisible widgets
-    if(isVisible())
+    const auto rowCount = getRowCount();
+    const auto current = selection_.getCurrent();
+    const auto currentRow = current ? static_cast<int>(*current) : -1;
+
+    if(event->matches(QKeySequence::SelectAll))
+    {
+        selection_.selectAll(static_cast<std::size_t>(rowCount));
+        viewport()->update();
+        return;
+    }
+
+    auto row = currentRow;
+    switch(event->key())
+    {
+    case Qt::Key_Up: row = currentRow - 1; break;
+    case Qt::Key_Down: row = currentRow + 1; break;
+    case Qt::Key_PageUp: row = currentRow - getVisibleRowCount() + 1; break;
+    case Qt::Key_PageDown: row = currentRow + getVisibleRowCount() - 1; break;
+    case Qt::Key_Home: row = 0; break;
+    case Qt::Key_End:
+        // Jump to the end fetches the remaining rows at once instead of one batch per relayout
+        if(auto *playlistModel = getPlaylistModel(); playlistModel)
+        {
+            playlistModel->fetchUpTo(static_cast<int>(playlist_.getTrackCount()) - 1);
+        }
+        row = getRowCount() - 1;
+        break;
+    default: return QAbstractScrollArea::keyPressEvent(event);
+    }
+
+    if(getRowCount() > 0)
     {
-        QTreeView::timerEvent(event);
+        setCurrentRow(std::clamp(row, 0, getRowCount() - 1), event->modifiers());
     }
 }
 
-void PlaylistWidget::enablePlayTrackShortcut()
+void PlaylistWidget::onRowsInserted(const QModelIndex &, int first, int last)
 {
-    const auto playShortcut = new QShortcut(Qt::Key_Return, this);
-    playShortcut->setContext(Qt::ShortcutContext::WidgetShortcut);
+    selection_.insertRows(static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1));
+    updateGeometries();
+}
 
-    connect(playShortcut, &QShortcut::activated,
-        [this]()
+void PlaylistWidget::onRowsRemoved(const QModelIndex &, int first, int last)
+{
+    selection_.removeRows(static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1));
+    updateGeometries();
+    fetchMissingRows();
+}
+
+void PlaylistWidget::onRowsMoved(const QModelIndex &, int first, int last, const QModelIndex &, int row)
+{
+    selection_.moveRows(TrackRunMove{ static_cast<std::size_t>(first),
+        static_cast<std::size_t>(last - first + 1), static_cast<std::size_t>(row) });
+    viewport()->update();
+}
+
+void PlaylistWidget::onLayoutAboutToBeChanged()
+{
+    const auto persistentIndex = [this](std::optional<std::size_t> row)
+    { return row ? QPersistentModelIndex{ model_->index(static_cast<int>(*row), 0) } : QPersistentModelIndex{}; };
+
+    for(const auto &range : selection_.getRanges())
+    {
+        for(auto row = range.first; row < range.first + range.count; ++row)
         {
-            const auto currentIndex = this->currentIndex();
-            if(currentIndex.isValid())
-            {
-                emit itemPicked(currentIndex.row());
-                update();
-            }
-        });
+            layoutSelectedIndexes_.push_back(persistentIndex(row));
+        }
+    }
+
+    layoutCurrentIndex_ = persistentIndex(selection_.getCurrent());
+    layoutAnchorIndex_ = persistentIndex(selection_.getAnchor());
 }
 
-using ModelIndexListView = std::pair<QModelIndexList::const_iterator, QModelIndexList::const_iterator>;
+void PlaylistWidget::onLayoutChanged()
+{
+    const auto row = [](const QPersistentModelIndex &index)
+    { return index.isValid() ? std::optional{ static_cast<std::size_t>(index.row()) } : std::nullopt; };
+
+    std::vector<std::size_t> selectedRows;
+    selectedRows.reserve(layoutSelectedIndexes_.size());
+
+    for(const auto &index : layoutSelectedIndexes_)
+    {
+        if(index.isValid())
+        {
+            selectedRows.push_back(static_cast<std::size_t>(index.row()));
+        }
+    }
+
+    selection_.assign(selectedRows, row(layoutCurrentIndex_), row(layoutAnchorIndex_));
+
+    layoutSelectedIndexes_.clear();
+    layoutCurrentIndex_ = QPersistentModelIndex{};
+    layoutAnchorIndex_ = QPersistentModelIndex{};
 
-std::vector<ModelIndexListView> consecutive_values(const QModelIndexList::const_iterator begin,
-    const QModelIndexList::const_iterator end)
+    updateGeometries();
+}
+
+void PlaylistWidget::onModelReset()
+{
+    selection_.clear();
+    updateGeometries();
+    fetchMissingRows();
+}
+
+void PlaylistWidget::dragEnterEvent(QDragEnterEvent *event)
+{
+    dragMoveEvent(event);
+}
+
+void PlaylistWidget::dragMoveEvent(QDragMoveEvent *event)
+{
+    const auto position = event->position().toPoint();
+    const auto row = getDropRow(position);
+
+    if(not model_ or not model_->canDropMimeData(event->mimeData(), event->dropAction(), row, 0, QModelIndex()))
+    {
+        dropRow_.reset();
+        viewport()->update();
+        return event->ignore();
+    }
+
+    if(position.y() < dragScrollMargin)
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+    }
+    else if(position.y() > viewport()->height() - dragScrollMargin)
+    {
+        verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+    }
+
+    dropRow_ = row;
+    viewport()->update();
+    event->acceptProposedAction();
+}
+
+void PlaylistWidget::dragLeaveEvent(QDragLeaveEvent *)
+{
+    dropRow_.reset();
+    viewport()->update();
+}
+
+void PlaylistWidget::dropEvent(QDropEvent *event)
 {
-    if(begin == end) return {};
+    dropRow_.reset();
+    viewport()->update();
 
-    std::vector<ModelIndexListView> views;
-    auto start = begin;
-    for(auto it = begin + 1; it != end; ++it)
+    const auto row = getDropRow(event->position().toPoint());
+    if(model_ and model_->dropMimeData(event->mimeData(), event->dropAction(), row, 0, QModelIndex()))
+    {
+        event->acceptProposedAction();
+    }
+    else
     {
-        if((it - 1)->row() + 1 != it->row())
+        event->ignore();
+    }
+}
+
+int PlaylistWidget::getDropRow(const QPoint &position) const
+{
+    const auto row = rowAt(position.y());
+    if(row < 0)
+    {
+        return getRowCount();
+    }
+
+    // Lower half of a row drops after it
+    const auto rowTop = row * rowHeight_ - verticalScrollBar()->value();
+    return position.y() - rowTop > rowHeight_ / 2 ? row + 1 : row;
+}
+
+void PlaylistWidget::startDrag()
+{
+    auto *playlistModel = getPlaylistModel();
+    const auto rows = getSelectedTrackRanges();
+    if(not playlistModel or rows.empty())
+    {
+        return;
+    }
+
+    auto *drag = new QDrag(this);
+    drag->setMimeData(playlistModel->createMimeData(rows));
+
+    // Rows dropped on this view are moved by the drop itself,
+    // tracks moved to another playlist are removed from this one.
+    // Tracks of auto playlists are only copied.
+    auto *sourceModel = static_cast<QAbstractItemModel *>(playlistModel);
+    const auto actions = sourceModel->supportedDragActions();
+    const auto action = drag->exec(actions, actions.testFlag(Qt::MoveAction) ? Qt::MoveAction : Qt::CopyAction);
+    if(Qt::MoveAction == action and drag->target() != viewport())
+    {
+        std::for_each(rows.crbegin(), rows.crend(),
+            [sourceModel](const auto &range)
+            { sourceModel->removeRows(static_cast<int>(range.first), static_cast<int>(range.count)); });
+    }
+}
+
+std::vector<TrackRange> PlaylistWidget::getSelectedTrackRanges() const
+{
+    std::vector<TrackRange> rows;
+    rows.reserve(selection_.getRanges().size());
+
+    for(const auto &range : selection_.getRanges())
+    {
+        mapRangeToSource(static_cast<int>(range.first), static_cast<int>(range.first + range.count) - 1, rows);
+    }
+
+    return mergeTrackRanges(std::move(rows));
+}
+
+void PlaylistWidget::mapRangeToSource(int first, int last, std::vector<TrackRange> &rows) const
+{
+    auto *proxyModel = qobject_cast<QAbstractProxyModel *>(model_);
+    if(not proxyModel)
+    {
+        rows.push_back(TrackRange{ static_cast<std::size_t>(first), static_cast<std::size_t>(last - first + 1) });
+        return;
+    }
+
+    // Filter keeps the order of rows, the range stays contiguous when its ends are as far apart
+    const auto sourceFirst = proxyModel->mapToSource(proxyModel->index(first, 0)).row();
+    const auto sourceLast = proxyModel->mapToSource(proxyModel->index(last, 0)).row();
+    if(sourceLast - sourceFirst == last - first)
+    {
+        rows.push_back(
+            TrackRange{ static_cast<std::size_t>(sourceFirst), static_cast<std::size_t>(last - first + 1) });
+        return;
+    }
+
+    const auto middle = first + (last - first) / 2;
+    mapRangeToSource(first, middle, rows);
+    mapRangeToSource(middle + 1, last, rows);
+}
+
+void PlaylistWidget::removeSelectedRows()
+{
+    if(not model_)
+    {
+        return;
+    }
+
+    // Remove from end to the beginning to not invalidate rows
+    const auto ranges = selection_.getRanges();
+    std::for_each(ranges.crbegin(), ranges.crend(),
+        [this](const auto &range)
+        { model_->removeRows(static_cast<int>(range.first), static_cast<int>(range.count)); });
+}
+
+PlaylistModel *PlaylistWidget::getPlaylistModel() const
+{
+    if(auto *proxyModel = qobject_cast<QAbstractProxyModel *>(model_); proxyModel)
+    {
+        return qobject_cast<PlaylistModel *>(proxyModel->sourceModel());
+    }
+
+    return qobject_cast<PlaylistModel *>(model_);
+}
+
+int PlaylistWidget::getVisibleRowCount() const
+{
+    return viewport()->height() / rowHeight_ + 1;
+}
+
+void PlaylistWidget::fetchMissingRows()
+{
+    if(not model_ or not isVisible())
+    {
+        return;
+    }
+
+    // Each fetch inserts rows, which updates the scroll range before the next check
+    const auto lastVisibleRow = (verticalScrollBar()->value() + viewport()->height()) / rowHeight_;
+    while(lastVisibleRow >= getRowCount() and model_->canFetchMore(QModelIndex()))
+    {
+        model_->fetchMore(QModelIndex());
+    }
+}
+
+void PlaylistWidget::updateFetchHint()
+{
+    if(auto *playlistModel = getPlaylistModel(); playlistModel)
+    {
+        playlistModel->setFetchHint(getVisibleRowCount(), scrolledRowsPerFrame_);
+    }
+}
+
+void PlaylistWidget::onVerticalScroll(int value)
+{
+    const auto scrolled = std::abs(value - lastScrollValue_);
+    lastScrollValue_ = value;
+
+    const auto elapsed = scrollTimer_.isValid() ? scrollTimer_.restart() : scrollPauseMs;
+    if(not scrollTimer_.isValid())
+    {
+        scrollTimer_.start();
+    }
+
+    if(elapsed >= scrollPauseMs)
+    {
+        scrolledRowsPerFrame_ = 0;
+    }
+    else
+    {
+        const auto rowsPerFrame =
+            static_cast<int>(scrolled / rowHeight_ * frameIntervalMs / std::max<qint64>(1, elapsed));
+
+        // Smoothed, single wheel steps should not double the fetched batch
+        scrolledRowsPerFrame_ = (scrolledRowsPerFrame_ + rowsPerFrame) / 2;
+    }
+
+    updateFetchHint();
+}
+
+void PlaylistWidget::onVerticalScrollAction(int action)
+{
+    // Scroll bar range covers only fetched rows, jumping or dragging to its end fetches the rest
+    // directly instead of a batch each time the end is reached again
+    const auto *scrollBar = verticalScrollBar();
+    const auto toEnd = QAbstractSlider::SliderToMaximum == action or
+                       (QAbstractSlider::SliderMove == action and scrollBar->sliderPosition() >= scrollBar->maximum());
+
+    if(toEnd)
+    {
+        if(auto *playlistModel = getPlaylistModel(); playlistModel)
         {
-            views.emplace_back(ModelIndexListView{ start, it });
-            start = it;
+            playlistModel->fetchUpTo(static_cast<int>(playlist_.getTrackCount()) - 1);
         }
     }
-    views.emplace_back(ModelIndexListView{ start, end });
+}
+
+void PlaylistWidget::enablePlayTrackShortcut()
+{
+    const auto playShortcut = new QShortcut(Qt::Key_Return, this);
+    playShortcut->setContext(Qt::ShortcutContext::WidgetShortcut);
 
-    return views;
+    connect(playShortcut, &QShortcut::activated,
+        [this]()
+        {
+            const auto current = selection_.getCurrent();
+            if(current and static_cast<int>(*current) < getRowCount())
+            {
+                emit itemPicked(static_cast<int>(*current));
+                update();
+            }
+        });
 }
 
 void PlaylistWidget::enableDeleteTrackShortcut()
@@ -98,26 +782,40 @@ void PlaylistWidget::enableDeleteTrackShortcut()
     const auto shortcut = new QShortcut(Qt::Key_Delete, this);
     shortcut->setContext(Qt::ShortcutContext::WidgetShortcut);
 
-    connect(shortcut, &QShortcut::activated,
+    connect(shortcut, &QShortcut::activated, this, &PlaylistWidget::removeSelectedRows);
+}
+
+void PlaylistWidget::enableCopyPasteShortcuts()
+{
+    const auto copyShortcut = new QShortcut(QKeySequence::Copy, this);
+    copyShortcut->setContext(Qt::ShortcutContext::WidgetShortcut);
+
+    connect(copyShortcut, &QShortcut::activated,
         [this]()
         {
-            auto *model = this->model();
-            auto selectedRows = selectionModel()->selectedRows();
+            auto *playlistModel = getPlaylistModel();
+            auto rows = getSelectedTrackRanges();
+            if(not playlistModel or rows.empty()) return;
+
+            QGuiApplication::clipboard()->setMimeData(playlistModel->createClipboardData(std::move(rows)));
+        });
 
-            if(selectedRows.empty()) return;
+    const auto pasteShortcut = new QShortcut(QKeySequence::Paste, this);
+    pasteShortcut->setContext(Qt::ShortcutContext::WidgetShortcut);
 
-            // User could select rows in random order
-            std::sort(selectedRows.begin(), selectedRows.end());
+    connect(pasteShortcut, &QShortcut::activated,
+        [this]()
+        {
+            const auto *mimeData = QGuiApplication::clipboard()->mimeData();
+            if(not mimeData or not model_) return;
 
-            // Batch removal is faster therefore compute views of consecutive values
-            const auto views = consecutive_values(selectedRows.cbegin(), selectedRows.cend());
+            // Pasted in front of the current row, or at the end
+            const auto current = selection_.getCurrent();
+            const auto row = current and static_cast<int>(*current) < getRowCount() ? static_cast<int>(*current) : -1;
 
-            // Remove from end to the beginning to not invalidate indexes
-            std::for_each(views.crbegin(), views.crend(),
-                [model](const auto view)
-                {
-                    const auto count = std::distance(view.first, view.second);
-                    model->removeRows(view.first->row(), count);
-                });
+            if(model_->canDropMimeData(mimeData, Qt::CopyAction, row, 0, QModelIndex()))
+            {
+                model_->dropMimeData(mimeData, Qt::CopyAction, row, 0, QModelIndex());
+            }
         });
 }
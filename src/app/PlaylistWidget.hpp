@@ -1,10 +1,27 @@
 #pragma once
 
-#include <QTreeView>
+#include "RowSelection.hpp"
+
+#include <QAbstractScrollArea>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPersistentModelIndex>
+#include <QPoint>
+#include <QStaticText>
+
+#include <optional>
+#include <vector>
 
 class Playlist;
+class PlaylistModel;
+class QAbstractItemModel;
+class QHeaderView;
+struct TrackRange;
 
-class PlaylistWidget final : public QTreeView
+// Virtualized list of playlist rows, only the visible ones are painted. Their text is laid out
+// once into QStaticText kept in a columnar cache, selection is kept as ranges of rows.
+// Rows are the ones of the model set, usually PlaylistFilterModel over a PlaylistModel.
+class PlaylistWidget final : public QAbstractScrollArea
 {
     Q_OBJECT
 
@@ -13,16 +30,113 @@ public:
 
     const Playlist &getPlaylist() const;
 
-    void mouseDoubleClickEvent(QMouseEvent *) override;
-    void timerEvent(QTimerEvent *) override;
+    void setModel(QAbstractItemModel *);
+    QAbstractItemModel *model() const;
+
+    // Shown above the rows, sections are the columns of the model
+    void setHeader(QHeaderView *);
+    QHeaderView *header() const;
+
+    void setColumnWidth(int column, int width);
+
+    // Sizes the column to the text, or to its header label if that is wider, without measuring rows
+    void fitColumnToText(int column, const QString &text);
 
 signals:
     void itemPicked(int index);
 
+protected:
+    void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *) override;
+    void showEvent(QShowEvent *) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+    void mousePressEvent(QMouseEvent *) override;
+    void mouseMoveEvent(QMouseEvent *) override;
+    void mouseReleaseEvent(QMouseEvent *) override;
+    void mouseDoubleClickEvent(QMouseEvent *) override;
+    void keyPressEvent(QKeyEvent *) override;
+
+    void dragEnterEvent(QDragEnterEvent *) override;
+    void dragMoveEvent(QDragMoveEvent *) override;
+    void dragLeaveEvent(QDragLeaveEvent *) override;
+    void dropEvent(QDropEvent *) override;
+
 private:
+    // Text of a cell laid out for the width of its column, valid while the row is in the cache
+    struct CachedCell
+    {
+        int row{ -1 };
+        int width{ -1 };
+        QString text;
+        Qt::Alignment alignment;
+        QStaticText staticText;
+    };
+
     void enablePlayTrackShortcut();
     void enableDeleteTrackShortcut();
+    // Tracks are copied between playlists with their metadata, see PlaylistTracksMimeData
+    void enableCopyPasteShortcuts();
+
+    int getRowCount() const;
+    int rowAt(int y) const;
+    int getVisibleRowCount() const;
+    const CachedCell &getCell(int row, int column, int width);
+
+    void paintRow(QPainter &, int row, int top);
+
+    void updateGeometries();
+    void ensureVisible(int row);
+    void setCurrentRow(int row, Qt::KeyboardModifiers);
+    void removeSelectedRows();
+
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsMoved(const QModelIndex &parent, int first, int last, const QModelIndex &destination, int row);
+    void onLayoutAboutToBeChanged();
+    void onLayoutChanged();
+    void onModelReset();
+
+    void startDrag();
+    int getDropRow(const QPoint &position) const;
+
+    PlaylistModel *getPlaylistModel() const;
+
+    // Selected rows of the playlist, in ranges of the selection mapped through the filter
+    std::vector<TrackRange> getSelectedTrackRanges() const;
+    void mapRangeToSource(int first, int last, std::vector<TrackRange> &) const;
+
+    // Fetches rows of the model while the viewport is not filled
+    void fetchMissingRows();
+
+    // Tells the model how many rows to fetch ahead of the scrolling
+    void updateFetchHint();
+    void onVerticalScroll(int value);
+    void onVerticalScrollAction(int action);
 
 private:
     Playlist &playlist_;
+    QAbstractItemModel *model_{ nullptr };
+    QHeaderView *header_{ nullptr };
+
+    int rowHeight_{ 0 };
+    // Column-major, rows of a column are direct mapped by their number
+    std::vector<CachedCell> cells_;
+
+    RowSelection selection_;
+
+    // Selection across layout changes, rows are reordered arbitrarily
+    QList<QPersistentModelIndex> layoutSelectedIndexes_;
+    QPersistentModelIndex layoutCurrentIndex_;
+    QPersistentModelIndex layoutAnchorIndex_;
+
+    // Pressed selected row is selected alone on release unless it is dragged
+    QPoint pressPosition_;
+    std::optional<int> pressedRow_;
+    bool dragPending_{ false };
+    std::optional<int> dropRow_;
+
+    QElapsedTimer scrollTimer_;
+    int lastScrollValue_{ 0 };
+    int scrolledRowsPerFrame_{ 0 };
 };
@@ -1,10 +1,13 @@
 #include "ApplicationStyle.hpp"
 #include "AudioMetaDataProvider.hpp"
+#include "AutoPlaylistUpdater.hpp"
+#include "ConfigurationKeys.hpp"
 #include "FilesystemPlaylistIO.hpp"
 #include "LibraryManager.hpp"
 #include "MainWindow.hpp"
 #include "MediaPlayer.hpp"
 #include "MetaDataCache.hpp"
+#include "MetaDataStore.hpp"
 #include "PlaylistManager.hpp"
 
 #ifdef PLUGIN_MPRIS_ENABLED
@@ -55,13 +58,28 @@ int main()
     qInfo() << "Cache file:" << QDir::toNativeSeparators(cacheFile);
 
     MetaDataCache metaDataCache{ cacheFile };
+    MetaDataStore metaDataStore;
     AudioMetaDataProvider metaDataProvider;
-    FilesystemPlaylistIO playlistIO{ metaDataCache, metaDataProvider };
+    const auto playlistFormat = appSettings.value(config::binaryPlaylistsKey, false).toBool()
+                                    ? PlaylistFormat::Binary
+                                    : PlaylistFormat::Text;
+
+    const auto metaDataResolution = appSettings.value(config::lazyMetaDataKey, false).toBool()
+                                        ? MetaDataResolution::OnDemand
+                                        : MetaDataResolution::OnLoad;
+
+    FilesystemPlaylistIO playlistIO{
+        metaDataCache, metaDataStore, metaDataProvider, playlistFormat, metaDataResolution
+    };
 
     const auto playlistsDirectory = QString{ "%1/%2/%3" }.arg(configLocation, applicationName, "playlists");
     qInfo() << "Playlists directory:" << QDir::toNativeSeparators(playlistsDirectory);
 
     PlaylistManager playlistManager{ playlistIO, playlistsDirectory };
+
+    AutoPlaylistUpdater autoPlaylistUpdater{ playlistManager, metaDataStore };
+    metaDataCache.setChangeListener([&autoPlaylistUpdater](const std::vector<CachedTrack> &changes)
+        { autoPlaylistUpdater.update(changes); });
     LibraryManager libraryManager{ metaDataCache };
 
     //     const auto mediaPlayer = MediaPlayer::create();
@@ -76,8 +94,16 @@ int main()
     // #endif
 
     //     MainWindow window{ appSettings, libraryManager, playlistManager, *mediaPlayer };
+    //     autoPlaylistUpdater.setChangeListener([&window](const AutoPlaylistChange &change)
+    //         { window.onAutoPlaylistChange(change); });
     //     window.show();
 
-    // return app.exec();
+    // const auto exitCode = app.exec();
+
+    // Playlists are destroyed with the manager, pending saves need to be written first
+    playlistIO.flush();
+    playlistManager.saveManifest();
+
+    // return exitCode;
     return 0;
 }
@@ -0,0 +1,143 @@
+#include "AutoPlaylistQuery.hpp"
+
+#include "PlaylistTextParser.hpp"
+
+#include <QTextStream>
+
+namespace
+{
+constexpr auto autoPlaylistHeader{ "#AUTOPLAYLIST" };
+
+constexpr auto artistKey{ "artist" };
+constexpr auto albumKey{ "album" };
+constexpr auto pathPrefixKey{ "path" };
+constexpr auto minDurationKey{ "minDuration" };
+constexpr auto maxDurationKey{ "maxDuration" };
+constexpr auto modifiedWithinKey{ "modifiedWithin" };
+
+std::optional<std::chrono::seconds> toSeconds(const QString &value)
+{
+    bool isNumber{ false };
+    const auto seconds = value.toLongLong(&isNumber);
+    return isNumber ? std::optional{ std::chrono::seconds{ seconds } } : std::nullopt;
+}
+} // namespace
+
+bool AutoPlaylistQuery::matches(const QString &path,
+    const AudioMetaData &metaData,
+    std::chrono::seconds lastModified,
+    std::chrono::seconds now) const
+{
+    if(artist and metaData.artist.compare(*artist, Qt::CaseInsensitive) != 0)
+    {
+        return false;
+    }
+
+    if(album and metaData.albumName.compare(*album, Qt::CaseInsensitive) != 0)
+    {
+        return false;
+    }
+
+    if(pathPrefix and not path.startsWith(*pathPrefix))
+    {
+        return false;
+    }
+
+    if((minDuration and metaData.duration < *minDuration) or (maxDuration and metaData.duration > *maxDuration))
+    {
+        return false;
+    }
+
+    return not modifiedWithin or now - lastModified <= *modifiedWithin;
+}
+
+bool isAutoPlaylist(const QByteArray &content)
+{
+    return content.startsWith(autoPlaylistHeader);
+}
+
+QByteArray serializeAutoPlaylistQuery(const AutoPlaylistQuery &query)
+{
+    QByteArray content;
+    QTextStream stream{ &content };
+
+    stream << autoPlaylistHeader << '\n';
+
+    const auto write = [&stream](const char *key, const auto &value)
+    {
+        if(value)
+        {
+            stream << key << '=' << *value << '\n';
+        }
+    };
+
+    const auto writeSeconds = [&stream](const char *key, const auto &value)
+    {
+        if(value)
+        {
+            stream << key << '=' << value->count() << '\n';
+        }
+    };
+
+    write(artistKey, query.artist);
+    write(albumKey, query.album);
+    write(pathPrefixKey, query.pathPrefix);
+    writeSeconds(minDurationKey, query.minDuration);
+    writeSeconds(maxDurationKey, query.maxDuration);
+    writeSeconds(modifiedWithinKey, query.modifiedWithin);
+
+    stream.flush();
+    return content;
+}
+
+std::optional<AutoPlaylistQuery> parseAutoPlaylistQuery(const QByteArray &content)
+{
+    if(not isAutoPlaylist(content))
+    {
+        return std::nullopt;
+    }
+
+    AutoPlaylistQuery query;
+
+    const auto lines = parseTextPlaylist(content);
+    for(std::size_t i = 1; i < lines.size(); ++i)
+    {
+        const auto &line = lines[i];
+
+        const auto separator = line.indexOf('=');
+        if(separator < 0)
+        {
+            continue;
+        }
+
+        const auto key = line.left(separator);
+        const auto value = line.mid(separator + 1);
+
+        if(key == artistKey)
+        {
+            query.artist = value;
+        }
+        else if(key == albumKey)
+        {
+            query.album = value;
+        }
+        else if(key == pathPrefixKey)
+        {
+            query.pathPrefix = value;
+        }
+        else if(key == minDurationKey)
+        {
+            query.minDuration = toSeconds(value);
+        }
+        else if(key == maxDurationKey)
+        {
+            query.maxDuration = toSeconds(value);
+        }
+        else if(key == modifiedWithinKey)
+        {
+            query.modifiedWithin = toSeconds(value);
+        }
+    }
+
+    return query;
+}
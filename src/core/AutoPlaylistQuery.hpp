@@ -0,0 +1,38 @@
+#pragma once
+
+#include "AudioMetaData.hpp"
+
+#include <QByteArray>
+#include <QString>
+
+#include <chrono>
+#include <optional>
+
+// Tracks of an auto playlist, the ones in the metadata cache matching all of the set predicates.
+// Stored in the playlist file in place of its tracks.
+struct AutoPlaylistQuery
+{
+    // Case insensitive
+    std::optional<QString> artist;
+    std::optional<QString> album;
+
+    std::optional<QString> pathPrefix;
+    std::optional<std::chrono::seconds> minDuration;
+    std::optional<std::chrono::seconds> maxDuration;
+
+    // Files modified at most this long before the playlist is loaded or updated
+    std::optional<std::chrono::seconds> modifiedWithin;
+
+    [[nodiscard]] bool matches(const QString &path,
+        const AudioMetaData &,
+        std::chrono::seconds lastModified,
+        std::chrono::seconds now) const;
+};
+
+// Content of an auto playlist file starts with this line, followed by one predicate per line
+[[nodiscard]] bool isAutoPlaylist(const QByteArray &content);
+
+[[nodiscard]] QByteArray serializeAutoPlaylistQuery(const AutoPlaylistQuery &);
+
+// Unknown predicates are skipped, nullopt if the content is not an auto playlist
+[[nodiscard]] std::optional<AutoPlaylistQuery> parseAutoPlaylistQuery(const QByteArray &content);
@@ -0,0 +1,146 @@
+#include "AutoPlaylistUpdater.hpp"
+
+#include "MetaDataCache.hpp"
+#include "MetaDataStore.hpp"
+#include "PlaylistManager.hpp"
+
+#include <QDateTime>
+
+#include <algorithm>
+
+namespace
+{
+// Removal of consecutive tracks or insertion of tracks at the same position
+struct TrackChange
+{
+    std::size_t position;
+    std::size_t removedCount;
+    std::vector<PlaylistTrack> insertedTracks;
+};
+} // namespace
+
+AutoPlaylistUpdater::AutoPlaylistUpdater(PlaylistManager &playlistManager, MetaDataStore &store)
+: playlistManager_{ playlistManager }
+, store_{ store }
+{
+}
+
+void AutoPlaylistUpdater::setChangeListener(ChangeListener listener)
+{
+    changeListener_ = std::move(listener);
+}
+
+std::vector<PlaylistId> AutoPlaylistUpdater::update(const std::vector<CachedTrack> &changes)
+{
+    return update(changes, std::chrono::seconds{ QDateTime::currentSecsSinceEpoch() });
+}
+
+std::vector<PlaylistId> AutoPlaylistUpdater::update(const std::vector<CachedTrack> &changes,
+    std::chrono::seconds now)
+{
+    if(changes.empty())
+    {
+        return {};
+    }
+
+    SortedChanges sortedChanges;
+    sortedChanges.reserve(changes.size());
+
+    for(const auto &change : changes)
+    {
+        sortedChanges.emplace_back(TrackPath{ change.path }, &change);
+    }
+
+    std::sort(sortedChanges.begin(), sortedChanges.end(),
+        [](const auto &l, const auto &r) { return l.first.compare(r.first) < 0; });
+
+    std::vector<PlaylistId> changedPlaylists;
+    for(auto &[id, playlist] : playlistManager_.getLoaded())
+    {
+        if(playlist.getAutoQuery() and update(playlist, sortedChanges, now))
+        {
+            changedPlaylists.push_back(id);
+        }
+    }
+
+    std::sort(changedPlaylists.begin(), changedPlaylists.end(),
+        [](const auto &l, const auto &r) { return l.value < r.value; });
+
+    return changedPlaylists;
+}
+
+bool AutoPlaylistUpdater::update(Playlist &playlist,
+    const SortedChanges &sortedChanges,
+    std::chrono::seconds now)
+{
+    const auto &query = *playlist.getAutoQuery();
+    const auto &tracks = playlist.getTracks();
+
+    // Positions refer to the tracks before any change and do not decrease, changes are in path order
+    std::vector<TrackChange> trackChanges;
+
+    for(const auto &[path, change] : sortedChanges)
+    {
+        const auto found = std::lower_bound(tracks.cbegin(), tracks.cend(), path,
+            [](const auto &track, const auto &trackPath)
+            { return track.path.compare(trackPath) < 0; });
+
+        const auto position = static_cast<std::size_t>(found - tracks.cbegin());
+        const auto isContained = found != tracks.cend() and found->path == path;
+        const auto isMatching =
+            query.matches(change->path, change->audioMetadata, change->lastModified, now);
+
+        if(isMatching and not isContained)
+        {
+            auto handle = store_.find(path);
+            if(not handle)
+            {
+                handle = store_.acquire(path, change->audioMetadata);
+            }
+
+            if(trackChanges.empty() or trackChanges.back().removedCount != 0 or
+                trackChanges.back().position != position)
+            {
+                trackChanges.push_back(TrackChange{ position, 0, {} });
+            }
+
+            trackChanges.back().insertedTracks.push_back(PlaylistTrack{ path, std::move(handle) });
+        }
+        else if(not isMatching and isContained)
+        {
+            auto *previous = trackChanges.empty() ? nullptr : &trackChanges.back();
+            if(previous and previous->removedCount != 0 and
+                previous->position + previous->removedCount == position)
+            {
+                ++previous->removedCount;
+            }
+            else
+            {
+                trackChanges.push_back(TrackChange{ position, 1, {} });
+            }
+        }
+    }
+
+    // Applied back to front, so that positions of the remaining changes stay valid
+    for(auto change = trackChanges.rbegin(); change != trackChanges.rend(); ++change)
+    {
+        AutoPlaylistChange applied{ playlist.getPlaylistId(), { change->position, 0 }, { change->position, 0 } };
+
+        if(change->removedCount != 0)
+        {
+            playlist.removeTracks(change->position, change->removedCount);
+            applied.removed.count = change->removedCount;
+        }
+        else
+        {
+            applied.inserted = playlist.insertTracks(change->position, std::move(change->insertedTracks));
+        }
+
+        if(changeListener_)
+        {
+            changeListener_(applied);
+        }
+    }
+
+    return not trackChanges.empty();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Playlist.hpp"
+
+#include <chrono>
+#include <functional>
+#include <utility>
+#include <vector>
+
+class MetaDataStore;
+class PlaylistManager;
+struct CachedTrack;
+
+// Tracks removed from or inserted into an auto playlist by a single change
+struct AutoPlaylistChange
+{
+    PlaylistId playlistId;
+    TrackRange removed;
+    TrackRange inserted;
+};
+
+// Applies changes of the metadata cache to loaded auto playlists instead of querying it again.
+// Tracks are kept in path order, insertion points are found by binary search.
+class AutoPlaylistUpdater final
+{
+public:
+    AutoPlaylistUpdater(PlaylistManager &, MetaDataStore &);
+
+    // Returns playlists whose tracks changed, ordered by id
+    std::vector<PlaylistId> update(const std::vector<CachedTrack> &changes);
+    std::vector<PlaylistId> update(const std::vector<CachedTrack> &changes, std::chrono::seconds now);
+
+    // Called right after each change of a playlist, so that views showing it follow the tracks
+    using ChangeListener = std::function<void(const AutoPlaylistChange &)>;
+    void setChangeListener(ChangeListener listener);
+
+private:
+    using SortedChanges = std::vector<std::pair<TrackPath, const CachedTrack *>>;
+
+    bool update(Playlist &, const SortedChanges &, std::chrono::seconds now);
+
+private:
+    PlaylistManager &playlistManager_;
+    MetaDataStore &store_;
+    ChangeListener changeListener_;
+};
@@ -0,0 +1,276 @@
+#include "BinaryPlaylist.hpp"
+
+#include <QString>
+#include <QtEndian>
+
+#include <array>
+#include <unordered_map>
+
+namespace
+{
+// Starts with a null character, which never appears in text playlists
+constexpr std::array<char, 4> binaryMagic{ '\0', 'P', 'L', 'B' };
+constexpr quint32 formatVersion{ 1 };
+
+// magic, version, cache generation, track count, string count, pool size in code units
+constexpr std::size_t headerSize{ 32 };
+constexpr std::size_t stringEntrySize{ 2 * sizeof(quint32) };
+
+enum RecordField : std::size_t
+{
+    Directory,
+    FileName,
+    Title,
+    Artist,
+    AlbumName,
+    DiscNumber,
+    TrackNumber,
+    Duration,
+    Flags,
+    FieldCount,
+};
+
+constexpr std::size_t recordSize{ FieldCount * sizeof(quint32) };
+constexpr quint32 hasMetaDataFlag{ 1 };
+
+template<typename T>
+void append(QByteArray &out, T value)
+{
+    const auto littleEndian = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&littleEndian), sizeof(littleEndian));
+}
+
+template<typename T>
+T read(const char *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+class StringTable final
+{
+public:
+    StringTable()
+    {
+        // Index 0 is the empty string, used for missing metadata
+        add(QString{});
+    }
+
+    quint32 add(const QString &string)
+    {
+        const auto [it, inserted] = ids_.try_emplace(string, static_cast<quint32>(strings_.size()));
+        if(inserted)
+        {
+            strings_.push_back(string);
+        }
+
+        return it->second;
+    }
+
+    const std::vector<QString> &getStrings() const
+    {
+        return strings_;
+    }
+
+private:
+    std::unordered_map<QString, quint32> ids_;
+    std::vector<QString> strings_;
+};
+
+QString readString(const char *pool, std::size_t offset, std::size_t length)
+{
+    const auto *first = pool + offset * sizeof(char16_t);
+
+    if constexpr(Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+    {
+        return QString{ reinterpret_cast<const QChar *>(first), static_cast<qsizetype>(length) };
+    }
+
+    QString string{ static_cast<qsizetype>(length), Qt::Uninitialized };
+    for(std::size_t i = 0; i < length; ++i)
+    {
+        string[static_cast<qsizetype>(i)] = QChar{ read<quint16>(first + i * sizeof(char16_t)) };
+    }
+
+    return string;
+}
+} // namespace
+
+bool isBinaryPlaylist(QByteArrayView content)
+{
+    return content.startsWith(QByteArrayView{ binaryMagic.data(), binaryMagic.size() });
+}
+
+QByteArray serializeBinaryPlaylist(const std::vector<StoredTrack> &tracks, std::uint64_t cacheGeneration)
+{
+    StringTable strings;
+    std::unordered_map<TrackPath::DirectoryId, quint32> directories;
+
+    std::vector<std::array<quint32, FieldCount>> records;
+    records.reserve(tracks.size());
+
+    for(const auto &track : tracks)
+    {
+        const auto directoryId = track.path.getDirectoryId();
+        auto directory = directories.find(directoryId);
+        if(directory == directories.end())
+        {
+            directory = directories.emplace(directoryId, strings.add(track.path.getDirectory())).first;
+        }
+
+        auto &record = records.emplace_back();
+        record[Directory] = directory->second;
+        record[FileName] = strings.add(track.path.getFileName());
+
+        if(const auto &metadata = track.audioMetaData)
+        {
+            record[Title] = strings.add(metadata->title);
+            record[Artist] = strings.add(metadata->artist);
+            record[AlbumName] = strings.add(metadata->albumName);
+            record[DiscNumber] = static_cast<quint32>(metadata->discNumber);
+            record[TrackNumber] = static_cast<quint32>(metadata->trackNumber);
+            record[Duration] = static_cast<quint32>(metadata->duration.count());
+            record[Flags] = hasMetaDataFlag;
+        }
+    }
+
+    std::size_t poolSize{ 0 };
+    for(const auto &string : strings.getStrings())
+    {
+        poolSize += static_cast<std::size_t>(string.size());
+    }
+
+    const auto stringCount = strings.getStrings().size();
+
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(headerSize + records.size() * recordSize +
+                                       stringCount * stringEntrySize + poolSize * sizeof(char16_t)));
+
+    out.append(binaryMagic.data(), binaryMagic.size());
+    append<quint32>(out, formatVersion);
+    append<quint64>(out, cacheGeneration);
+    append<quint32>(out, static_cast<quint32>(records.size()));
+    append<quint32>(out, static_cast<quint32>(stringCount));
+    append<quint64>(out, poolSize);
+
+    for(const auto &record : records)
+    {
+        for(const auto field : record)
+        {
+            append<quint32>(out, field);
+        }
+    }
+
+    quint32 offset{ 0 };
+    for(const auto &string : strings.getStrings())
+    {
+        append<quint32>(out, offset);
+        append<quint32>(out, static_cast<quint32>(string.size()));
+        offset += static_cast<quint32>(string.size());
+    }
+
+    for(const auto &string : strings.getStrings())
+    {
+        if constexpr(Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+        {
+            out.append(reinterpret_cast<const char *>(string.utf16()), string.size() * sizeof(char16_t));
+            continue;
+        }
+
+        for(const auto character : string)
+        {
+            append<quint16>(out, character.unicode());
+        }
+    }
+
+    return out;
+}
+
+std::optional<BinaryPlaylist> parseBinaryPlaylist(QByteArrayView content)
+{
+    const auto size = static_cast<std::size_t>(content.size());
+    if(not isBinaryPlaylist(content) or size < headerSize)
+    {
+        return std::nullopt;
+    }
+
+    const auto *data = content.data();
+    if(read<quint32>(data + 4) != formatVersion)
+    {
+        return std::nullopt;
+    }
+
+    const auto cacheGeneration = read<quint64>(data + 8);
+    const std::size_t trackCount = read<quint32>(data + 16);
+    const std::size_t stringCount = read<quint32>(data + 20);
+    const auto poolSize = read<quint64>(data + 24);
+
+    const auto stringsOffset = headerSize + trackCount * recordSize;
+    const auto poolOffset = stringsOffset + stringCount * stringEntrySize;
+    if(size < poolOffset or (size - poolOffset) / sizeof(char16_t) < poolSize)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<QString> strings;
+    strings.reserve(stringCount);
+
+    for(std::size_t i = 0; i < stringCount; ++i)
+    {
+        const auto *entry = data + stringsOffset + i * stringEntrySize;
+        const std::size_t offset = read<quint32>(entry);
+        const std::size_t length = read<quint32>(entry + sizeof(quint32));
+
+        if(offset > poolSize or length > poolSize - offset)
+        {
+            return std::nullopt;
+        }
+
+        strings.push_back(readString(data + poolOffset, offset, length));
+    }
+
+    // Directories are interned once per file, not once per track
+    std::vector<std::optional<TrackPath::DirectoryId>> directoryIds(stringCount);
+
+    BinaryPlaylist playlist{ cacheGeneration, {} };
+    playlist.tracks.reserve(trackCount);
+
+    for(std::size_t i = 0; i < trackCount; ++i)
+    {
+        std::array<quint32, FieldCount> record;
+        for(std::size_t field = 0; field < FieldCount; ++field)
+        {
+            record[field] = read<quint32>(data + headerSize + i * recordSize + field * sizeof(quint32));
+        }
+
+        for(const auto field : { Directory, FileName, Title, Artist, AlbumName })
+        {
+            if(record[field] >= stringCount)
+            {
+                return std::nullopt;
+            }
+        }
+
+        auto &directoryId = directoryIds[record[Directory]];
+        if(not directoryId)
+        {
+            directoryId = TrackPath::internDirectory(strings[record[Directory]]);
+        }
+
+        auto &track = playlist.tracks.emplace_back(
+            StoredTrack{ TrackPath{ *directoryId, strings[record[FileName]] }, std::nullopt });
+
+        if(record[Flags] & hasMetaDataFlag)
+        {
+            track.audioMetaData = AudioMetaData{
+                strings[record[Title]],
+                strings[record[Artist]],
+                strings[record[AlbumName]],
+                static_cast<int>(record[DiscNumber]),
+                static_cast<int>(record[TrackNumber]),
+                std::chrono::seconds{ record[Duration] },
+            };
+        }
+    }
+
+    return playlist;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "StoredTrack.hpp"
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Binary playlist file: a header, fixed size track records, a string table and
+// a UTF-16 string pool. Directories, file names and metadata strings are stored
+// once and referenced by index, so a mapped file is read in a single pass.
+// Inline metadata is valid only for the metadata cache generation it was written with.
+struct BinaryPlaylist
+{
+    std::uint64_t cacheGeneration;
+    std::vector<StoredTrack> tracks;
+};
+
+[[nodiscard]] bool isBinaryPlaylist(QByteArrayView content);
+
+[[nodiscard]] QByteArray serializeBinaryPlaylist(const std::vector<StoredTrack> &, std::uint64_t cacheGeneration);
+
+// Returns nullopt when the content is not a valid binary playlist
+[[nodiscard]] std::optional<BinaryPlaylist> parseBinaryPlaylist(QByteArrayView content);
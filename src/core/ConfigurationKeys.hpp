@@ -11,4 +11,8 @@ constexpr auto volumeKey{ "player/volume" };
 constexpr auto playModeKey{ "player/play_mode" };
 
 constexpr auto lastPlaylistKey{ "playlist/last_playlist" };
+
+constexpr auto binaryPlaylistsKey{ "playlist/binary_format" };
+
+constexpr auto lazyMetaDataKey{ "playlist/lazy_metadata" };
 } // namespace config
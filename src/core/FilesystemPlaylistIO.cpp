@@ -1,25 +1,125 @@
 #include "FilesystemPlaylistIO.hpp"
 
+#include "AutoPlaylistQuery.hpp"
+#include "BinaryPlaylist.hpp"
 #include "IAudioMetaDataProvider.hpp"
 #include "MetaDataCache.hpp"
+#include "MetaDataStore.hpp"
 #include "Playlist.hpp"
+#include "PlaylistExchange.hpp"
+#include "PlaylistJournal.hpp"
+#include "PlaylistTextParser.hpp"
 #include "ProvidedMetadata.hpp"
 
 #include <QCryptographicHash>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QSaveFile>
 #include <QString>
 #include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
 #include <QUrl>
 
 #include <algorithm>
+#include <functional>
+#include <limits>
+#include <set>
 #include <stdexcept>
 #include <vector>
 
 namespace
 {
+constexpr std::chrono::milliseconds saveDelay{ 500 };
+
+// Files whose tags are read ahead per thread while tracks are resolved
+constexpr std::size_t tagReadAheadPerThread{ 16 };
+
+// Replaces the playlist file only once it is fully written
+bool writePlaylistFile(const QString &filepath,
+    const std::vector<StoredTrack> &tracks,
+    PlaylistFormat format,
+    std::uint64_t cacheGeneration)
+{
+    const auto openMode = format == PlaylistFormat::Text ? QIODevice::WriteOnly | QIODevice::Text
+                                                         : QIODevice::WriteOnly;
+
+    QSaveFile playlistFile{ filepath };
+    if(not playlistFile.open(openMode))
+    {
+        return false;
+    }
+
+    if(format == PlaylistFormat::Binary)
+    {
+        const auto content = serializeBinaryPlaylist(tracks, cacheGeneration);
+        if(playlistFile.write(content) != content.size())
+        {
+            playlistFile.cancelWriting();
+        }
+    }
+    else
+    {
+        QTextStream ss{ &playlistFile };
+        for(const auto &track : tracks)
+        {
+            ss << track.path.getDirectory() << track.path.getFileName() << '\n';
+        }
+
+        ss.flush();
+        if(ss.status() != QTextStream::Ok)
+        {
+            playlistFile.cancelWriting();
+        }
+    }
+
+    if(not playlistFile.commit())
+    {
+        return false;
+    }
+
+    // Journal is folded into the new content
+    QFile::remove(getPlaylistJournalPath(filepath));
+    return true;
+}
+
+TrackLocation toLocation(const QUrl &url)
+{
+    return url.isLocalFile() ? TrackLocation{ url.toLocalFile(), true }
+                             : TrackLocation{ url.toString(), false };
+}
+
+// Absolute paths, the common case, skip the URL heuristics
+std::vector<TrackLocation> toLocations(const std::vector<QString> &lines)
+{
+    std::vector<TrackLocation> locations;
+    locations.reserve(lines.size());
+
+    for(const auto &line : lines)
+    {
+        locations.push_back(isAbsoluteLocalPath(line) ? TrackLocation{ line, true }
+                                                      : toLocation(QUrl::fromUserInput(line)));
+    }
+
+    return locations;
+}
+
+std::vector<TrackLocation> toLocations(const std::vector<StoredTrack> &storedTracks)
+{
+    std::vector<QString> paths;
+    paths.reserve(storedTracks.size());
+
+    for(const auto &track : storedTracks)
+    {
+        paths.push_back(track.path.toString());
+    }
+
+    return toLocations(paths);
+}
+
 QStringList getSupportedAudioFileExtensions()
 {
     return QStringList() << "flac"
@@ -34,65 +134,438 @@ QStringList getSupportedAudioFileExtensions()
 }
 } // namespace
 
-FilesystemPlaylistIO::FilesystemPlaylistIO(MetaDataCache &cache, IAudioMetaDataProvider &audioMetaDataProvider)
+FilesystemPlaylistIO::FilesystemPlaylistIO(MetaDataCache &cache,
+    MetaDataStore &store,
+    IAudioMetaDataProvider &audioMetaDataProvider,
+    PlaylistFormat format,
+    MetaDataResolution resolution)
 : cache_{ cache }
+, store_{ store }
 , audioMetaDataProvider_{ audioMetaDataProvider }
+, format_{ format }
+, resolution_{ resolution }
+, saveScheduler_{
+    [format, cacheGeneration = cache.getGeneration()](
+        const QString &filepath, const std::vector<StoredTrack> &tracks)
+    { return writePlaylistFile(filepath, tracks, format, cacheGeneration); },
+    &appendPlaylistJournal,
+    saveDelay,
+}
+{
+}
+
+// Local files with directories expanded, remote locations are kept as they are
+struct FilesystemPlaylistIO::ExpandedLocations
+{
+    std::vector<QString> tracks;
+    std::vector<QString> localFiles;
+};
+
+struct FilesystemPlaylistIO::ParsedPlaylist
+{
+    QString path;
+    QString name;
+    bool isBinary;
+    // Entries of the playlist file with its journal replayed
+    std::size_t storedTrackCount;
+    // None when the journal cannot be appended to
+    std::optional<std::size_t> journalEntries;
+    // Binary playlists only
+    std::vector<StoredTrack> storedTracks;
+    bool isSnapshotCurrent;
+    // Text playlists and binary ones whose snapshot has to be ignored
+    std::vector<TrackLocation> locations;
+    // Only when metadata is resolved on load
+    std::optional<ExpandedLocations> expanded;
+    // Auto playlists have no stored tracks
+    std::optional<AutoPlaylistQuery> autoQuery;
+};
+
+// Shared by all locations resolved together, files are looked up in the cache at once
+// and metadata read from their tags is cached in a single batch
+struct FilesystemPlaylistIO::MetaDataLookup
+{
+    std::unordered_map<QString, std::optional<Metadata>> cached;
+
+    // Files missing in the cache in order of resolving, tags of the next ones are read
+    // ahead on worker threads, nullopt for files that cannot be read
+    std::vector<QString> unread;
+    std::size_t nextUnread{ 0 };
+    std::unordered_map<QString, std::optional<ProvidedMetadata>> provided;
+    QThreadPool threadPool;
+
+    // Keep track of a list of values that are not in cache
+    // Use it for faster lookup of duplicates and batch insert into cache database
+    std::unordered_map<QString, UncachedMetadata> uncached;
+
+    std::optional<std::vector<CachedCoverHash>> cachedCovers;
+    std::vector<std::pair<std::uint64_t, QByteArray>> tempCoverCache;
+    std::unordered_map<QString, std::uint64_t> directoryToCoverCache;
+
+    std::size_t storeHits{ 0 }, tempCacheHits{ 0 }, cacheHits{ 0 }, hintHits{ 0 }, cacheMisses{ 0 };
+    std::size_t tempCoverCacheHits{ 0 }, coverCacheHits{ 0 }, coverCacheMisses{ 0 };
+};
+
+Playlist FilesystemPlaylistIO::load(const QString &filepath)
 {
+    auto parsed = parse(filepath, cache_.getGeneration());
+
+    if(parsed.autoQuery)
+    {
+        std::vector<ParsedPlaylist *> autoPlaylists{ &parsed };
+        return std::move(createAutoPlaylists(autoPlaylists).front());
+    }
+
+    MetaDataLookup lookup;
+    if(parsed.expanded)
+    {
+        prepareLookup(lookup, parsed.expanded->localFiles, {});
+    }
+
+    auto playlist = createPlaylist(std::move(parsed), lookup);
+    finishLookup(lookup);
+    return playlist;
+}
+
+std::vector<std::optional<Playlist>> FilesystemPlaylistIO::loadAll(const std::vector<QString> &filepaths)
+{
+    const auto cacheGeneration = cache_.getGeneration();
+
+    // Parsing and directory listing do not touch the store nor the cache
+    std::vector<std::optional<ParsedPlaylist>> parsed(filepaths.size());
+    {
+        QThreadPool threadPool;
+        for(std::size_t i = 0; i < filepaths.size(); ++i)
+        {
+            threadPool.start(
+                [this, &filepaths, &parsed, i, cacheGeneration]()
+                {
+                    try
+                    {
+                        parsed[i] = parse(filepaths[i], cacheGeneration);
+                    }
+                    catch(const std::runtime_error &error)
+                    {
+                        qWarning() << "Playlist" << filepaths[i] << "cannot be loaded:" << error.what();
+                    }
+                });
+        }
+        threadPool.waitForDone();
+    }
+
+    // Tracks shared by multiple playlists are looked up and read once
+    std::vector<QString> localFiles;
+    for(const auto &playlist : parsed)
+    {
+        if(playlist and playlist->expanded)
+        {
+            const auto &files = playlist->expanded->localFiles;
+            localFiles.insert(localFiles.end(), files.cbegin(), files.cend());
+        }
+    }
+
+    MetaDataLookup lookup;
+    prepareLookup(lookup, localFiles, {});
+
+    // Store records are created in order of the playlists, as if they were loaded one by one
+    std::vector<std::optional<Playlist>> playlists(parsed.size());
+    std::vector<std::size_t> autoPlaylistIndexes;
+    std::vector<ParsedPlaylist *> autoPlaylists;
+
+    for(std::size_t i = 0; i < parsed.size(); ++i)
+    {
+        if(parsed[i] and parsed[i]->autoQuery)
+        {
+            autoPlaylistIndexes.push_back(i);
+            autoPlaylists.push_back(&*parsed[i]);
+        }
+        else if(parsed[i])
+        {
+            playlists[i].emplace(createPlaylist(std::move(*parsed[i]), lookup));
+        }
+    }
+
+    finishLookup(lookup);
+
+    // Tracks cached by the other playlists are already included
+    auto materialized = createAutoPlaylists(autoPlaylists);
+    for(std::size_t i = 0; i < materialized.size(); ++i)
+    {
+        playlists[autoPlaylistIndexes[i]].emplace(std::move(materialized[i]));
+    }
+
+    return playlists;
 }
 
-Playlist FilesystemPlaylistIO::load(const QString &filename)
+FilesystemPlaylistIO::ParsedPlaylist FilesystemPlaylistIO::parse(const QString &filepath,
+    std::uint64_t cacheGeneration) const
 {
-    QFile playlistFile{ filename };
+    QFile playlistFile{ filepath };
     if(not playlistFile.open(QIODevice::ReadOnly))
     {
         throw std::runtime_error("Playlist file not found");
     }
 
-    std::vector<QUrl> trackUrls;
+    // Mapping is released when the file is closed, after the content is parsed
+    const auto size = playlistFile.size();
+    const auto *mapped = size > 0 ? playlistFile.map(0, size) : nullptr;
+    const auto content = mapped ? QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), size)
+                                : playlistFile.readAll();
+
+    const QFileInfo playlistFileInfo{ playlistFile };
+
+    ParsedPlaylist parsed{};
+    parsed.path = playlistFileInfo.absoluteFilePath();
+    parsed.name = playlistFileInfo.completeBaseName();
+    parsed.isBinary = isBinaryPlaylist(content);
 
-    QString line;
-    QTextStream ss{ &playlistFile };
-    while(ss.readLineInto(&line))
+    if(isAutoPlaylist(content))
     {
-        if(not line.isEmpty())
+        parsed.autoQuery = parseAutoPlaylistQuery(content);
+        return parsed;
+    }
+
+    if(parsed.isBinary)
+    {
+        auto binaryPlaylist = parseBinaryPlaylist(content);
+        if(not binaryPlaylist)
         {
-            trackUrls.emplace_back(QUrl::fromUserInput(line));
+            throw std::runtime_error("Playlist file is malformed");
         }
+
+        parsed.storedTracks = std::move(binaryPlaylist->tracks);
+        parsed.journalEntries = replayPlaylistJournal(parsed.path, content, parsed.storedTracks,
+            [](const TrackPath &path) { return StoredTrack{ path, std::nullopt }; });
+        parsed.storedTrackCount = parsed.storedTracks.size();
+        parsed.isSnapshotCurrent = binaryPlaylist->cacheGeneration == cacheGeneration;
+    }
+    else
+    {
+        auto lines = parseTextPlaylist(content);
+        parsed.journalEntries = replayPlaylistJournal(
+            parsed.path, content, lines, [](const TrackPath &path) { return path.toString(); });
+        parsed.storedTrackCount = lines.size();
+        parsed.locations = toLocations(lines);
     }
 
-    QFileInfo playlistFileInfo{ playlistFile };
-    return {
-        playlistFileInfo.completeBaseName(),
-        playlistFileInfo.absoluteFilePath(),
-        std::move(trackUrls),
+    // Metadata snapshot may be stale, then tracks are resolved like ones of a text playlist
+    if(MetaDataResolution::OnLoad == resolution_ and not(parsed.isBinary and parsed.isSnapshotCurrent))
+    {
+        if(parsed.isBinary)
+        {
+            parsed.locations = toLocations(parsed.storedTracks);
+        }
+
+        parsed.expanded = expandLocations(parsed.locations);
+    }
+
+    return parsed;
+}
+
+Playlist FilesystemPlaylistIO::createPlaylist(ParsedPlaylist parsed, MetaDataLookup &lookup)
+{
+    Playlist playlist{
+        parsed.name,
+        parsed.path,
+        resolveParsed(parsed, lookup),
         *this,
     };
+
+    // Journal positions refer to stored entries, once they do not map 1:1 to tracks
+    // (missing files, directories) or the file is in another format it has to be written in full
+    const auto canAppend = playlist.getTrackCount() == parsed.storedTrackCount and
+                           parsed.isBinary == (format_ == PlaylistFormat::Binary) and
+                           parsed.journalEntries;
+    saveScheduler_.setJournalSize(
+        parsed.path, canAppend ? *parsed.journalEntries : std::numeric_limits<std::size_t>::max() / 2);
+
+    return playlist;
 }
 
-bool FilesystemPlaylistIO::save(const Playlist &playlist)
+std::vector<PlaylistTrack> FilesystemPlaylistIO::resolveParsed(ParsedPlaylist &parsed, MetaDataLookup &lookup)
 {
-    QFile playlistFile{ playlist.getPath() };
-    if(not playlistFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    if(MetaDataResolution::OnDemand == resolution_)
     {
-        return false;
+        if(not parsed.isBinary)
+        {
+            return loadUnresolved(parsed.locations);
+        }
+
+        std::vector<PlaylistTrack> tracks;
+        tracks.reserve(parsed.storedTracks.size());
+
+        for(const auto &track : parsed.storedTracks)
+        {
+            auto handle = parsed.isSnapshotCurrent and track.audioMetaData ?
+                              store_.acquire(track.path, *track.audioMetaData) :
+                              store_.acquireUnresolved(track.path);
+            tracks.emplace_back(PlaylistTrack{ track.path, std::move(handle) });
+        }
+
+        return tracks;
+    }
+
+    if(not parsed.expanded)
+    {
+        if(auto tracks = resolveStoredTracks(parsed.storedTracks); tracks)
+        {
+            return std::move(*tracks);
+        }
+
+        // Some of the files were never read, rare enough to be expanded here
+        parsed.expanded = expandLocations(toLocations(parsed.storedTracks));
+        prepareLookup(lookup, parsed.expanded->localFiles, {});
     }
 
-    QTextStream ss{ &playlistFile };
-    for(const auto &track : playlist.getTracks())
+    return resolveLocations(*parsed.expanded, lookup, {});
+}
+
+std::vector<Playlist> FilesystemPlaylistIO::createAutoPlaylists(const std::vector<ParsedPlaylist *> &parsed)
+{
+    if(parsed.empty())
     {
-        ss << track.path << '\n';
+        return {};
     }
 
+    const auto now = std::chrono::seconds{ QDateTime::currentSecsSinceEpoch() };
+
+    // Tracks of all the queries are collected in a single pass over the cache
+    std::vector<std::vector<CachedTrack>> matched(parsed.size());
+    cache_.forEachTrack(
+        [&parsed, &matched, now](const CachedTrack &track)
+        {
+            for(std::size_t i = 0; i < parsed.size(); ++i)
+            {
+                if(parsed[i]->autoQuery->matches(track.path, track.audioMetadata, track.lastModified, now))
+                {
+                    matched[i].push_back(track);
+                }
+            }
+        });
+
+    std::vector<Playlist> playlists;
+    playlists.reserve(parsed.size());
+
+    for(std::size_t i = 0; i < parsed.size(); ++i)
+    {
+        std::vector<PlaylistTrack> tracks;
+        tracks.reserve(matched[i].size());
+
+        for(const auto &track : matched[i])
+        {
+            TrackPath trackPath{ track.path };
+            auto handle = store_.find(trackPath);
+            if(not handle)
+            {
+                handle = store_.acquire(trackPath, track.audioMetadata);
+            }
+            tracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
+        }
+
+        std::sort(tracks.begin(), tracks.end(),
+            [](const auto &l, const auto &r) { return l.path.compare(r.path) < 0; });
+
+        qDebug() << "Auto playlist" << parsed[i]->name << "matches" << tracks.size() << "tracks";
+
+        playlists.emplace_back(parsed[i]->name, parsed[i]->path, std::move(*parsed[i]->autoQuery),
+            std::move(tracks), *this);
+    }
+
+    return playlists;
+}
+
+std::optional<std::vector<PlaylistTrack>> FilesystemPlaylistIO::resolveStoredTracks(
+    const std::vector<StoredTrack> &storedTracks)
+{
+    // Tracks without a snapshot were inserted after it was written, they are cached by now
+    std::set<QString> uncachedPaths;
+    for(const auto &track : storedTracks)
+    {
+        if(not track.audioMetaData and not store_.find(track.path))
+        {
+            uncachedPaths.insert(track.path.toString());
+        }
+    }
+
+    std::unordered_map<QString, std::optional<Metadata>> cached;
+    if(not uncachedPaths.empty())
+    {
+        cached = cache_.batchFindByPath(uncachedPaths);
+    }
+
+    // Except for files whose tags were never read, e.g. imported with hints only
+    const auto hasUnreadFiles = std::any_of(uncachedPaths.cbegin(), uncachedPaths.cend(),
+        [&cached](const auto &path) { return isAbsoluteLocalPath(path) and not cached.count(path); });
+
+    if(hasUnreadFiles)
+    {
+        return std::nullopt;
+    }
+
+    std::vector<PlaylistTrack> tracks;
+    tracks.reserve(storedTracks.size());
+
+    for(const auto &track : storedTracks)
+    {
+        if(track.audioMetaData)
+        {
+            tracks.emplace_back(PlaylistTrack{ track.path, store_.acquire(track.path, *track.audioMetaData) });
+            continue;
+        }
+
+        if(auto storedValue = store_.find(track.path); storedValue)
+        {
+            tracks.emplace_back(PlaylistTrack{ track.path, std::move(storedValue) });
+            continue;
+        }
+
+        const auto cachedValue = cached.find(track.path.toString());
+        auto handle = cachedValue != cached.end() and cachedValue->second ?
+                          store_.acquire(track.path, cachedValue->second->audioMetadata) :
+                          store_.acquire(track.path);
+        tracks.emplace_back(PlaylistTrack{ track.path, std::move(handle) });
+    }
+
+    return tracks;
+}
+
+bool FilesystemPlaylistIO::save(const Playlist &playlist, const PlaylistChange &change)
+{
+    // Tracks of auto playlists follow from the query, which is all that is stored
+    if(playlist.getAutoQuery())
+    {
+        return true;
+    }
+
+    saveScheduler_.schedule(playlist, change);
     return true;
 }
 
 bool FilesystemPlaylistIO::rename(const Playlist &playlist, const QString &newName)
 {
+    // Journal is bound to the file name, pending content is written in full before renaming
+    if(not playlist.getAutoQuery())
+    {
+        saveScheduler_.compact(playlist);
+    }
+
     const QFileInfo playlistFileInfo{ playlist.getPath() };
     auto playlistDir{ playlistFileInfo.absoluteDir() };
     return playlistDir.rename(playlist.getName(), newName);
 }
 
+bool FilesystemPlaylistIO::remove(const Playlist &playlist)
+{
+    saveScheduler_.cancel(playlist);
+    QFile::remove(getPlaylistJournalPath(playlist.getPath()));
+    return QFile::remove(playlist.getPath());
+}
+
+void FilesystemPlaylistIO::flush()
+{
+    saveScheduler_.flushAll();
+}
+
 bool FilesystemPlaylistIO::isSupportedFileType(const QFileInfo &fileInfo)
 {
     static auto supportedFileExtensions = getSupportedAudioFileExtensions();
@@ -107,17 +580,109 @@ bool FilesystemPlaylistIO::isSupportedFileType(const QFileInfo &fileInfo)
 
 std::vector<PlaylistTrack> FilesystemPlaylistIO::loadTracks(const std::vector<QUrl> &urls)
 {
-    std::vector<QString> tracks;
-    tracks.reserve(urls.size());
+    std::vector<TrackLocation> locations;
+    locations.reserve(urls.size());
 
-    std::vector<QString> localFiles;
-    localFiles.reserve(urls.size());
+    for(const auto &url : urls)
+    {
+        locations.push_back(toLocation(url));
+    }
+
+    return loadLocations(locations, {});
+}
+
+void FilesystemPlaylistIO::resolveTracks(const std::vector<TrackPath> &paths)
+{
+    std::vector<QString> lines;
+    lines.reserve(paths.size());
+
+    for(const auto &path : paths)
+    {
+        lines.push_back(path.toString());
+    }
 
-    for(const auto &trackUrl : urls)
+    // Records shared with the playlist are filled by the store, returned tracks are not needed
+    (void)loadLocations(toLocations(lines), {});
+
+    for(const auto &path : paths)
+    {
+        store_.markResolved(path);
+    }
+}
+
+std::optional<std::vector<PlaylistTrack>> FilesystemPlaylistIO::importTracks(const QString &filepath)
+{
+    PlaylistImporter importer{ filepath };
+    if(not importer.isOpen())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<PlaylistTrack> tracks;
+
+    // Resolved in batches so that lookup structures do not grow with the playlist
+    constexpr std::size_t batchSize{ 4096 };
+    for(auto batch = importer.read(batchSize); not batch.empty(); batch = importer.read(batchSize))
     {
-        if(trackUrl.isLocalFile())
+        std::vector<TrackLocation> locations;
+        locations.reserve(batch.size());
+
+        std::unordered_map<QString, AudioMetaData> hints;
+        for(auto &importedTrack : batch)
         {
-            const auto trackPath = trackUrl.toLocalFile();
+            if(importedTrack.hint)
+            {
+                hints.emplace(importedTrack.location.path, std::move(*importedTrack.hint));
+            }
+
+            locations.push_back(std::move(importedTrack.location));
+        }
+
+        auto loadedTracks = loadLocations(locations, hints);
+        tracks.insert(tracks.end(), std::make_move_iterator(loadedTracks.begin()),
+            std::make_move_iterator(loadedTracks.end()));
+    }
+
+    qDebug() << "Imported" << tracks.size() << "tracks from" << filepath;
+    return tracks;
+}
+
+bool FilesystemPlaylistIO::exportTracks(const Playlist &playlist, const QString &filepath)
+{
+    const auto format = getPlaylistExchangeFormat(filepath);
+    return format and exportPlaylist(filepath, *format, createStoredTracks(playlist.getTracks()));
+}
+
+std::vector<PlaylistTrack> FilesystemPlaylistIO::loadUnresolved(const std::vector<TrackLocation> &locations)
+{
+    std::vector<PlaylistTrack> tracks;
+    tracks.reserve(locations.size());
+
+    for(const auto &location : locations)
+    {
+        TrackPath trackPath{ location.path };
+        auto handle = store_.acquireUnresolved(trackPath);
+        tracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
+    }
+
+    return tracks;
+}
+
+FilesystemPlaylistIO::ExpandedLocations FilesystemPlaylistIO::expandLocations(
+    const std::vector<TrackLocation> &locations)
+{
+    ExpandedLocations expanded;
+    expanded.tracks.reserve(locations.size());
+    expanded.localFiles.reserve(locations.size());
+
+    auto &tracks = expanded.tracks;
+    auto &localFiles = expanded.localFiles;
+
+    for(const auto &location : locations)
+    {
+        if(location.isLocalFile)
+        {
+            const auto &trackPath = location.path;
 
             const QFileInfo trackFileInfo{ trackPath };
             if(trackFileInfo.isFile() && isSupportedFileType(trackFileInfo))
@@ -153,48 +718,138 @@ std::vector<PlaylistTrack> FilesystemPlaylistIO::loadTracks(const std::vector<QU
         }
         else
         {
-            tracks.emplace_back(trackUrl.toString());
+            tracks.emplace_back(location.path);
         }
     }
 
-    std::vector<PlaylistTrack> playlistTracks;
-    playlistTracks.reserve(tracks.size());
+    return expanded;
+}
 
-    // Keep track of a list of values that are not in cache
-    // Use it for faster lookup of duplicates and batch insert into cache database
-    std::unordered_map<QString, UncachedMetadata> uncached;
+void FilesystemPlaylistIO::prepareLookup(MetaDataLookup &lookup,
+    const std::vector<QString> &localFiles,
+    const std::unordered_map<QString, AudioMetaData> &hints)
+{
+    // Files already loaded by other playlists share their metadata record
+    std::set<QString> uniqueLocalFiles;
+    std::vector<QString> lookedUpFiles;
 
-    std::set<QString> uniqueLocalFiles{ std::make_move_iterator(localFiles.begin()),
-        std::make_move_iterator(localFiles.end()) };
-    auto cached = cache_.batchFindByPath(std::move(uniqueLocalFiles));
+    for(const auto &path : localFiles)
+    {
+        if(not lookup.cached.count(path) and not lookup.provided.count(path) and
+            not store_.find(TrackPath{ path }) and uniqueLocalFiles.insert(path).second)
+        {
+            lookedUpFiles.push_back(path);
+        }
+    }
 
-    auto cachedCovers = cache_.getCoverArtHashCache();
-    std::vector<std::pair<std::uint64_t, QByteArray>> tempCoverCache{};
-    std::unordered_map<QString, std::uint64_t> directoryToCoverCache{};
+    if(lookedUpFiles.empty())
+    {
+        return;
+    }
 
-    std::size_t tempCacheHits{ 0 }, cacheHits{ 0 }, cacheMisses{ 0 };
-    std::size_t tempCoverCacheHits{ 0 }, coverCacheHits{ 0 }, coverCacheMisses{ 0 };
+    lookup.cached.merge(cache_.batchFindByPath(std::move(uniqueLocalFiles)));
+
+    for(auto &path : lookedUpFiles)
+    {
+        if(not lookup.cached.count(path) and not hints.count(path))
+        {
+            lookup.unread.push_back(std::move(path));
+        }
+    }
+}
+
+std::optional<ProvidedMetadata> FilesystemPlaylistIO::readMetaData(MetaDataLookup &lookup, const QString &path)
+{
+    auto provided = lookup.provided.find(path);
+
+    if(provided == lookup.provided.end() and lookup.nextUnread < lookup.unread.size())
+    {
+        // Enough to keep all threads busy, read tags including cover art are kept only until resolved
+        const auto readAheadCount =
+            static_cast<std::size_t>(std::max(1, QThread::idealThreadCount())) * tagReadAheadPerThread;
+        const auto first = lookup.nextUnread;
+        const auto last = std::min(first + readAheadCount, lookup.unread.size());
+
+        std::vector<std::optional<ProvidedMetadata>> metadata(last - first);
+        for(auto i = first; i < last; ++i)
+        {
+            lookup.threadPool.start(
+                [this, &lookup, &metadata, i, first]()
+                { metadata[i - first] = audioMetaDataProvider_.getMetaData(lookup.unread[i]); });
+        }
+        lookup.threadPool.waitForDone();
+
+        for(auto i = first; i < last; ++i)
+        {
+            lookup.provided.emplace(std::move(lookup.unread[i]), std::move(metadata[i - first]));
+        }
+
+        lookup.nextUnread = last;
+        provided = lookup.provided.find(path);
+    }
 
-    for(auto &path : tracks)
+    // NOTE: Called for remote URLs even though we have no chance of retrieving it here
+    if(provided == lookup.provided.end())
     {
+        return audioMetaDataProvider_.getMetaData(path);
+    }
+
+    auto metadata = std::move(provided->second);
+    lookup.provided.erase(provided);
+    return metadata;
+}
+
+std::vector<PlaylistTrack> FilesystemPlaylistIO::resolveLocations(const ExpandedLocations &expanded,
+    MetaDataLookup &lookup,
+    const std::unordered_map<QString, AudioMetaData> &hints)
+{
+    std::vector<PlaylistTrack> playlistTracks;
+    playlistTracks.reserve(expanded.tracks.size());
+
+    auto &cached = lookup.cached;
+    auto &uncached = lookup.uncached;
+    auto &tempCoverCache = lookup.tempCoverCache;
+    auto &directoryToCoverCache = lookup.directoryToCoverCache;
+
+    for(const auto &path : expanded.tracks)
+    {
+        TrackPath trackPath{ path };
+
+        if(auto storedValue = store_.find(trackPath); storedValue)
+        {
+            ++lookup.storeHits;
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(storedValue) });
+            continue;
+        }
+
         if(auto cachedValue = cached.find(path); cachedValue != cached.end())
         {
-            ++cacheHits;
-            playlistTracks.emplace_back(PlaylistTrack{ std::move(path), cachedValue->second->audioMetadata });
+            ++lookup.cacheHits;
+            auto handle = store_.acquire(trackPath, cachedValue->second->audioMetadata);
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
             continue;
         }
 
         if(auto uncachedValue = uncached.find(path); uncachedValue != uncached.end())
         {
-            ++tempCacheHits;
-            playlistTracks.emplace_back(PlaylistTrack{ std::move(path), uncachedValue->second.audioMetadata });
+            ++lookup.tempCacheHits;
+            auto handle = store_.acquire(trackPath, uncachedValue->second.audioMetadata);
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
+            continue;
+        }
+
+        // Tags of imported files are read on a later load, the playlist tells what to display
+        if(auto hint = hints.find(path); hint != hints.end())
+        {
+            ++lookup.hintHits;
+            auto handle = store_.acquireHint(trackPath, hint->second);
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
             continue;
         }
 
-        ++cacheMisses;
+        ++lookup.cacheMisses;
 
-        // NOTE: Called for remote URLs even though we have no chance of retrieving it here
-        if(auto metadata = audioMetaDataProvider_.getMetaData(path); metadata)
+        if(auto metadata = readMetaData(lookup, path); metadata)
         {
             std::optional<std::uint64_t> coverId{};
             bool coverFetchedFromDirectory{ false };
@@ -226,13 +881,19 @@ std::vector<PlaylistTrack> FilesystemPlaylistIO::loadTracks(const std::vector<QU
                 if(tempCoverCacheIt != tempCoverCache.cend())
                 {
                     coverId = tempCoverCacheIt->first;
-                    ++tempCoverCacheHits;
+                    ++lookup.tempCoverCacheHits;
                 }
                 else
                 {
                     const auto coverHash =
                         QCryptographicHash::hash(coverByteView, QCryptographicHash::Algorithm::Sha1);
 
+                    if(not lookup.cachedCovers)
+                    {
+                        lookup.cachedCovers = cache_.getCoverArtHashCache();
+                    }
+                    auto &cachedCovers = *lookup.cachedCovers;
+
                     const auto cachedCoverIt = std::find_if(cachedCovers.cbegin(), cachedCovers.cend(),
                         [&coverHash](const auto &cachedCover)
                         { return cachedCover.hash == coverHash; });
@@ -254,12 +915,12 @@ std::vector<PlaylistTrack> FilesystemPlaylistIO::loadTracks(const std::vector<QU
 
                             coverId = coverCacheResult;
                         }
-                        ++coverCacheMisses;
+                        ++lookup.coverCacheMisses;
                     }
                     else
                     {
                         coverId = cachedCoverIt->id;
-                        ++coverCacheHits;
+                        ++lookup.coverCacheHits;
                     }
                 }
             }
@@ -273,24 +934,43 @@ std::vector<PlaylistTrack> FilesystemPlaylistIO::loadTracks(const std::vector<QU
                 },
             });
 
-            playlistTracks.emplace_back(PlaylistTrack{ std::move(path), std::move(metadata->audioMetadata) });
+            auto handle = store_.acquire(trackPath, metadata->audioMetadata);
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
         }
         else
         {
-            playlistTracks.emplace_back(PlaylistTrack{ std::move(path), std::nullopt });
+            auto handle = store_.acquire(trackPath);
+            playlistTracks.emplace_back(PlaylistTrack{ std::move(trackPath), std::move(handle) });
         }
     }
 
-    qDebug() << tempCacheHits << "temporary cache hits," << cacheHits << "cache hits,"
-             << cacheMisses << "cache misses";
+    return playlistTracks;
+}
 
-    qDebug() << tempCoverCacheHits << "temporary cover cache hits," << coverCacheHits
-             << "cover cache hits," << coverCacheMisses << "cover cache misses";
+void FilesystemPlaylistIO::finishLookup(MetaDataLookup &lookup)
+{
+    qDebug() << lookup.storeHits << "store hits," << lookup.tempCacheHits << "temporary cache hits,"
+             << lookup.cacheHits << "cache hits," << lookup.hintHits << "hints," << lookup.cacheMisses
+             << "cache misses";
 
-    if(!cache_.cache(std::move(uncached)))
+    qDebug() << lookup.tempCoverCacheHits << "temporary cover cache hits," << lookup.coverCacheHits
+             << "cover cache hits," << lookup.coverCacheMisses << "cover cache misses";
+
+    if(not lookup.uncached.empty() and not cache_.cache(lookup.uncached))
     {
         qWarning() << "Caching audio metadata failed";
     }
+}
 
-    return playlistTracks;
+std::vector<PlaylistTrack> FilesystemPlaylistIO::loadLocations(const std::vector<TrackLocation> &locations,
+    const std::unordered_map<QString, AudioMetaData> &hints)
+{
+    const auto expanded = expandLocations(locations);
+
+    MetaDataLookup lookup;
+    prepareLookup(lookup, expanded.localFiles, hints);
+
+    auto tracks = resolveLocations(expanded, lookup, hints);
+    finishLookup(lookup);
+    return tracks;
 }
@@ -1,28 +1,112 @@
 #pragma once
 
 #include "IPlaylistIO.hpp"
+#include "PlaylistSaveScheduler.hpp"
+#include "ProvidedMetadata.hpp"
+#include "StoredTrack.hpp"
+#include "TrackLocation.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 class MetaDataCache;
+class MetaDataStore;
 class IAudioMetaDataProvider;
 
-class QString;
+class QByteArray;
 class QFileInfo;
 
+// Format playlists are written in, both are always readable
+enum class PlaylistFormat
+{
+    // One path per line, can be edited and shared
+    Text,
+    // Paths with a metadata snapshot, see BinaryPlaylist.hpp
+    Binary,
+};
+
+// When metadata of tracks of a loaded playlist is looked up
+enum class MetaDataResolution
+{
+    OnLoad,
+    // Tracks are loaded with paths only, see Playlist::resolveTracks
+    OnDemand,
+};
+
 class FilesystemPlaylistIO final : public IPlaylistIO
 {
 public:
-    explicit FilesystemPlaylistIO(MetaDataCache &cache, IAudioMetaDataProvider &);
+    explicit FilesystemPlaylistIO(MetaDataCache &cache,
+        MetaDataStore &store,
+        IAudioMetaDataProvider &,
+        PlaylistFormat,
+        MetaDataResolution = MetaDataResolution::OnLoad);
 
     Playlist load(const QString &filepath) override;
-    bool save(const Playlist &) override;
+    // Playlists are parsed and tags of their tracks read on worker threads, tracks of
+    // multiple playlists are looked up in the cache together and read only once
+    std::vector<std::optional<Playlist>> loadAll(const std::vector<QString> &filepaths) override;
+
+    // Saves are deferred and journaled in the background, see flush()
+    bool save(const Playlist &, const PlaylistChange &) override;
     bool rename(const Playlist &, const QString &newName) override;
+    bool remove(const Playlist &) override;
 
     std::vector<PlaylistTrack> loadTracks(const std::vector<QUrl> &) override;
+    void resolveTracks(const std::vector<TrackPath> &) override;
+
+    // M3U, PLS and XSPF playlists
+    std::optional<std::vector<PlaylistTrack>> importTracks(const QString &filepath) override;
+    bool exportTracks(const Playlist &, const QString &filepath) override;
+
+    // Writes all pending saves, must be called before playlists are destroyed
+    void flush();
 
 private:
-    bool isSupportedFileType(const QFileInfo &fileInfo);
+    // Defined in the source file
+    struct ExpandedLocations;
+    struct ParsedPlaylist;
+    struct MetaDataLookup;
+
+    // Touches neither the store nor the cache, so playlists can be parsed on worker threads.
+    // Throws std::runtime_error when the file cannot be read.
+    ParsedPlaylist parse(const QString &filepath, std::uint64_t cacheGeneration) const;
+    Playlist createPlaylist(ParsedPlaylist, MetaDataLookup &);
+    std::vector<PlaylistTrack> resolveParsed(ParsedPlaylist &, MetaDataLookup &);
+    // Tracks of all the auto playlists are read from the cache at once, in path order
+    std::vector<Playlist> createAutoPlaylists(const std::vector<ParsedPlaylist *> &);
+    // Returns nullopt when some tracks have to be read from files
+    std::optional<std::vector<PlaylistTrack>> resolveStoredTracks(const std::vector<StoredTrack> &);
+
+    // Tracks of missing files are kept, they are dropped only by the next full load
+    std::vector<PlaylistTrack> loadUnresolved(const std::vector<TrackLocation> &);
+
+    // Metadata of files missing in the cache is read from their tags, unless it is hinted
+    std::vector<PlaylistTrack> loadLocations(const std::vector<TrackLocation> &,
+        const std::unordered_map<QString, AudioMetaData> &hints);
+
+    static ExpandedLocations expandLocations(const std::vector<TrackLocation> &);
+    // Files not looked up by the lookup yet are found in the cache in one query
+    void prepareLookup(MetaDataLookup &,
+        const std::vector<QString> &localFiles,
+        const std::unordered_map<QString, AudioMetaData> &hints);
+    std::optional<ProvidedMetadata> readMetaData(MetaDataLookup &, const QString &path);
+    std::vector<PlaylistTrack> resolveLocations(const ExpandedLocations &,
+        MetaDataLookup &,
+        const std::unordered_map<QString, AudioMetaData> &hints);
+    // Caches metadata read from tags
+    void finishLookup(MetaDataLookup &);
+
+    static bool isSupportedFileType(const QFileInfo &fileInfo);
 
 private:
     MetaDataCache &cache_;
+    MetaDataStore &store_;
     IAudioMetaDataProvider &audioMetaDataProvider_;
+    PlaylistFormat format_;
+    MetaDataResolution resolution_;
+    PlaylistSaveScheduler saveScheduler_;
 };
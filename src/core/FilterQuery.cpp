@@ -0,0 +1,183 @@
+#include "FilterQuery.hpp"
+
+#include "Playlist.hpp"
+#include "SubstringSearch.hpp"
+
+#include <algorithm>
+
+namespace
+{
+constexpr QChar searchKeySeparator{ u'\n' };
+
+// Checks whether the keyword starts in the directory and ends in the file name
+bool spansSeparator(QStringView directory, QStringView fileName, QStringView keyword)
+{
+    for(qsizetype split = 1; split < keyword.size(); ++split)
+    {
+        if(directory.endsWith(keyword.first(split)) and fileName.startsWith(keyword.sliced(split)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool metadataContainsKeyword(const AudioMetaData &metadata, const QString &keyword)
+{
+    return metadata.title.contains(keyword) or metadata.artist.contains(keyword) or
+           metadata.albumName.contains(keyword);
+}
+} // namespace
+
+FilterQuery::FilterQuery(const QString &query)
+: caseSensitive_{ not query.isLower() }
+{
+    const auto keywords = query.trimmed().split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+    keywords_.reserve(keywords.size());
+
+    for(const auto &keyword : keywords)
+    {
+        auto compiled = caseSensitive_ ? keyword : fold(keyword);
+        if(not compiled.isEmpty())
+        {
+            keywords_.push_back(std::move(compiled));
+        }
+    }
+}
+
+bool FilterQuery::isEmpty() const
+{
+    return keywords_.empty();
+}
+
+bool FilterQuery::isCaseSensitive() const
+{
+    return caseSensitive_;
+}
+
+const std::vector<QString> &FilterQuery::getKeywords() const
+{
+    return keywords_;
+}
+
+bool FilterQuery::matches(const PlaylistTrack &track) const
+{
+    const auto *record = track.audioMetaData.getRecord();
+    return matches(track.path, record ? record->values.get() : nullptr);
+}
+
+bool FilterQuery::matches(const TrackPath &path, const MetaDataValues *values) const
+{
+    if(isEmpty())
+    {
+        return true;
+    }
+
+    return caseSensitive_ ? matchesExactly(path, values) : matchesFolded(path, values);
+}
+
+bool FilterQuery::isRefinementOf(const FilterQuery &previous) const
+{
+    if(previous.isEmpty() or caseSensitive_ != previous.caseSensitive_)
+    {
+        return false;
+    }
+
+    return std::all_of(previous.keywords_.cbegin(), previous.keywords_.cend(),
+        [this](const auto &previousKeyword)
+        {
+            return std::any_of(keywords_.cbegin(), keywords_.cend(),
+                [&](const auto &keyword) { return keyword.contains(previousKeyword); });
+        });
+}
+
+QString FilterQuery::fold(QStringView text)
+{
+    auto folded = text.toString();
+
+    const auto isAscii = std::all_of(
+        folded.cbegin(), folded.cend(), [](const QChar c) { return c.unicode() < 0x80; });
+
+    if(not isAscii)
+    {
+        folded = folded.normalized(QString::NormalizationForm_KD);
+        folded.removeIf([](const QChar c) { return c.category() == QChar::Mark_NonSpacing; });
+    }
+
+    return folded.toCaseFolded();
+}
+
+QString FilterQuery::createSearchKey(const TrackPath &path, const std::optional<AudioMetaData> &metadata)
+{
+    auto searchKey = fold(path.getFileName());
+
+    if(metadata)
+    {
+        searchKey += searchKeySeparator + fold(metadata->title) + searchKeySeparator +
+                     fold(metadata->artist) + searchKeySeparator + fold(metadata->albumName);
+    }
+
+    searchKey.squeeze();
+    return searchKey;
+}
+
+bool FilterQuery::matchesExactly(const TrackPath &path, const MetaDataValues *values) const
+{
+    const auto pathString = path.toString();
+    const auto *metadata = values and values->audioMetaData ? &*values->audioMetaData : nullptr;
+
+    return std::all_of(keywords_.cbegin(), keywords_.cend(),
+        [&](const auto &keyword)
+        {
+            return pathString.contains(keyword) or
+                   (metadata and metadataContainsKeyword(*metadata, keyword));
+        });
+}
+
+bool FilterQuery::matchesFolded(const TrackPath &path, const MetaDataValues *values) const
+{
+    const auto searchKey = values ? values->searchKey : createSearchKey(path, std::nullopt);
+
+    const auto separatorIndex = searchKey.indexOf(searchKeySeparator);
+    const auto fileNameKey =
+        QStringView{ searchKey }.first(separatorIndex < 0 ? searchKey.size() : separatorIndex);
+
+    for(std::size_t i = 0; i < keywords_.size(); ++i)
+    {
+        const auto &keyword = keywords_[i];
+        if(containsSubstring(searchKey, keyword))
+        {
+            continue;
+        }
+
+        const auto &directoryMatch = getDirectoryMatch(path.getDirectoryId());
+        if(directoryMatch.matchedKeywords[i] or
+            spansSeparator(directoryMatch.foldedDirectory, fileNameKey, keyword))
+        {
+            continue;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+const FilterQuery::DirectoryMatch &FilterQuery::getDirectoryMatch(TrackPath::DirectoryId directoryId) const
+{
+    if(const auto it = directoryMatches_.find(directoryId); it != directoryMatches_.end())
+    {
+        return it->second;
+    }
+
+    DirectoryMatch match{ fold(TrackPath::getDirectoryById(directoryId)), {} };
+    match.matchedKeywords.reserve(keywords_.size());
+
+    for(const auto &keyword : keywords_)
+    {
+        match.matchedKeywords.push_back(containsSubstring(match.foldedDirectory, keyword));
+    }
+
+    return directoryMatches_.emplace(directoryId, std::move(match)).first->second;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "AudioMetaData.hpp"
+#include "MetaDataHandle.hpp"
+#include "TrackPath.hpp"
+
+#include <QString>
+#include <QStringView>
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+struct PlaylistTrack;
+
+// Playlist search query compiled once per keystroke.
+// Smart case: lowercase queries are matched case and diacritic insensitive
+// against precomputed search keys, other queries are matched exactly.
+// Not thread-safe, matches are memoized per directory. Use a copy per thread.
+class FilterQuery final
+{
+public:
+    FilterQuery() = default;
+    explicit FilterQuery(const QString &query);
+
+    bool isEmpty() const;
+    bool isCaseSensitive() const;
+    const std::vector<QString> &getKeywords() const;
+
+    bool matches(const PlaylistTrack &) const;
+    bool matches(const TrackPath &, const MetaDataValues *) const;
+
+    // Whether every track matching this query also matches the previous one,
+    // i.e. tracks can be filtered out of the previous results only
+    bool isRefinementOf(const FilterQuery &previous) const;
+
+    // Case folding with diacritics removed
+    static QString fold(QStringView text);
+
+    // Folded file name and metadata, separated by new lines
+    static QString createSearchKey(const TrackPath &, const std::optional<AudioMetaData> &);
+
+private:
+    bool matchesExactly(const TrackPath &, const MetaDataValues *) const;
+    bool matchesFolded(const TrackPath &, const MetaDataValues *) const;
+
+    struct DirectoryMatch
+    {
+        QString foldedDirectory;
+        std::vector<bool> matchedKeywords;
+    };
+
+    const DirectoryMatch &getDirectoryMatch(TrackPath::DirectoryId) const;
+
+private:
+    std::vector<QString> keywords_;
+    bool caseSensitive_{ false };
+    mutable std::unordered_map<TrackPath::DirectoryId, DirectoryMatch> directoryMatches_;
+};
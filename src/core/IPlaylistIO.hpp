@@ -1,5 +1,8 @@
 #pragma once
 
+#include "PlaylistChange.hpp"
+
+#include <optional>
 #include <vector>
 
 class Playlist;
@@ -13,8 +16,20 @@ class IPlaylistIO
 public:
     virtual ~IPlaylistIO() = default;
     virtual Playlist load(const QString &filepath) = 0;
-    virtual bool save(const Playlist &) = 0;
+    // Loads multiple playlists at once, results are in order of filepaths,
+    // nullopt for playlists that cannot be loaded
+    virtual std::vector<std::optional<Playlist>> loadAll(const std::vector<QString> &filepaths) = 0;
+    // Called after every modification of the playlist, change describes the modification
+    virtual bool save(const Playlist &, const PlaylistChange &) = 0;
     virtual bool rename(const Playlist &, const QString &newName) = 0;
+    virtual bool remove(const Playlist &) = 0;
 
     virtual std::vector<PlaylistTrack> loadTracks(const std::vector<QUrl> &) = 0;
+
+    // Looks up metadata of tracks loaded without it, their shared records are updated in place
+    virtual void resolveTracks(const std::vector<TrackPath> &) = 0;
+
+    // Playlists of other players, nullopt when the file cannot be read
+    virtual std::optional<std::vector<PlaylistTrack>> importTracks(const QString &filepath) = 0;
+    virtual bool exportTracks(const Playlist &, const QString &filepath) = 0;
 };
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "AudioMetaData.hpp"
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+struct TrackSortKeys;
+
+// Searchable metadata of a record. Never modified once created, updates replace it,
+// so that filtering snapshots share it with the record instead of copying it.
+struct MetaDataValues
+{
+    std::optional<AudioMetaData> audioMetaData;
+
+    // Folded text used by playlist filtering, see FilterQuery
+    QString searchKey;
+};
+
+// Metadata of a single file, shared by every playlist track pointing to it
+struct MetaDataRecord
+{
+    // Never null for records of MetaDataStore
+    std::shared_ptr<const MetaDataValues> values;
+
+    // Metadata was given by an imported playlist, not read from the file tags
+    bool isHint{ false };
+
+    // False until metadata of a lazily loaded track is looked up, see Playlist::resolveTracks
+    bool isResolved{ true };
+
+    // Created by playlist sorting on first use, see PlaylistSort. Reset whenever metadata changes.
+    mutable std::shared_ptr<const TrackSortKeys> sortKeys;
+
+    // Incremented whenever metadata changes, lets views keep strings formatted from it
+    std::uint32_t revision{ 0 };
+};
+
+// Reference counted handle to a shared metadata record.
+// Behaves like std::optional<AudioMetaData>, empty when the record is missing
+// or its metadata is not known.
+class MetaDataHandle final
+{
+public:
+    MetaDataHandle() = default;
+    MetaDataHandle(std::nullopt_t) noexcept
+    {
+    }
+
+    explicit MetaDataHandle(std::shared_ptr<MetaDataRecord> record) noexcept
+    : record_{ std::move(record) }
+    {
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return record_ and record_->values->audioMetaData.has_value();
+    }
+
+    const AudioMetaData &operator*() const
+    {
+        return *record_->values->audioMetaData;
+    }
+
+    const AudioMetaData *operator->() const
+    {
+        return &*record_->values->audioMetaData;
+    }
+
+    const MetaDataRecord *getRecord() const noexcept
+    {
+        return record_.get();
+    }
+
+private:
+    std::shared_ptr<MetaDataRecord> record_;
+};
@@ -0,0 +1,172 @@
+#include "MetaDataStore.hpp"
+
+#include "FilterQuery.hpp"
+
+#include <algorithm>
+
+MetaDataHandle MetaDataStore::acquire(const TrackPath &path)
+{
+    return MetaDataHandle{ getOrCreateRecord(path) };
+}
+
+MetaDataHandle MetaDataStore::acquire(const TrackPath &path, const AudioMetaData &audioMetaData)
+{
+    auto record = getOrCreateRecord(path);
+    if(not record->values->audioMetaData or record->isHint)
+    {
+        record->values = createValues(path, intern(audioMetaData));
+        record->sortKeys.reset();
+        ++record->revision;
+        record->isHint = false;
+        record->isResolved = true;
+    }
+
+    return MetaDataHandle{ std::move(record) };
+}
+
+MetaDataHandle MetaDataStore::acquireUnresolved(const TrackPath &path)
+{
+    auto record = getOrCreateRecord(path);
+    if(not record->values->audioMetaData)
+    {
+        record->isResolved = false;
+    }
+
+    return MetaDataHandle{ std::move(record) };
+}
+
+void MetaDataStore::markResolved(const TrackPath &path)
+{
+    if(const auto it = records_.find(path); it != records_.end())
+    {
+        if(auto record = it->second.lock(); record)
+        {
+            record->isResolved = true;
+        }
+    }
+}
+
+MetaDataHandle MetaDataStore::acquireHint(const TrackPath &path, const AudioMetaData &hint)
+{
+    auto record = getOrCreateRecord(path);
+    if(not record->values->audioMetaData)
+    {
+        record->values = createValues(path, intern(hint));
+        record->sortKeys.reset();
+        ++record->revision;
+        record->isHint = true;
+    }
+
+    return MetaDataHandle{ std::move(record) };
+}
+
+MetaDataHandle MetaDataStore::find(const TrackPath &path) const
+{
+    if(const auto it = records_.find(path); it != records_.end())
+    {
+        if(auto record = it->second.lock(); record and record->values->audioMetaData and not record->isHint)
+        {
+            return MetaDataHandle{ std::move(record) };
+        }
+    }
+
+    return {};
+}
+
+bool MetaDataStore::update(const TrackPath &path, const AudioMetaData &audioMetaData)
+{
+    const auto it = records_.find(path);
+    if(it == records_.end())
+    {
+        return false;
+    }
+
+    auto record = it->second.lock();
+    if(not record)
+    {
+        return false;
+    }
+
+    record->values = createValues(path, intern(audioMetaData));
+    record->sortKeys.reset();
+    ++record->revision;
+    record->isHint = false;
+    record->isResolved = true;
+    return true;
+}
+
+std::size_t MetaDataStore::getRecordCount() const
+{
+    return records_.size();
+}
+
+std::size_t MetaDataStore::getInternedStringCount() const
+{
+    return strings_.size();
+}
+
+std::shared_ptr<MetaDataRecord> MetaDataStore::getOrCreateRecord(const TrackPath &path)
+{
+    auto &weakRecord = records_[path];
+    if(auto record = weakRecord.lock(); record)
+    {
+        return record;
+    }
+
+    auto record = std::make_shared<MetaDataRecord>();
+    record->values = createValues(path, std::nullopt);
+    weakRecord = record;
+
+    if(records_.size() >= nextCleanupSize_)
+    {
+        removeExpiredRecords();
+    }
+
+    return record;
+}
+
+std::shared_ptr<const MetaDataValues> MetaDataStore::createValues(const TrackPath &path,
+    std::optional<AudioMetaData> audioMetaData)
+{
+    auto searchKey = FilterQuery::createSearchKey(path, audioMetaData);
+    return std::make_shared<const MetaDataValues>(MetaDataValues{ std::move(audioMetaData), std::move(searchKey) });
+}
+
+AudioMetaData MetaDataStore::intern(const AudioMetaData &audioMetaData)
+{
+    auto interned = audioMetaData;
+    interned.artist = intern(audioMetaData.artist);
+    interned.albumName = intern(audioMetaData.albumName);
+    return interned;
+}
+
+QString MetaDataStore::intern(const QString &value)
+{
+    if(value.isEmpty())
+    {
+        return {};
+    }
+
+    return *strings_.insert(value).first;
+}
+
+void MetaDataStore::removeExpiredRecords()
+{
+    for(auto it = records_.begin(); it != records_.end();)
+    {
+        it = it->second.expired() ? records_.erase(it) : std::next(it);
+    }
+
+    nextCleanupSize_ = std::max<std::size_t>(1024, records_.size() * 2);
+
+    removeUnusedStrings();
+}
+
+void MetaDataStore::removeUnusedStrings()
+{
+    // Values of released records let go of their strings, only the copy in the set is left
+    for(auto it = strings_.begin(); it != strings_.end();)
+    {
+        it = it->isDetached() ? strings_.erase(it) : std::next(it);
+    }
+}
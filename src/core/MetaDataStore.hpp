@@ -0,0 +1,64 @@
+#pragma once
+
+#include "MetaDataHandle.hpp"
+#include "TrackPath.hpp"
+
+#include <QString>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+// Process-wide store of track metadata records keyed by path.
+// Every playlist containing a file shares the same record, so an update is
+// visible everywhere at once. Artist and album names are interned while records use them.
+class MetaDataStore final
+{
+public:
+    MetaDataStore() = default;
+
+    MetaDataStore(const MetaDataStore &) = delete;
+    MetaDataStore(MetaDataStore &&) = delete;
+    MetaDataStore &operator=(const MetaDataStore &) = delete;
+    MetaDataStore &operator=(MetaDataStore &&) = delete;
+
+    // Returns a handle to the record of the path, creating an empty one if needed
+    MetaDataHandle acquire(const TrackPath &path);
+
+    // Same as above, fills the record if its metadata is not known yet or is only a hint
+    MetaDataHandle acquire(const TrackPath &path, const AudioMetaData &);
+
+    // Fills the record with metadata hinted by a playlist if nothing better is known
+    MetaDataHandle acquireHint(const TrackPath &path, const AudioMetaData &hint);
+
+    // Same as acquire(path), but a record without metadata is looked up later, see markResolved
+    MetaDataHandle acquireUnresolved(const TrackPath &path);
+
+    // Called once metadata of the path was looked up, whether it was found or not
+    void markResolved(const TrackPath &path);
+
+    // Returns a handle only if the record exists and has metadata read from the file
+    MetaDataHandle find(const TrackPath &path) const;
+
+    // Replaces metadata of an existing record, e.g. after a rescan
+    bool update(const TrackPath &path, const AudioMetaData &);
+
+    std::size_t getRecordCount() const;
+    std::size_t getInternedStringCount() const;
+
+private:
+    std::shared_ptr<MetaDataRecord> getOrCreateRecord(const TrackPath &path);
+    static std::shared_ptr<const MetaDataValues> createValues(const TrackPath &path,
+        std::optional<AudioMetaData> audioMetaData);
+    AudioMetaData intern(const AudioMetaData &);
+    QString intern(const QString &);
+    // Expired records and strings no longer shared by any metadata are dropped as the store grows
+    void removeExpiredRecords();
+    void removeUnusedStrings();
+
+private:
+    std::unordered_map<TrackPath, std::weak_ptr<MetaDataRecord>, TrackPathHasher> records_;
+    std::unordered_set<QString> strings_;
+    std::size_t nextCleanupSize_{ 1024 };
+};
@@ -1,10 +1,11 @@
 #include "Playlist.hpp"
 
+#include "FilterQuery.hpp"
 #include "IPlaylistIO.hpp"
-
-#include <QStringView>
+#include "PlaylistTrackIndex.hpp"
 
 #include <random>
+#include <unordered_set>
 
 std::size_t PlaylistIdHasher::operator()(const PlaylistId &id) const noexcept
 {
@@ -25,6 +26,22 @@ Playlist::Playlist(QString name, QString playlistPath, const std::vector<QUrl> &
     insertTracks(tracks, autoSave);
 }
 
+Playlist::Playlist(QString name, QString playlistPath, std::vector<PlaylistTrack> tracks, IPlaylistIO &playlistIO)
+: Playlist(std::move(name), std::move(playlistPath), playlistIO)
+{
+    tracks_ = std::move(tracks);
+}
+
+Playlist::Playlist(QString name,
+    QString playlistPath,
+    AutoPlaylistQuery query,
+    std::vector<PlaylistTrack> tracks,
+    IPlaylistIO &playlistIO)
+: Playlist(std::move(name), std::move(playlistPath), std::move(tracks), playlistIO)
+{
+    autoQuery_ = std::move(query);
+}
+
 const QString &Playlist::getName() const
 {
     return name_;
@@ -45,6 +62,11 @@ PlaylistId Playlist::getPlaylistId() const
     return playlistId;
 }
 
+const std::optional<AutoPlaylistQuery> &Playlist::getAutoQuery() const
+{
+    return autoQuery_;
+}
+
 std::size_t Playlist::getTrackCount() const
 {
     return tracks_.size();
@@ -65,6 +87,30 @@ const PlaylistTrack *Playlist::getTrack(std::size_t index) const
     return &tracks_[index];
 }
 
+bool Playlist::resolveTracks(std::size_t first, std::size_t count)
+{
+    const auto begin = std::min(first, tracks_.size());
+    const auto end = begin + std::min(count, tracks_.size() - begin);
+
+    std::vector<TrackPath> unresolved;
+    for(auto index = begin; index < end; ++index)
+    {
+        const auto &track = tracks_[index];
+        if(const auto *record = track.audioMetaData.getRecord(); record and not record->isResolved)
+        {
+            unresolved.push_back(track.path);
+        }
+    }
+
+    if(unresolved.empty())
+    {
+        return false;
+    }
+
+    playlistIO_.resolveTracks(unresolved);
+    return true;
+}
+
 std::optional<std::size_t> Playlist::getNextTrackIndex(PlayMode playMode) const
 {
     if(tracks_.empty())
@@ -128,10 +174,22 @@ void Playlist::setCurrentTrackIndex(std::size_t newIndex)
     currentTrackIndex_ = newIndex;
 }
 
-void Playlist::insertTracks(std::size_t position, const std::vector<QUrl> &tracksToAdd, bool autoSave)
+TrackRange Playlist::insertTracks(std::size_t position, const std::vector<QUrl> &tracksToAdd, bool autoSave)
 {
     auto loadedTracks = playlistIO_.loadTracks(tracksToAdd);
     const auto tracksAdded = loadedTracks.size();
+    position = std::min(position, tracks_.size());
+
+    PlaylistInsertion insertion{ position, {} };
+    if(autoSave)
+    {
+        insertion.tracks.reserve(tracksAdded);
+        for(const auto &track : loadedTracks)
+        {
+            insertion.tracks.push_back(track.path);
+        }
+    }
+
     tracks_.insert(tracks_.begin() + position, std::make_move_iterator(loadedTracks.begin()),
         std::make_move_iterator(loadedTracks.end()));
 
@@ -142,32 +200,111 @@ void Playlist::insertTracks(std::size_t position, const std::vector<QUrl> &track
 
     if(autoSave)
     {
-        save();
+        save(std::move(insertion));
     }
+
+    return TrackRange{ position, tracksAdded };
 }
 
-void Playlist::insertTracks(const std::vector<QUrl> &tracksToAdd, bool autoSave)
+TrackRange Playlist::insertTracks(const std::vector<QUrl> &tracksToAdd, bool autoSave)
 {
-    insertTracks(tracks_.size(), tracksToAdd, autoSave);
+    return insertTracks(tracks_.size(), tracksToAdd, autoSave);
 }
 
-void Playlist::moveTracks(std::vector<std::size_t> indexes, std::size_t moveToIndex)
+TrackRange Playlist::insertTracks(std::size_t position, std::vector<PlaylistTrack> tracks)
 {
-    std::sort(indexes.begin(), indexes.end());
-    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    if(tracks.empty())
+    {
+        return TrackRange{ std::min(position, tracks_.size()), 0 };
+    }
+
+    position = std::min(position, tracks_.size());
+
+    PlaylistInsertion insertion{ position, {} };
+    insertion.tracks.reserve(tracks.size());
+    for(const auto &track : tracks)
+    {
+        insertion.tracks.push_back(track.path);
+    }
+
+    tracks_.insert(tracks_.begin() + position, std::make_move_iterator(tracks.begin()),
+        std::make_move_iterator(tracks.end()));
+
+    const TrackRange inserted{ position, tracks.size() };
+    if(static_cast<int>(position) <= currentTrackIndex_)
+    {
+        currentTrackIndex_ += tracks.size();
+    }
+
+    save(std::move(insertion));
+
+    return inserted;
+}
+
+TrackMoves Playlist::moveTracks(std::vector<std::size_t> indexes, std::size_t moveToIndex)
+{
+    TrackMoves moves{ {}, splitMoveIntoRuns(indexes, moveToIndex, tracks_.size()) };
+    moves.mapping = moveElements(tracks_, indexes, moveToIndex);
+    if(moves.mapping.newIndexes.empty())
+    {
+        return moves;
+    }
 
-    std::size_t offset{ 0 };
-    for(const auto index : indexes)
+    if(currentTrackIndex_ >= 0)
     {
-        const auto trackPos = tracks_.begin() + index - offset;
-        std::rotate(trackPos, trackPos + 1, tracks_.end());
-        ++offset;
+        currentTrackIndex_ = static_cast<int>(moves.mapping.map(currentTrackIndex_));
     }
 
-    const auto dropPos = tracks_.begin() + std::min(moveToIndex, tracks_.size() - offset);
-    std::rotate(dropPos, tracks_.end() - offset, tracks_.end());
+    save(PlaylistMove{ std::move(indexes), moveToIndex });
 
-    save();
+    return moves;
+}
+
+TrackIndexMapping Playlist::sortTracks(const std::vector<PlaylistSortCriterion> &criteria)
+{
+    // Only checks the records when tracks were resolved beforehand
+    resolveTracks(0, tracks_.size());
+
+    const auto order = sortPlaylistTracks(tracks_, criteria);
+
+    // Tracks at both ends which stay in place are left out of the mapping
+    std::size_t first{ 0 };
+    while(first < order.size() and order[first] == first)
+    {
+        ++first;
+    }
+
+    if(first == order.size())
+    {
+        return {};
+    }
+
+    auto last = order.size();
+    while(order[last - 1] == last - 1)
+    {
+        --last;
+    }
+
+    TrackIndexMapping mapping{ first, std::vector<std::size_t>(last - first) };
+    std::vector<PlaylistTrack> sorted;
+    sorted.reserve(last - first);
+
+    for(auto position = first; position < last; ++position)
+    {
+        mapping.newIndexes[order[position] - first] = position;
+        sorted.push_back(std::move(tracks_[order[position]]));
+    }
+
+    std::move(sorted.begin(), sorted.end(), tracks_.begin() + first);
+
+    if(currentTrackIndex_ >= 0)
+    {
+        currentTrackIndex_ = static_cast<int>(mapping.map(currentTrackIndex_));
+    }
+
+    save(PlaylistReset{});
+
+    return mapping;
 }
 
 void Playlist::removeTracks(std::size_t first, std::size_t count)
@@ -176,7 +313,7 @@ void Playlist::removeTracks(std::size_t first, std::size_t count)
     const auto begin = std::clamp<std::size_t>(first, 0u, tracksCount);
     const auto end = std::clamp<std::size_t>(first + count, begin, tracksCount);
 
-    if(first >= tracksCount || (first + count) >= tracksCount)
+    if(begin == end)
     {
         return;
     }
@@ -187,65 +324,81 @@ void Playlist::removeTracks(std::size_t first, std::size_t count)
     }
 
     tracks_.erase(tracks_.begin() + begin, tracks_.begin() + end);
-    save();
+    save(PlaylistRemoval{ begin, end - begin });
 }
 
-void Playlist::removeDuplicates()
+std::vector<TrackRange> Playlist::removeDuplicates()
 {
-    std::vector<PlaylistTrack> unique;
-    unique.reserve(tracks_.size());
+    std::unordered_set<TrackPath, TrackPathHasher> seen;
+    seen.reserve(tracks_.size());
+
+    std::vector<TrackRange> removed;
+    std::size_t kept{ 0 };
+    std::size_t removedBeforeCurrent{ 0 };
 
-    for(auto &&track : tracks_)
+    for(std::size_t index = 0; index < tracks_.size(); ++index)
     {
-        if(std::find_if(unique.cbegin(), unique.cend(),
-               [&](const auto &i) { return i.path == track.path; }) == unique.cend())
+        if(seen.insert(tracks_[index].path).second)
         {
-            unique.push_back(std::move(track));
+            if(kept != index)
+            {
+                tracks_[kept] = std::move(tracks_[index]);
+            }
+            ++kept;
+            continue;
         }
-    }
 
-    tracks_ = unique;
-    save();
-}
+        if(not removed.empty() and removed.back().first + removed.back().count == index)
+        {
+            ++removed.back().count;
+        }
+        else
+        {
+            removed.push_back(TrackRange{ index, 1 });
+        }
 
-bool metadataContainsKeyword(const AudioMetaData &metadata, const QStringView &keyword)
-{
-    return metadata.title.contains(keyword) or metadata.artist.contains(keyword) or
-           metadata.albumName.contains(keyword);
-}
+        if(static_cast<int>(index) < currentTrackIndex_)
+        {
+            ++removedBeforeCurrent;
+        }
+    }
 
-bool Playlist::matchesFilterQuery(std::size_t trackIndex, QString query) const
-{
-    const auto &track = getTrack(trackIndex);
-    if(not track)
+    if(removed.empty())
     {
-        return false;
+        return removed;
     }
 
-    // Smart case sensitivity
-    const auto caseSensitive =
-        query.isLower() ? Qt::CaseSensitivity::CaseInsensitive : Qt::CaseSensitivity::CaseSensitive;
+    tracks_.erase(tracks_.begin() + kept, tracks_.end());
+    if(currentTrackIndex_ >= 0)
+    {
+        currentTrackIndex_ = std::min(currentTrackIndex_ - static_cast<int>(removedBeforeCurrent),
+            static_cast<int>(tracks_.size()) - 1);
+    }
 
-    const auto trimmed = query.trimmed();
-    const auto keywords = trimmed.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+    save(PlaylistReset{});
 
-    int matchedKeywords = 0;
+    return removed;
+}
 
-    for(const auto &keyword : keywords)
+bool Playlist::matchesFilterQuery(std::size_t trackIndex, const FilterQuery &query) const
+{
+    const auto *track = getTrack(trackIndex);
+    if(not track)
     {
-        if(track->path.contains(keyword, caseSensitive) or
-            (track->audioMetaData and metadataContainsKeyword(track->audioMetaData.value(), keyword)))
-        {
-            ++matchedKeywords;
-        }
+        return false;
     }
 
-    return matchedKeywords == keywords.size();
+    return query.matches(*track);
 }
 
-void Playlist::save()
+void Playlist::save(PlaylistChange change)
 {
-    playlistIO_.save(*this);
+    if(trackIndex_)
+    {
+        trackIndex_->update(*this, change);
+    }
+
+    playlistIO_.save(*this, change);
 }
 
 std::size_t Playlist::getRandomIndex() const
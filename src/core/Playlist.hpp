@@ -1,6 +1,11 @@
 #pragma once
 
-#include "AudioMetaData.hpp"
+#include "AutoPlaylistQuery.hpp"
+#include "MetaDataHandle.hpp"
+#include "PlaylistChange.hpp"
+#include "PlaylistSort.hpp"
+#include "TrackIndexMapping.hpp"
+#include "TrackPath.hpp"
 
 #include <QString>
 #include <QUrl>
@@ -8,12 +13,14 @@
 #include <optional>
 #include <vector>
 
+class FilterQuery;
 class IPlaylistIO;
+class PlaylistTrackIndex;
 
 struct PlaylistTrack
 {
-    QString path;
-    std::optional<AudioMetaData> audioMetaData;
+    TrackPath path;
+    MetaDataHandle audioMetaData;
 };
 
 enum class PlayMode
@@ -43,6 +50,13 @@ class Playlist final
 public:
     Playlist(QString name, QString playlistPath, IPlaylistIO &);
     Playlist(QString name, QString playlistPath, const std::vector<QUrl> &tracks, IPlaylistIO &);
+    Playlist(QString name, QString playlistPath, std::vector<PlaylistTrack> tracks, IPlaylistIO &);
+    // Auto playlist, tracks are expected to match the query and to be in path order
+    Playlist(QString name,
+        QString playlistPath,
+        AutoPlaylistQuery query,
+        std::vector<PlaylistTrack> tracks,
+        IPlaylistIO &);
 
     Playlist(Playlist &&) = default;
     Playlist &operator=(Playlist &&) = delete; // clang: implicitly deleted by PlaylistIO ref
@@ -57,29 +71,46 @@ public:
     void setPlaylistId(PlaylistId id);
     PlaylistId getPlaylistId() const;
 
+    const std::optional<AutoPlaylistQuery> &getAutoQuery() const;
+
     std::size_t getTrackCount() const;
     const std::vector<PlaylistTrack> &getTracks() const;
     const PlaylistTrack *getTrack(std::size_t index) const;
 
+    // Looks up metadata of lazily loaded tracks in range, returns false if there were none
+    bool resolveTracks(std::size_t first, std::size_t count);
+
     std::optional<std::size_t> getNextTrackIndex(PlayMode playMode = PlayMode::RepeatPlaylist) const;
     std::optional<std::size_t> getPreviousTrackIndex(PlayMode playMode = PlayMode::RepeatPlaylist) const;
 
     int getCurrentTrackIndex() const;
     void setCurrentTrackIndex(std::size_t newIndex);
 
-    void insertTracks(std::size_t position, const std::vector<QUrl> &, bool autoSave = true);
-    void insertTracks(const std::vector<QUrl> &, bool autoSave = true);
+    // Modifications return their exact effect on track positions, so that views update only what changed
+
+    // Returns the range of inserted tracks
+    TrackRange insertTracks(std::size_t position, const std::vector<QUrl> &, bool autoSave = true);
+    TrackRange insertTracks(const std::vector<QUrl> &, bool autoSave = true);
+    // Tracks with metadata already looked up
+    TrackRange insertTracks(std::size_t position, std::vector<PlaylistTrack> tracks);
+
+    // Moves tracks in front of the track at moveToIndex among the tracks that are not moved
+    TrackMoves moveTracks(std::vector<std::size_t> indexes, std::size_t moveToIndex);
 
-    void moveTracks(std::vector<std::size_t> indexes, std::size_t moveToIndex);
+    // Stable sort by the criteria, the first one being the most significant.
+    // Unresolved tracks are looked up first, callers resolve large playlists in batches beforehand.
+    TrackIndexMapping sortTracks(const std::vector<PlaylistSortCriterion> &criteria);
 
     void removeTracks(std::size_t first, std::size_t count);
 
-    void removeDuplicates();
+    // Keeps the first track of each path, returns removed ranges in ascending order
+    // with positions from before the removal
+    std::vector<TrackRange> removeDuplicates();
 
-    bool matchesFilterQuery(std::size_t trackIndex, QString query) const;
+    bool matchesFilterQuery(std::size_t trackIndex, const FilterQuery &query) const;
 
 private:
-    void save();
+    void save(PlaylistChange change);
     std::size_t getRandomIndex() const;
 
 private:
@@ -87,8 +118,11 @@ private:
     QString path_;
     IPlaylistIO &playlistIO_;
     std::vector<PlaylistTrack> tracks_;
+    std::optional<AutoPlaylistQuery> autoQuery_;
     int currentTrackIndex_{ -1 };
     PlaylistId playlistId{ 0 };
+    // Set once the playlist is managed, kept up to date with every saved change
+    PlaylistTrackIndex *trackIndex_{ nullptr };
 
     friend class PlaylistManager;
 };
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "TrackPath.hpp"
+
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+// Single modification of a playlist, recorded so that it can be persisted
+// without writing the whole playlist
+
+struct PlaylistInsertion
+{
+    std::size_t position;
+    std::vector<TrackPath> tracks;
+};
+
+struct PlaylistRemoval
+{
+    std::size_t first;
+    std::size_t count;
+};
+
+// Arguments of Playlist::moveTracks
+struct PlaylistMove
+{
+    std::vector<std::size_t> indexes;
+    std::size_t moveToIndex;
+};
+
+// Modification that cannot be described incrementally
+struct PlaylistReset
+{
+};
+
+using PlaylistChange = std::variant<PlaylistInsertion, PlaylistRemoval, PlaylistMove, PlaylistReset>;
@@ -0,0 +1,471 @@
+#include "PlaylistExchange.hpp"
+
+#include "PlaylistTextParser.hpp"
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QUrl>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+// Players usually put "Artist - Title" into playlists
+AudioMetaData createHint(const QString &displayTitle, std::optional<int> seconds)
+{
+    AudioMetaData hint{ displayTitle, {}, {}, 0, 0, std::chrono::seconds{ std::max(0, seconds.value_or(0)) } };
+
+    if(const auto separator = displayTitle.indexOf(" - "); separator > 0)
+    {
+        hint.artist = displayTitle.first(separator);
+        hint.title = displayTitle.sliced(separator + 3);
+    }
+
+    return hint;
+}
+
+QString getDisplayTitle(const AudioMetaData &metadata)
+{
+    return metadata.artist.isEmpty() ? metadata.title : metadata.artist + " - " + metadata.title;
+}
+
+// #EXTINF:<seconds> [attributes],<title>
+std::optional<AudioMetaData> parseExtInf(QStringView info)
+{
+    // Attributes may contain quoted commas, the title starts after the first comma outside quotes
+    qsizetype comma{ -1 };
+    bool quoted{ false };
+    for(qsizetype i = 0; i < info.size() and comma < 0; ++i)
+    {
+        if(info[i] == u'"')
+        {
+            quoted = not quoted;
+        }
+        else if(info[i] == u',' and not quoted)
+        {
+            comma = i;
+        }
+    }
+
+    const auto title = comma < 0 ? QStringView{} : info.sliced(comma + 1).trimmed();
+    if(title.isEmpty())
+    {
+        return std::nullopt;
+    }
+
+    const auto attributes = comma < 0 ? info : info.first(comma);
+    const auto durationEnd = attributes.indexOf(u' ');
+
+    bool isDuration{ false };
+    const auto duration =
+        (durationEnd < 0 ? attributes : attributes.first(durationEnd)).trimmed().toInt(&isDuration);
+
+    return createHint(title.toString(), isDuration ? std::optional{ duration } : std::nullopt);
+}
+
+TrackLocation toLocation(const QUrl &url)
+{
+    return url.isLocalFile() ? TrackLocation{ QDir::cleanPath(url.toLocalFile()), true }
+                             : TrackLocation{ url.toString(), false };
+}
+
+// Path or URL of M3U and PLS playlists
+TrackLocation resolveLocation(QString entry, const QDir &directory)
+{
+    if(entry.contains(u"://"))
+    {
+        return toLocation(QUrl{ entry });
+    }
+
+    // Playlists written on Windows use backslashes
+    entry.replace(u'\\', u'/');
+    return { QDir::cleanPath(directory.absoluteFilePath(entry)), true };
+}
+
+// URI reference of XSPF playlists
+TrackLocation resolveUri(const QString &uri, const QDir &directory)
+{
+    const auto base = QUrl::fromLocalFile(directory.absolutePath() + u'/');
+    return toLocation(base.resolved(QUrl{ uri }));
+}
+
+void writeM3u(QTextStream &out, const std::vector<StoredTrack> &tracks)
+{
+    out << "#EXTM3U\n";
+
+    for(const auto &track : tracks)
+    {
+        if(const auto &metadata = track.audioMetaData)
+        {
+            out << "#EXTINF:" << metadata->duration.count() << ',' << getDisplayTitle(*metadata) << '\n';
+        }
+
+        out << track.path.toString() << '\n';
+    }
+}
+
+void writePls(QTextStream &out, const std::vector<StoredTrack> &tracks)
+{
+    out << "[playlist]\n";
+
+    std::size_t index{ 0 };
+    for(const auto &track : tracks)
+    {
+        ++index;
+        out << "File" << index << '=' << track.path.toString() << '\n';
+
+        if(const auto &metadata = track.audioMetaData)
+        {
+            out << "Title" << index << '=' << getDisplayTitle(*metadata) << '\n';
+            out << "Length" << index << '=' << metadata->duration.count() << '\n';
+        }
+    }
+
+    out << "NumberOfEntries=" << tracks.size() << '\n';
+    out << "Version=2\n";
+}
+
+bool writeXspf(QIODevice &device, const std::vector<StoredTrack> &tracks)
+{
+    QXmlStreamWriter xml{ &device };
+    xml.setAutoFormatting(true);
+
+    xml.writeStartDocument();
+    xml.writeStartElement("playlist");
+    xml.writeDefaultNamespace("http://xspf.org/ns/0/");
+    xml.writeAttribute("version", "1");
+    xml.writeStartElement("trackList");
+
+    for(const auto &track : tracks)
+    {
+        xml.writeStartElement("track");
+
+        const auto path = track.path.toString();
+        xml.writeTextElement("location",
+            isAbsoluteLocalPath(path) ? QUrl::fromLocalFile(path).toString(QUrl::FullyEncoded) : path);
+
+        if(const auto &metadata = track.audioMetaData)
+        {
+            xml.writeTextElement("title", metadata->title);
+
+            if(not metadata->artist.isEmpty())
+            {
+                xml.writeTextElement("creator", metadata->artist);
+            }
+
+            if(not metadata->albumName.isEmpty())
+            {
+                xml.writeTextElement("album", metadata->albumName);
+            }
+
+            if(metadata->trackNumber > 0)
+            {
+                xml.writeTextElement("trackNum", QString::number(metadata->trackNumber));
+            }
+
+            xml.writeTextElement("duration", QString::number(metadata->duration.count() * 1000));
+        }
+
+        xml.writeEndElement();
+    }
+
+    xml.writeEndDocument();
+    return not xml.hasError();
+}
+} // namespace
+
+std::optional<PlaylistExchangeFormat> getPlaylistExchangeFormat(const QString &filepath)
+{
+    const auto suffix = QFileInfo{ filepath }.suffix().toLower();
+
+    if(suffix == "m3u" or suffix == "m3u8")
+    {
+        return PlaylistExchangeFormat::M3u;
+    }
+
+    if(suffix == "pls")
+    {
+        return PlaylistExchangeFormat::Pls;
+    }
+
+    if(suffix == "xspf")
+    {
+        return PlaylistExchangeFormat::Xspf;
+    }
+
+    return std::nullopt;
+}
+
+PlaylistImporter::PlaylistImporter(const QString &filepath)
+: format_{ getPlaylistExchangeFormat(filepath) }
+, directory_{ QFileInfo{ filepath }.absolutePath() }
+, file_{ filepath }
+{
+    if(not format_ or not file_.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+
+    if(*format_ == PlaylistExchangeFormat::Xspf)
+    {
+        xml_.setDevice(&file_);
+    }
+    else
+    {
+        // Extended M3U files are UTF-8 in practice, regardless of the extension
+        text_.setDevice(&file_);
+    }
+}
+
+bool PlaylistImporter::isOpen() const
+{
+    return format_ and file_.isOpen();
+}
+
+std::vector<ImportedTrack> PlaylistImporter::read(std::size_t maxCount)
+{
+    std::vector<ImportedTrack> tracks;
+    if(not isOpen())
+    {
+        return tracks;
+    }
+
+    tracks.reserve(std::min<std::size_t>(maxCount, 4096));
+
+    switch(*format_)
+    {
+    case PlaylistExchangeFormat::M3u:
+        readM3u(tracks, maxCount);
+        break;
+    case PlaylistExchangeFormat::Pls:
+        readPls(tracks, maxCount);
+        break;
+    case PlaylistExchangeFormat::Xspf:
+        readXspf(tracks, maxCount);
+        break;
+    }
+
+    return tracks;
+}
+
+void PlaylistImporter::readM3u(std::vector<ImportedTrack> &tracks, std::size_t maxCount)
+{
+    QString line;
+    while(tracks.size() < maxCount and text_.readLineInto(&line))
+    {
+        const auto entry = QStringView{ line }.trimmed();
+        if(entry.isEmpty())
+        {
+            continue;
+        }
+
+        if(entry.startsWith(u'#'))
+        {
+            constexpr QStringView extInf{ u"#EXTINF:" };
+            if(entry.startsWith(extInf))
+            {
+                m3uHint_ = parseExtInf(entry.sliced(extInf.size()));
+            }
+
+            continue;
+        }
+
+        tracks.push_back(ImportedTrack{
+            resolveLocation(entry.toString(), directory_),
+            std::exchange(m3uHint_, std::nullopt),
+        });
+    }
+}
+
+void PlaylistImporter::readPls(std::vector<ImportedTrack> &tracks, std::size_t maxCount)
+{
+    QString line;
+    while(tracks.size() < maxCount and text_.readLineInto(&line))
+    {
+        // Section header, NumberOfEntries and Version are not needed
+        const auto separator = line.indexOf(u'=');
+        if(separator < 0)
+        {
+            continue;
+        }
+
+        const auto key = QStringView{ line }.first(separator).trimmed();
+        const auto value = QStringView{ line }.sliced(separator + 1).trimmed();
+
+        // Keys are FileN, TitleN and LengthN, usually grouped by N
+        auto nameSize = key.size();
+        while(nameSize > 0 and key[nameSize - 1].isDigit())
+        {
+            --nameSize;
+        }
+
+        bool isEntry{ false };
+        const auto index = key.sliced(nameSize).toInt(&isEntry);
+        if(not isEntry)
+        {
+            continue;
+        }
+
+        if(plsEntry_ and plsEntry_->index != index)
+        {
+            addPendingPlsEntry(tracks);
+        }
+
+        if(not plsEntry_)
+        {
+            plsEntry_ = PlsEntry{ index, {}, {}, std::nullopt };
+        }
+
+        const auto name = key.first(nameSize);
+        if(name.compare(u"File", Qt::CaseInsensitive) == 0)
+        {
+            plsEntry_->file = value.toString();
+        }
+        else if(name.compare(u"Title", Qt::CaseInsensitive) == 0)
+        {
+            plsEntry_->title = value.toString();
+        }
+        else if(name.compare(u"Length", Qt::CaseInsensitive) == 0)
+        {
+            // Streams have a length of -1
+            bool isLength{ false };
+            if(const auto length = value.toInt(&isLength); isLength and length >= 0)
+            {
+                plsEntry_->length = length;
+            }
+        }
+    }
+
+    if(tracks.size() < maxCount and text_.atEnd())
+    {
+        addPendingPlsEntry(tracks);
+    }
+}
+
+void PlaylistImporter::addPendingPlsEntry(std::vector<ImportedTrack> &tracks)
+{
+    auto entry = std::exchange(plsEntry_, std::nullopt);
+    if(not entry or entry->file.isEmpty())
+    {
+        return;
+    }
+
+    auto hint = entry->title.isEmpty() ? std::nullopt : std::optional{ createHint(entry->title, entry->length) };
+    tracks.push_back(ImportedTrack{ resolveLocation(std::move(entry->file), directory_), std::move(hint) });
+}
+
+void PlaylistImporter::readXspf(std::vector<ImportedTrack> &tracks, std::size_t maxCount)
+{
+    while(tracks.size() < maxCount and not xml_.atEnd())
+    {
+        if(xml_.readNext() == QXmlStreamReader::StartElement and xml_.name() == u"track")
+        {
+            if(auto track = readXspfTrack(); track)
+            {
+                tracks.push_back(std::move(*track));
+            }
+        }
+    }
+
+    if(xml_.hasError())
+    {
+        qWarning() << "Could not read playlist" << file_.fileName() << xml_.errorString();
+    }
+}
+
+std::optional<ImportedTrack> PlaylistImporter::readXspfTrack()
+{
+    QString location, title, creator, album;
+    int trackNumber{ 0 };
+    std::optional<int> durationMs;
+
+    while(xml_.readNextStartElement())
+    {
+        const auto name = xml_.name().toString();
+
+        if(name == "location" and location.isEmpty())
+        {
+            location = xml_.readElementText().trimmed();
+        }
+        else if(name == "title")
+        {
+            title = xml_.readElementText().trimmed();
+        }
+        else if(name == "creator")
+        {
+            creator = xml_.readElementText().trimmed();
+        }
+        else if(name == "album")
+        {
+            album = xml_.readElementText().trimmed();
+        }
+        else if(name == "trackNum")
+        {
+            trackNumber = xml_.readElementText().trimmed().toInt();
+        }
+        else if(name == "duration")
+        {
+            bool isDuration{ false };
+            if(const auto duration = xml_.readElementText().trimmed().toInt(&isDuration); isDuration)
+            {
+                durationMs = duration;
+            }
+        }
+        else
+        {
+            xml_.skipCurrentElement();
+        }
+    }
+
+    if(location.isEmpty())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<AudioMetaData> hint;
+    if(not title.isEmpty())
+    {
+        const auto seconds = std::chrono::seconds{ std::max(0, durationMs.value_or(0) / 1000) };
+        hint = AudioMetaData{ title, creator, album, 0, trackNumber, seconds };
+    }
+
+    return ImportedTrack{ resolveUri(location, directory_), std::move(hint) };
+}
+
+bool exportPlaylist(const QString &filepath,
+    PlaylistExchangeFormat format,
+    const std::vector<StoredTrack> &tracks)
+{
+    const auto openMode = format == PlaylistExchangeFormat::Xspf ? QIODevice::WriteOnly
+                                                                 : QIODevice::WriteOnly | QIODevice::Text;
+
+    QSaveFile file{ filepath };
+    if(not file.open(openMode))
+    {
+        return false;
+    }
+
+    bool written{ false };
+    if(format == PlaylistExchangeFormat::Xspf)
+    {
+        written = writeXspf(file, tracks);
+    }
+    else
+    {
+        QTextStream out{ &file };
+        format == PlaylistExchangeFormat::M3u ? writeM3u(out, tracks) : writePls(out, tracks);
+
+        out.flush();
+        written = out.status() == QTextStream::Ok;
+    }
+
+    if(not written)
+    {
+        file.cancelWriting();
+    }
+
+    return file.commit();
+}
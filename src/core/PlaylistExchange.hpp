@@ -0,0 +1,77 @@
+#pragma once
+
+#include "AudioMetaData.hpp"
+#include "StoredTrack.hpp"
+#include "TrackLocation.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QString>
+#include <QTextStream>
+#include <QXmlStreamReader>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// Playlist formats of other players, used for import and export only
+enum class PlaylistExchangeFormat
+{
+    M3u,
+    Pls,
+    Xspf,
+};
+
+// Format by file extension: m3u, m3u8, pls or xspf
+[[nodiscard]] std::optional<PlaylistExchangeFormat> getPlaylistExchangeFormat(const QString &filepath);
+
+struct ImportedTrack
+{
+    TrackLocation location;
+    // Title, artist and duration given by the playlist, e.g. by #EXTINF
+    std::optional<AudioMetaData> hint;
+};
+
+// Reads a playlist incrementally, memory use does not depend on its size.
+// Relative paths are resolved against the directory of the playlist.
+class PlaylistImporter final
+{
+public:
+    explicit PlaylistImporter(const QString &filepath);
+
+    bool isOpen() const;
+
+    // Returns at most maxCount tracks, empty once the whole playlist is read
+    std::vector<ImportedTrack> read(std::size_t maxCount);
+
+private:
+    void readM3u(std::vector<ImportedTrack> &, std::size_t maxCount);
+    void readPls(std::vector<ImportedTrack> &, std::size_t maxCount);
+    void readXspf(std::vector<ImportedTrack> &, std::size_t maxCount);
+    std::optional<ImportedTrack> readXspfTrack();
+
+    void addPendingPlsEntry(std::vector<ImportedTrack> &);
+
+    struct PlsEntry
+    {
+        int index;
+        QString file;
+        QString title;
+        std::optional<int> length;
+    };
+
+private:
+    std::optional<PlaylistExchangeFormat> format_;
+    QDir directory_;
+    QFile file_;
+    QTextStream text_;
+    QXmlStreamReader xml_;
+
+    std::optional<AudioMetaData> m3uHint_;
+    std::optional<PlsEntry> plsEntry_;
+};
+
+// Writes the playlist as it goes, without building the whole document in memory
+[[nodiscard]] bool exportPlaylist(const QString &filepath,
+    PlaylistExchangeFormat format,
+    const std::vector<StoredTrack> &tracks);
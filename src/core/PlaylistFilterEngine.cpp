@@ -0,0 +1,182 @@
+#include "PlaylistFilterEngine.hpp"
+
+#include "Playlist.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+// Tracks checked between cancellation checks and the granularity of published chunks
+constexpr std::size_t blockSize{ 8192 };
+} // namespace
+
+struct PlaylistFilterEngine::Job
+{
+    Generation generation;
+    std::shared_ptr<const PlaylistFilterSnapshot> snapshot;
+    FilterQuery query;
+    std::optional<std::vector<std::size_t>> candidates;
+
+    std::size_t trackCount;
+    std::size_t blockCount;
+    std::atomic<std::size_t> nextBlock{ 0 };
+
+    std::mutex publishMutex;
+    std::vector<std::optional<std::vector<std::size_t>>> blockMatches;
+    std::size_t nextPublishedBlock{ 0 };
+};
+
+PlaylistFilterEngine::PlaylistFilterEngine(ResultCallback callback)
+: callback_{ std::move(callback) }
+{
+}
+
+PlaylistFilterEngine::~PlaylistFilterEngine()
+{
+    cancel();
+    threadPool_.waitForDone();
+}
+
+std::shared_ptr<const PlaylistFilterSnapshot> PlaylistFilterEngine::createSnapshot(
+    const std::vector<PlaylistTrack> &tracks)
+{
+    return createSnapshot(tracks, 0, tracks.size());
+}
+
+std::shared_ptr<const PlaylistFilterSnapshot> PlaylistFilterEngine::createSnapshot(
+    const std::vector<PlaylistTrack> &tracks, std::size_t first, std::size_t count)
+{
+    first = std::min(first, tracks.size());
+    const auto last = first + std::min(count, tracks.size() - first);
+
+    auto snapshot = std::make_shared<PlaylistFilterSnapshot>();
+    snapshot->reserve(last - first);
+
+    for(auto index = first; index < last; ++index)
+    {
+        const auto &track = tracks[index];
+        if(const auto *record = track.audioMetaData.getRecord())
+        {
+            snapshot->push_back(PlaylistFilterEntry{ track.path, record->values });
+            continue;
+        }
+
+        auto searchKey = FilterQuery::createSearchKey(track.path, std::nullopt);
+        snapshot->push_back(PlaylistFilterEntry{ track.path,
+            std::make_shared<const MetaDataValues>(MetaDataValues{ std::nullopt, std::move(searchKey) }) });
+    }
+
+    return snapshot;
+}
+
+PlaylistFilterEngine::Generation PlaylistFilterEngine::filter(
+    std::shared_ptr<const PlaylistFilterSnapshot> snapshot, FilterQuery query)
+{
+    return start(std::move(snapshot), std::move(query), std::nullopt);
+}
+
+PlaylistFilterEngine::Generation PlaylistFilterEngine::filter(
+    std::shared_ptr<const PlaylistFilterSnapshot> snapshot,
+    FilterQuery query,
+    std::vector<std::size_t> candidates)
+{
+    return start(std::move(snapshot), std::move(query), std::move(candidates));
+}
+
+void PlaylistFilterEngine::cancel()
+{
+    ++generation_;
+}
+
+bool PlaylistFilterEngine::isCurrent(Generation generation) const
+{
+    return generation == generation_.load(std::memory_order_relaxed);
+}
+
+void PlaylistFilterEngine::waitForDone()
+{
+    threadPool_.waitForDone();
+}
+
+PlaylistFilterEngine::Generation PlaylistFilterEngine::start(
+    std::shared_ptr<const PlaylistFilterSnapshot> snapshot,
+    FilterQuery query,
+    std::optional<std::vector<std::size_t>> candidates)
+{
+    auto job = std::make_shared<Job>();
+    job->generation = ++generation_;
+    job->snapshot = std::move(snapshot);
+    job->query = std::move(query);
+    job->candidates = std::move(candidates);
+
+    // An empty job still has a single block to report that it finished
+    job->trackCount = job->candidates ? job->candidates->size() : job->snapshot->size();
+    job->blockCount = std::max<std::size_t>(1, (job->trackCount + blockSize - 1) / blockSize);
+    job->blockMatches.resize(job->blockCount);
+
+    const auto workerCount = std::min<std::size_t>(
+        job->blockCount, static_cast<std::size_t>(std::max(1, threadPool_.maxThreadCount())));
+
+    for(std::size_t i = 0; i < workerCount; ++i)
+    {
+        threadPool_.start([this, job]() { run(*job); });
+    }
+
+    return job->generation;
+}
+
+void PlaylistFilterEngine::run(Job &job)
+{
+    // Matches are memoized inside of the query, every worker needs its own
+    const auto query = job.query;
+    const auto &snapshot = *job.snapshot;
+
+    for(auto block = job.nextBlock++; block < job.blockCount; block = job.nextBlock++)
+    {
+        if(not isCurrent(job.generation))
+        {
+            return;
+        }
+
+        const auto first = block * blockSize;
+        const auto last = std::min(first + blockSize, job.trackCount);
+
+        std::vector<std::size_t> matches;
+        for(auto i = first; i < last; ++i)
+        {
+            const auto trackIndex = job.candidates ? (*job.candidates)[i] : i;
+            const auto &entry = snapshot[trackIndex];
+
+            if(query.matches(entry.path, entry.values.get()))
+            {
+                matches.push_back(trackIndex);
+            }
+        }
+
+        publish(job, block, std::move(matches));
+    }
+}
+
+void PlaylistFilterEngine::publish(Job &job, std::size_t block, std::vector<std::size_t> matches)
+{
+    std::lock_guard lock{ job.publishMutex };
+    job.blockMatches[block] = std::move(matches);
+
+    // Blocks finish out of order, only the completed prefix can be published
+    std::vector<std::size_t> chunk;
+    while(job.nextPublishedBlock < job.blockCount and job.blockMatches[job.nextPublishedBlock])
+    {
+        auto &blockMatches = job.blockMatches[job.nextPublishedBlock];
+        chunk.insert(chunk.end(), blockMatches->cbegin(), blockMatches->cend());
+        blockMatches->clear();
+        blockMatches->shrink_to_fit();
+        ++job.nextPublishedBlock;
+    }
+
+    const auto finished = job.nextPublishedBlock == job.blockCount;
+    if((not chunk.empty() or finished) and isCurrent(job.generation))
+    {
+        callback_(job.generation, std::move(chunk), finished);
+    }
+}
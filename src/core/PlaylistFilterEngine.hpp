@@ -0,0 +1,82 @@
+#pragma once
+
+#include "FilterQuery.hpp"
+#include "MetaDataHandle.hpp"
+#include "TrackPath.hpp"
+
+#include <QThreadPool>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct PlaylistTrack;
+
+// Everything filtering reads from a playlist track. Metadata values are immutable and shared
+// with the record, updates made on the GUI thread replace them without touching the snapshot.
+struct PlaylistFilterEntry
+{
+    TrackPath path;
+    std::shared_ptr<const MetaDataValues> values;
+};
+
+using PlaylistFilterSnapshot = std::vector<PlaylistFilterEntry>;
+
+// Filters immutable playlist snapshots on a thread pool.
+// Starting a query cancels the previous one, results are streamed in chunks.
+class PlaylistFilterEngine final
+{
+public:
+    using Generation = std::uint64_t;
+
+    // Called from worker threads with ascending track indexes.
+    // Chunks of a query are delivered in order, the last one is marked as finished.
+    using ResultCallback =
+        std::function<void(Generation, std::vector<std::size_t> matches, bool finished)>;
+
+    explicit PlaylistFilterEngine(ResultCallback callback);
+    ~PlaylistFilterEngine();
+
+    PlaylistFilterEngine(const PlaylistFilterEngine &) = delete;
+    PlaylistFilterEngine &operator=(const PlaylistFilterEngine &) = delete;
+
+    static std::shared_ptr<const PlaylistFilterSnapshot> createSnapshot(
+        const std::vector<PlaylistTrack> &tracks);
+
+    // Snapshot of tracks in range [first, first + count), matches are relative to the first one.
+    // Used to filter tracks inserted into a playlist without copying the rest of it.
+    static std::shared_ptr<const PlaylistFilterSnapshot> createSnapshot(
+        const std::vector<PlaylistTrack> &tracks, std::size_t first, std::size_t count);
+
+    Generation filter(std::shared_ptr<const PlaylistFilterSnapshot> snapshot, FilterQuery query);
+
+    // Checks only the candidate tracks, used when the query refines previous results
+    Generation filter(std::shared_ptr<const PlaylistFilterSnapshot> snapshot,
+        FilterQuery query,
+        std::vector<std::size_t> candidates);
+
+    void cancel();
+    bool isCurrent(Generation generation) const;
+
+    void waitForDone();
+
+private:
+    struct Job;
+
+    Generation start(std::shared_ptr<const PlaylistFilterSnapshot> snapshot,
+        FilterQuery query,
+        std::optional<std::vector<std::size_t>> candidates);
+
+    void run(Job &job);
+    void publish(Job &job, std::size_t block, std::vector<std::size_t> matches);
+
+private:
+    ResultCallback callback_;
+    std::atomic<Generation> generation_{ 0 };
+
+    // Destroyed first so no task outlives the members above
+    QThreadPool threadPool_;
+};
@@ -0,0 +1,223 @@
+#include "PlaylistJournal.hpp"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include <algorithm>
+#include <optional>
+
+namespace
+{
+constexpr quint32 journalMagic{ 0x504c4a31 }; // PLJ1
+constexpr auto streamVersion{ QDataStream::Qt_6_0 };
+
+enum class RecordType : quint8
+{
+    Insertion = 1,
+    Removal = 2,
+    Move = 3,
+};
+
+QByteArray getContentDigest(const QByteArray &content)
+{
+    return QCryptographicHash::hash(content, QCryptographicHash::Md5);
+}
+
+// Every record is length prefixed so that a torn write at the end can be detected
+QByteArray serialize(const PlaylistChange &change)
+{
+    QByteArray record;
+    QDataStream stream{ &record, QIODevice::WriteOnly };
+    stream.setVersion(streamVersion);
+
+    if(const auto *insertion = std::get_if<PlaylistInsertion>(&change))
+    {
+        stream << static_cast<quint8>(RecordType::Insertion) << static_cast<quint64>(insertion->position)
+               << static_cast<quint64>(insertion->tracks.size());
+
+        for(const auto &track : insertion->tracks)
+        {
+            stream << track.toString().toUtf8();
+        }
+    }
+    else if(const auto *removal = std::get_if<PlaylistRemoval>(&change))
+    {
+        stream << static_cast<quint8>(RecordType::Removal) << static_cast<quint64>(removal->first)
+               << static_cast<quint64>(removal->count);
+    }
+    else if(const auto *move = std::get_if<PlaylistMove>(&change))
+    {
+        stream << static_cast<quint8>(RecordType::Move) << static_cast<quint64>(move->moveToIndex)
+               << static_cast<quint64>(move->indexes.size());
+
+        for(const auto index : move->indexes)
+        {
+            stream << static_cast<quint64>(index);
+        }
+    }
+
+    return record;
+}
+
+// Returns nullopt when the record is malformed
+std::optional<PlaylistChange> deserialize(const QByteArray &record)
+{
+    QDataStream stream{ record };
+    stream.setVersion(streamVersion);
+
+    quint8 type{ 0 };
+    quint64 first{ 0 }, count{ 0 };
+    stream >> type >> first >> count;
+
+    if(stream.status() != QDataStream::Ok)
+    {
+        return std::nullopt;
+    }
+
+    switch(static_cast<RecordType>(type))
+    {
+    case RecordType::Insertion:
+    {
+        PlaylistInsertion insertion{ first, {} };
+        insertion.tracks.reserve(count);
+
+        for(quint64 i = 0; i < count and stream.status() == QDataStream::Ok; ++i)
+        {
+            QByteArray path;
+            stream >> path;
+            insertion.tracks.emplace_back(QString::fromUtf8(path));
+        }
+
+        if(stream.status() != QDataStream::Ok) return std::nullopt;
+        return insertion;
+    }
+    case RecordType::Removal:
+        return PlaylistRemoval{ first, count };
+    case RecordType::Move:
+    {
+        PlaylistMove move{ {}, first };
+        move.indexes.reserve(count);
+
+        for(quint64 i = 0; i < count and stream.status() == QDataStream::Ok; ++i)
+        {
+            quint64 index{ 0 };
+            stream >> index;
+            move.indexes.push_back(index);
+        }
+
+        if(stream.status() != QDataStream::Ok) return std::nullopt;
+        return move;
+    }
+    }
+
+    return std::nullopt;
+}
+} // namespace
+
+QString getPlaylistJournalPath(const QString &playlistPath)
+{
+    // Hidden so that it is not picked up as a playlist
+    const QFileInfo playlistFileInfo{ playlistPath };
+    return playlistFileInfo.absolutePath() + "/." + playlistFileInfo.fileName() + ".journal";
+}
+
+bool appendPlaylistJournal(const QString &playlistPath, const std::vector<PlaylistChange> &changes)
+{
+    QFile journal{ getPlaylistJournalPath(playlistPath) };
+    if(not journal.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        return false;
+    }
+
+    QDataStream stream{ &journal };
+    stream.setVersion(streamVersion);
+
+    if(journal.size() == 0)
+    {
+        QFile playlistFile{ playlistPath };
+        const auto content = playlistFile.open(QIODevice::ReadOnly) ? playlistFile.readAll() : QByteArray{};
+        stream << journalMagic << getContentDigest(content);
+    }
+
+    for(const auto &change : changes)
+    {
+        if(std::holds_alternative<PlaylistReset>(change))
+        {
+            qWarning() << "Playlist reset cannot be journaled";
+            return false;
+        }
+
+        stream << serialize(change);
+    }
+
+    return stream.status() == QDataStream::Ok and journal.flush();
+}
+
+PlaylistJournal readPlaylistJournal(const QString &playlistPath, const QByteArray &playlistContent)
+{
+    QFile journal{ getPlaylistJournalPath(playlistPath) };
+    if(not journal.open(QIODevice::ReadOnly))
+    {
+        // Missing journal is started by the next append
+        return { {}, not journal.exists() };
+    }
+
+    QDataStream stream{ &journal };
+    stream.setVersion(streamVersion);
+
+    quint32 magic{ 0 };
+    QByteArray digest;
+    stream >> magic >> digest;
+
+    if(magic != journalMagic or digest != getContentDigest(playlistContent))
+    {
+        qDebug() << "Ignoring stale playlist journal" << journal.fileName();
+        return { {}, false };
+    }
+
+    PlaylistJournal result;
+    auto goodSize = journal.pos();
+
+    while(not stream.atEnd())
+    {
+        QByteArray record;
+        stream >> record;
+
+        auto change = stream.status() == QDataStream::Ok ? deserialize(record) : std::nullopt;
+        if(not change)
+        {
+            qWarning() << "Playlist journal" << journal.fileName() << "is truncated";
+
+            journal.close();
+            if(not QFile::resize(journal.fileName(), goodSize))
+            {
+                qWarning() << "Failed to cut torn record off" << journal.fileName();
+                result.isAppendable = false;
+            }
+            break;
+        }
+
+        result.changes.push_back(std::move(*change));
+        goodSize = journal.pos();
+    }
+
+    return result;
+}
+
+std::size_t getJournalEntryCount(const PlaylistChange &change)
+{
+    if(const auto *insertion = std::get_if<PlaylistInsertion>(&change))
+    {
+        return std::max<std::size_t>(1, insertion->tracks.size());
+    }
+
+    if(const auto *move = std::get_if<PlaylistMove>(&change))
+    {
+        return std::max<std::size_t>(1, move->indexes.size());
+    }
+
+    return 1;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "PlaylistChange.hpp"
+#include "TrackIndexMapping.hpp"
+
+#include <QByteArray>
+#include <QString>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+// Append-only log of playlist changes stored next to the playlist file.
+// The journal is bound to the content of the playlist file it was started for,
+// a journal left behind by an interrupted compaction is ignored.
+
+[[nodiscard]] QString getPlaylistJournalPath(const QString &playlistPath);
+
+[[nodiscard]] bool appendPlaylistJournal(const QString &playlistPath, const std::vector<PlaylistChange> &changes);
+
+struct PlaylistJournal
+{
+    std::vector<PlaylistChange> changes;
+
+    // Whether further changes can be appended, otherwise the playlist has to be written in full
+    bool isAppendable{ true };
+};
+
+// Changes journaled for the given playlist file content, empty when the journal is stale.
+// A torn record at the end is cut off the file so that appended records follow the last good one.
+[[nodiscard]] PlaylistJournal readPlaylistJournal(const QString &playlistPath, const QByteArray &playlistContent);
+
+// Number of journal entries a change takes, used to decide when to compact
+[[nodiscard]] std::size_t getJournalEntryCount(const PlaylistChange &change);
+
+// Applies journaled changes to elements read from the playlist file, returns the number of entries
+// or nullopt when the journal cannot be appended to. Inserted tracks are converted with
+// createElement(const TrackPath &).
+template<typename T, typename CreateElement>
+std::optional<std::size_t> replayPlaylistJournal(const QString &playlistPath,
+    const QByteArray &playlistContent,
+    std::vector<T> &elements,
+    CreateElement createElement)
+{
+    const auto journal = readPlaylistJournal(playlistPath, playlistContent);
+
+    std::size_t entries{ 0 };
+    for(const auto &change : journal.changes)
+    {
+        if(const auto *insertion = std::get_if<PlaylistInsertion>(&change))
+        {
+            std::vector<T> inserted;
+            inserted.reserve(insertion->tracks.size());
+
+            for(const auto &track : insertion->tracks)
+            {
+                inserted.push_back(createElement(track));
+            }
+
+            const auto position = std::min(insertion->position, elements.size());
+            elements.insert(elements.begin() + position, std::make_move_iterator(inserted.begin()),
+                std::make_move_iterator(inserted.end()));
+        }
+        else if(const auto *removal = std::get_if<PlaylistRemoval>(&change))
+        {
+            const auto begin = std::min(removal->first, elements.size());
+            const auto end = begin + std::min(removal->count, elements.size() - begin);
+            elements.erase(elements.begin() + begin, elements.begin() + end);
+        }
+        else if(const auto *move = std::get_if<PlaylistMove>(&change))
+        {
+            moveElements(elements, move->indexes, move->moveToIndex);
+        }
+
+        entries += getJournalEntryCount(change);
+    }
+
+    if(not journal.isAppendable)
+    {
+        return std::nullopt;
+    }
+
+    return entries;
+}
@@ -2,12 +2,15 @@
 
 #include "FileUtilities.hpp"
 #include "IPlaylistIO.hpp"
+#include "PlaylistManifest.hpp"
 
 #include <QDebug>
 #include <QDir>
 #include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace
@@ -26,36 +29,171 @@ PlaylistManager::PlaylistManager(IPlaylistIO &playlistIO, const QString &playlis
 : playlistIO_{ playlistIO }
 , playlistDirectory_{ playlistDirectory }
 {
-    loadFromDirectory();
+    listDirectory();
 
-    if(playlists_.size() == 0)
+    if(pending_.empty())
     {
         create("Default");
     }
 }
 
+std::vector<PlaylistInfo> PlaylistManager::getPlaylistInfos() const
+{
+    std::vector<PlaylistInfo> infos;
+    infos.reserve(playlists_.size() + pending_.size());
+
+    for(const auto &[id, playlist] : playlists_)
+    {
+        infos.push_back(PlaylistInfo{ id, playlist.getName(), playlist.getTrackCount(), true });
+    }
+
+    for(const auto &pending : pending_)
+    {
+        infos.push_back(PlaylistInfo{ pending.id, pending.name, pending.trackCount, false });
+    }
+
+    std::sort(infos.begin(), infos.end(),
+        [](const auto &l, const auto &r) { return l.id.value < r.id.value; });
+
+    return infos;
+}
+
+std::optional<PlaylistId> PlaylistManager::findByName(const QString &name) const
+{
+    for(const auto &[id, playlist] : playlists_)
+    {
+        if(playlist.getName() == name)
+        {
+            return id;
+        }
+    }
+
+    for(const auto &pending : pending_)
+    {
+        if(pending.name == name)
+        {
+            return pending.id;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<PlaylistId> PlaylistManager::loadNext()
+{
+    while(not pending_.empty())
+    {
+        auto pending = std::move(pending_.front());
+        pending_.erase(pending_.begin());
+
+        if(const auto id = load(std::move(pending)); id)
+        {
+            return id;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void PlaylistManager::loadAll()
+{
+    if(pending_.empty())
+    {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<QString> filepaths;
+    filepaths.reserve(pending_.size());
+
+    for(const auto &pending : pending_)
+    {
+        filepaths.push_back(pending.path);
+    }
+
+    auto playlists = playlistIO_.loadAll(filepaths);
+
+    // Pending playlists are sorted by id, playlists are added in the same order on every load
+    std::size_t trackCount{ 0 };
+    for(std::size_t i = 0; i < std::min(playlists.size(), pending_.size()); ++i)
+    {
+        if(auto &playlist = playlists[i]; playlist)
+        {
+            trackCount += playlist->getTrackCount();
+            emplace(pending_[i].id, std::move(*playlist));
+        }
+    }
+
+    const auto elapsed = timer.elapsed();
+    qDebug() << pending_.size() << "playlists with" << trackCount << "tracks read in" << elapsed << "ms";
+
+    pending_.clear();
+}
+
+bool PlaylistManager::saveManifest()
+{
+    std::vector<std::pair<QString, std::size_t>> trackCounts;
+
+    for(const auto &[id, playlist] : playlists_)
+    {
+        trackCounts.emplace_back(playlist.getPath(), playlist.getTrackCount());
+    }
+
+    for(const auto &pending : pending_)
+    {
+        if(pending.trackCount)
+        {
+            trackCounts.emplace_back(pending.path, *pending.trackCount);
+        }
+    }
+
+    return writePlaylistManifest(playlistDirectory_, trackCounts);
+}
+
 std::optional<PlaylistId> PlaylistManager::add(const QString &filepath)
+{
+    return load(PendingPlaylist{
+        PlaylistId{ lastPlaylistIndex_++ }, QFileInfo{ filepath }.completeBaseName(), filepath, std::nullopt });
+}
+
+std::optional<PlaylistId> PlaylistManager::load(PendingPlaylist pending)
 try
 {
     QElapsedTimer timer;
     timer.start();
 
-    auto playlist = playlistIO_.load(filepath);
+    auto playlist = playlistIO_.load(pending.path);
 
     const auto elapsed = timer.elapsed();
     qDebug() << "Playlist" << playlist.getName() << "with" << playlist.getTrackCount()
              << "tracks read in" << elapsed << "ms";
 
-    const auto newPlaylistIndex = PlaylistId{ lastPlaylistIndex_++ };
-    playlist.setPlaylistId(newPlaylistIndex);
-    playlists_.emplace(newPlaylistIndex, std::move(playlist));
-    return newPlaylistIndex;
+    emplace(pending.id, std::move(playlist));
+    return pending.id;
 }
 catch(const std::runtime_error &)
 {
     return std::nullopt;
 }
 
+Playlist &PlaylistManager::emplace(PlaylistId id, Playlist playlist)
+{
+    playlist.setPlaylistId(id);
+    playlist.trackIndex_ = &trackIndex_;
+
+    auto &added = playlists_.emplace(id, std::move(playlist)).first->second;
+    trackIndex_.add(added);
+    return added;
+}
+
+std::vector<PlaylistManager::PendingPlaylist>::iterator PlaylistManager::findPending(PlaylistId id)
+{
+    return std::find_if(
+        pending_.begin(), pending_.end(), [id](const auto &pending) { return pending.id == id; });
+}
+
 std::optional<PlaylistId> PlaylistManager::create(const QString &name)
 {
     const auto filepath = createPlaylistFile(name);
@@ -66,29 +204,86 @@ std::optional<PlaylistId> PlaylistManager::create(const QString &name)
     return add(filepath);
 }
 
+std::optional<PlaylistId> PlaylistManager::createAutoPlaylist(const QString &name,
+    const AutoPlaylistQuery &query)
+{
+    const auto filepath = createPlaylistFile(name);
+    if(filepath.isEmpty())
+    {
+        return std::nullopt;
+    }
+
+    const auto content = serializeAutoPlaylistQuery(query);
+
+    QFile playlistFile{ filepath };
+    if(not playlistFile.open(QIODevice::WriteOnly | QIODevice::Truncate) or
+        playlistFile.write(content) != content.size())
+    {
+        playlistFile.remove();
+        return std::nullopt;
+    }
+
+    playlistFile.close();
+    return add(filepath);
+}
+
+std::optional<PlaylistId> PlaylistManager::importPlaylist(const QString &filepath)
+{
+    auto tracks = playlistIO_.importTracks(filepath);
+    if(not tracks)
+    {
+        return std::nullopt;
+    }
+
+    const auto playlistPath = createPlaylistFile(QFileInfo{ filepath }.completeBaseName());
+    if(playlistPath.isEmpty())
+    {
+        return std::nullopt;
+    }
+
+    const auto playlistName = QFileInfo{ playlistPath }.completeBaseName();
+    Playlist playlist{ playlistName, playlistPath, std::move(*tracks), playlistIO_ };
+
+    const auto newPlaylistIndex = PlaylistId{ lastPlaylistIndex_++ };
+
+    // Saved once it is in place, pending saves refer to the playlist
+    const auto &added = emplace(newPlaylistIndex, std::move(playlist));
+    playlistIO_.save(added, PlaylistReset{});
+    return newPlaylistIndex;
+}
+
+bool PlaylistManager::exportPlaylist(PlaylistId id, const QString &filepath)
+{
+    const auto *playlist = get(id);
+    return playlist and playlistIO_.exportTracks(*playlist, filepath);
+}
+
 void PlaylistManager::removeById(PlaylistId id)
 {
+    if(const auto pending = findPending(id); pending != pending_.end())
+    {
+        // File is removed without being loaded
+        playlistIO_.remove(Playlist{ pending->name, pending->path, playlistIO_ });
+        pending_.erase(pending);
+        return;
+    }
+
     auto it = playlists_.find(id);
     if(it == playlists_.end())
     {
         return;
     }
 
-    QFile::remove(it->second.getPath());
+    playlistIO_.remove(it->second);
+    trackIndex_.remove(id);
     playlists_.erase(id);
 }
 
 void PlaylistManager::removeByName(const QString &name)
 {
-    for(const auto &[key, playlist] : playlists_)
+    if(const auto id = findByName(name); id)
     {
-        if(playlist.getName() == name)
-        {
-            const auto &playlistPath = playlist.getPath();
-            QFile::remove(playlistPath);
-            playlists_.erase(key);
-            return;
-        }
+        removeById(*id);
     }
 }
 
@@ -111,11 +306,35 @@ bool PlaylistManager::rename(PlaylistId id, const QString &newName)
 
 Playlist *PlaylistManager::get(PlaylistId id)
 {
-    auto it = playlists_.find(id);
-    return it != playlists_.end() ? &it->second : nullptr;
+    if(auto it = playlists_.find(id); it != playlists_.end())
+    {
+        return &it->second;
+    }
+
+    const auto pending = findPending(id);
+    if(pending == pending_.end())
+    {
+        return nullptr;
+    }
+
+    auto loading = std::move(*pending);
+    pending_.erase(pending);
+
+    return load(std::move(loading)) ? &playlists_.at(id) : nullptr;
+}
+
+const PlaylistTrackIndex &PlaylistManager::getTrackIndex() const
+{
+    return trackIndex_;
 }
 
 PlaylistManager::PlaylistContainer &PlaylistManager::getAll()
+{
+    loadAll();
+    return playlists_;
+}
+
+PlaylistManager::PlaylistContainer &PlaylistManager::getLoaded()
 {
     return playlists_;
 }
@@ -136,19 +355,24 @@ QString PlaylistManager::createPlaylistFile(const QString &playlistName)
     return playlistFile.fileName();
 }
 
-void PlaylistManager::loadFromDirectory()
+void PlaylistManager::listDirectory()
 {
     const auto playlists = ensureExists(playlistDirectory_).entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-    qDebug() << "Playlist files found:" << playlists.count();
-
-    QElapsedTimer timer;
-    timer.start();
+    const auto trackCounts = readPlaylistManifest(playlistDirectory_);
 
     for(const auto &entry : playlists)
     {
-        add(entry.absoluteFilePath());
+        const auto path = entry.absoluteFilePath();
+        const auto trackCount = trackCounts.find(path);
+
+        pending_.push_back(PendingPlaylist{
+            PlaylistId{ lastPlaylistIndex_++ },
+            entry.completeBaseName(),
+            path,
+            trackCount != trackCounts.end() ? std::optional{ trackCount->second } : std::nullopt,
+        });
     }
 
-    const auto elapsed = timer.elapsed();
-    qDebug() << "Loaded playlists in" << elapsed << "ms";
+    qDebug() << "Playlist files found:" << playlists.count() << "with" << trackCounts.size()
+             << "known track counts";
 }
@@ -1,15 +1,29 @@
 #pragma once
 
 #include "Playlist.hpp"
+#include "PlaylistTrackIndex.hpp"
 
 #include <QDir>
 #include <QString>
 
+#include <cstddef>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 class IPlaylistIO;
 
+struct PlaylistInfo
+{
+    PlaylistId id;
+    QString name;
+    // Known once the playlist is loaded, before that taken from the manifest if it is up to date
+    std::optional<std::size_t> trackCount;
+    bool isLoaded;
+};
+
+// Playlists of the directory are only listed on construction, each one is loaded
+// on first access, by loadNext() or loadAll(), so startup does not depend on their number and size
 class PlaylistManager final
 {
 public:
@@ -17,25 +31,66 @@ public:
 
     PlaylistManager(IPlaylistIO &, const QString &playlistDirectory);
 
+    // Ordered by id, i.e. by file name for playlists found on construction
+    std::vector<PlaylistInfo> getPlaylistInfos() const;
+    std::optional<PlaylistId> findByName(const QString &name) const;
+
+    // Loads one of the playlists not accessed yet, nullopt once all of them are loaded
+    std::optional<PlaylistId> loadNext();
+    // Loads all playlists not accessed yet at once, unreadable ones are dropped
+    void loadAll();
+
+    // Records track counts for the next startup, pending saves have to be flushed first
+    bool saveManifest();
+
     std::optional<PlaylistId> add(const QString &filepath);
     std::optional<PlaylistId> create(const QString &name);
+    // Playlist of the cached tracks matching the query, kept up to date by AutoPlaylistUpdater
+    std::optional<PlaylistId> createAutoPlaylist(const QString &name, const AutoPlaylistQuery &query);
+
+    // Creates a playlist from a playlist of another player (M3U, PLS, XSPF)
+    std::optional<PlaylistId> importPlaylist(const QString &filepath);
+    bool exportPlaylist(PlaylistId id, const QString &filepath);
 
     void removeById(PlaylistId id);
     void removeByName(const QString &name);
 
     bool rename(PlaylistId id, const QString &newName);
 
+    // Loads the playlist if needed, nullptr if it does not exist or cannot be read
     Playlist *get(PlaylistId id);
+
+    // Loads all playlists
     PlaylistContainer &getAll();
+    // Playlists loaded so far
+    PlaylistContainer &getLoaded();
+
+    // Tracks of loaded playlists only, pending ones are indexed once they are loaded
+    const PlaylistTrackIndex &getTrackIndex() const;
 
 private:
+    struct PendingPlaylist
+    {
+        PlaylistId id;
+        QString name;
+        QString path;
+        std::optional<std::size_t> trackCount;
+    };
+
+    std::optional<PlaylistId> load(PendingPlaylist pending);
+    Playlist &emplace(PlaylistId id, Playlist playlist);
+    std::vector<PendingPlaylist>::iterator findPending(PlaylistId id);
+
     QString createPlaylistPath(const QString &playlistName);
     QString createPlaylistFile(const QString &playlistName);
-    void loadFromDirectory();
+    void listDirectory();
 
 private:
     IPlaylistIO &playlistIO_;
     const QDir playlistDirectory_;
     decltype(PlaylistId::value) lastPlaylistIndex_{ 0 };
     PlaylistContainer playlists_;
+    PlaylistTrackIndex trackIndex_;
+    // Sorted by id
+    std::vector<PendingPlaylist> pending_;
 };
@@ -0,0 +1,90 @@
+#include "PlaylistManifest.hpp"
+
+#include "PlaylistJournal.hpp"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+
+namespace
+{
+constexpr auto manifestFileName{ ".manifest" };
+
+// Journal appends do not touch the playlist file, both are compared
+QString getFileState(const QFileInfo &playlistFileInfo)
+{
+    const QFileInfo journalFileInfo{ getPlaylistJournalPath(playlistFileInfo.absoluteFilePath()) };
+
+    return QString{ "%1\t%2\t%3" }
+        .arg(playlistFileInfo.size())
+        .arg(playlistFileInfo.lastModified().toMSecsSinceEpoch())
+        .arg(journalFileInfo.exists() ? journalFileInfo.size() : -1);
+}
+} // namespace
+
+QString getPlaylistManifestPath(const QDir &playlistDirectory)
+{
+    return playlistDirectory.absoluteFilePath(manifestFileName);
+}
+
+std::unordered_map<QString, std::size_t> readPlaylistManifest(const QDir &playlistDirectory)
+{
+    QFile manifestFile{ getPlaylistManifestPath(playlistDirectory) };
+    if(not manifestFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return {};
+    }
+
+    std::unordered_map<QString, std::size_t> trackCounts;
+
+    // Track count, file state and the file name last, as it can contain anything but a new line
+    QTextStream stream{ &manifestFile };
+    for(QString line; stream.readLineInto(&line);)
+    {
+        bool isCount{ false };
+        const auto trackCount = line.section('\t', 0, 0).toULongLong(&isCount);
+        const auto fileState = line.section('\t', 1, 3);
+        const auto fileName = line.section('\t', 4);
+
+        if(not isCount or fileName.isEmpty())
+        {
+            continue;
+        }
+
+        const QFileInfo playlistFileInfo{ playlistDirectory.absoluteFilePath(fileName) };
+        if(playlistFileInfo.isFile() and getFileState(playlistFileInfo) == fileState)
+        {
+            trackCounts.emplace(playlistFileInfo.absoluteFilePath(), static_cast<std::size_t>(trackCount));
+        }
+    }
+
+    return trackCounts;
+}
+
+bool writePlaylistManifest(const QDir &playlistDirectory,
+    const std::vector<std::pair<QString, std::size_t>> &trackCounts)
+{
+    QSaveFile manifestFile{ getPlaylistManifestPath(playlistDirectory) };
+    if(not manifestFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        return false;
+    }
+
+    QTextStream stream{ &manifestFile };
+    for(const auto &[filepath, trackCount] : trackCounts)
+    {
+        const QFileInfo playlistFileInfo{ filepath };
+        stream << trackCount << '\t' << getFileState(playlistFileInfo) << '\t'
+               << playlistFileInfo.fileName() << '\n';
+    }
+
+    stream.flush();
+    if(stream.status() != QTextStream::Ok)
+    {
+        manifestFile.cancelWriting();
+    }
+
+    return manifestFile.commit();
+}
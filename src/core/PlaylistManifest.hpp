@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QDir>
+#include <QString>
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Hidden file in the playlist directory, not listed as a playlist
+[[nodiscard]] QString getPlaylistManifestPath(const QDir &playlistDirectory);
+
+// Track counts of playlists from the previous session keyed by absolute file path.
+// Playlists modified since the manifest was written are left out.
+[[nodiscard]] std::unordered_map<QString, std::size_t> readPlaylistManifest(const QDir &playlistDirectory);
+
+// Records track counts of playlists together with the state of their files
+bool writePlaylistManifest(const QDir &playlistDirectory,
+    const std::vector<std::pair<QString, std::size_t>> &trackCounts);
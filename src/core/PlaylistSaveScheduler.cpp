@@ -0,0 +1,162 @@
+#include "PlaylistSaveScheduler.hpp"
+
+#include "Playlist.hpp"
+#include "PlaylistJournal.hpp"
+
+#include <QDebug>
+
+#include <algorithm>
+
+namespace
+{
+// Journal is compacted once replaying it costs a fraction of loading the playlist
+std::size_t getCompactionThreshold(std::size_t trackCount)
+{
+    constexpr std::size_t minimumEntries{ 4096 };
+    return std::max(minimumEntries, trackCount / 2);
+}
+} // namespace
+
+PlaylistSaveScheduler::PlaylistSaveScheduler(WriteFunction write,
+    AppendFunction append,
+    std::chrono::milliseconds delay)
+: write_{ std::move(write) }
+, append_{ std::move(append) }
+{
+    writer_.setMaxThreadCount(1);
+
+    timer_.setSingleShot(true);
+    timer_.setInterval(delay);
+    connect(&timer_, &QTimer::timeout, this, &PlaylistSaveScheduler::writePending);
+}
+
+PlaylistSaveScheduler::~PlaylistSaveScheduler()
+{
+    if(not pending_.empty())
+    {
+        qWarning() << pending_.size() << "playlists were not flushed before shutdown";
+    }
+
+    writer_.waitForDone();
+}
+
+void PlaylistSaveScheduler::schedule(const Playlist &playlist, PlaylistChange change)
+{
+    auto it = findPending(playlist);
+    if(it == pending_.end())
+    {
+        it = pending_.insert(pending_.end(), PendingSave{ &playlist, {} });
+    }
+
+    it->changes.push_back(std::move(change));
+
+    // Not restarted on later saves so that continuous editing still gets written
+    if(not timer_.isActive())
+    {
+        timer_.start();
+    }
+}
+
+void PlaylistSaveScheduler::cancel(const Playlist &playlist)
+{
+    if(const auto it = findPending(playlist); it != pending_.end())
+    {
+        pending_.erase(it);
+    }
+
+    journalSizes_.erase(playlist.getPath());
+    writer_.waitForDone();
+}
+
+void PlaylistSaveScheduler::compact(const Playlist &playlist)
+{
+    if(const auto it = findPending(playlist); it != pending_.end())
+    {
+        pending_.erase(it);
+    }
+
+    writeCompacted(playlist);
+    writer_.waitForDone();
+}
+
+void PlaylistSaveScheduler::flushAll()
+{
+    timer_.stop();
+    writePending();
+    writer_.waitForDone();
+}
+
+bool PlaylistSaveScheduler::isPending(const Playlist &playlist) const
+{
+    return std::any_of(pending_.cbegin(), pending_.cend(),
+        [&playlist](const auto &pendingSave) { return pendingSave.playlist == &playlist; });
+}
+
+void PlaylistSaveScheduler::setJournalSize(const QString &filepath, std::size_t entries)
+{
+    journalSizes_[filepath] = entries;
+}
+
+void PlaylistSaveScheduler::writePending()
+{
+    for(auto &pendingSave : pending_)
+    {
+        write(*pendingSave.playlist, std::move(pendingSave.changes));
+    }
+
+    pending_.clear();
+}
+
+void PlaylistSaveScheduler::write(const Playlist &playlist, std::vector<PlaylistChange> changes)
+{
+    const auto needsReset = std::any_of(changes.cbegin(), changes.cend(),
+        [](const auto &change) { return std::holds_alternative<PlaylistReset>(change); });
+
+    std::size_t entries{ 0 };
+    for(const auto &change : changes)
+    {
+        entries += getJournalEntryCount(change);
+    }
+
+    auto &journalSize = journalSizes_[playlist.getPath()];
+    if(needsReset or journalSize + entries > getCompactionThreshold(playlist.getTrackCount()))
+    {
+        writeCompacted(playlist);
+        return;
+    }
+
+    journalSize += entries;
+
+    writer_.start(
+        [this, filepath = playlist.getPath(), changes = std::move(changes)]()
+        {
+            if(not append_(filepath, changes))
+            {
+                qWarning() << "Could not append to playlist journal" << filepath;
+            }
+        });
+}
+
+void PlaylistSaveScheduler::writeCompacted(const Playlist &playlist)
+{
+    // Snapshot is taken on the owning thread, the writer only sees the copy
+    auto tracks = createStoredTracks(playlist.getTracks());
+
+    journalSizes_[playlist.getPath()] = 0;
+
+    writer_.start(
+        [this, filepath = playlist.getPath(), tracks = std::move(tracks)]()
+        {
+            if(not write_(filepath, tracks))
+            {
+                qWarning() << "Could not save playlist" << filepath;
+            }
+        });
+}
+
+std::vector<PlaylistSaveScheduler::PendingSave>::iterator PlaylistSaveScheduler::findPending(
+    const Playlist &playlist)
+{
+    return std::find_if(pending_.begin(), pending_.end(),
+        [&playlist](const auto &pendingSave) { return pendingSave.playlist == &playlist; });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "PlaylistChange.hpp"
+#include "StoredTrack.hpp"
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <QTimer>
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Playlist;
+
+// Coalesces saves of playlists and writes them on a background thread.
+// Changes are appended to a journal until it grows past a threshold, then the
+// whole playlist is written again (compacted).
+// Pending playlists are referenced, not copied, so they must be flushed
+// or cancelled before being destroyed.
+class PlaylistSaveScheduler final : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Called on the writer thread
+    using WriteFunction = std::function<bool(const QString &filepath, const std::vector<StoredTrack> &tracks)>;
+    using AppendFunction =
+        std::function<bool(const QString &filepath, const std::vector<PlaylistChange> &changes)>;
+
+    PlaylistSaveScheduler(WriteFunction write, AppendFunction append, std::chrono::milliseconds delay);
+    ~PlaylistSaveScheduler() override;
+
+    void schedule(const Playlist &, PlaylistChange change);
+
+    // Drops a pending save and waits until the playlist is no longer being written
+    void cancel(const Playlist &);
+
+    // Writes the whole playlist right away and waits until it is on disk
+    void compact(const Playlist &);
+    void flushAll();
+
+    bool isPending(const Playlist &) const;
+
+    // Entries already journaled for a playlist file, e.g. replayed when it was loaded
+    void setJournalSize(const QString &filepath, std::size_t entries);
+
+private:
+    struct PendingSave
+    {
+        const Playlist *playlist;
+        std::vector<PlaylistChange> changes;
+    };
+
+    void writePending();
+    void write(const Playlist &, std::vector<PlaylistChange> changes);
+    void writeCompacted(const Playlist &);
+
+    std::vector<PendingSave>::iterator findPending(const Playlist &);
+
+private:
+    WriteFunction write_;
+    AppendFunction append_;
+    QTimer timer_;
+    std::vector<PendingSave> pending_;
+    std::unordered_map<QString, std::size_t> journalSizes_;
+
+    // Single thread keeps writes of the same file in order
+    QThreadPool writer_;
+};
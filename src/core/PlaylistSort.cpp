@@ -0,0 +1,191 @@
+#include "PlaylistSort.hpp"
+
+#include "Playlist.hpp"
+
+#include <QCollator>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+namespace
+{
+// Smaller playlists are sorted on the calling thread only
+constexpr std::size_t parallelSortChunkSize{ 32 * 1024 };
+
+std::size_t getChunkCount(std::size_t count)
+{
+    const auto threadCount = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    return std::clamp<std::size_t>(count / parallelSortChunkSize, 1, threadCount);
+}
+
+std::size_t getChunkBound(std::size_t count, std::size_t chunk, std::size_t chunkCount)
+{
+    return count * chunk / chunkCount;
+}
+
+// Calls function(begin, end) for every chunk of [0, count), the first one on the calling thread
+template<typename Function>
+void forEachChunk(std::size_t count, std::size_t chunkCount, const Function &function)
+{
+    if(chunkCount <= 1)
+    {
+        function(std::size_t{ 0 }, count);
+        return;
+    }
+
+    QThreadPool threadPool;
+    for(std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        threadPool.start(
+            [&function, begin = getChunkBound(count, chunk, chunkCount),
+                end = getChunkBound(count, chunk + 1, chunkCount)]() { function(begin, end); });
+    }
+
+    function(std::size_t{ 0 }, getChunkBound(count, 1, chunkCount));
+    threadPool.waitForDone();
+}
+
+std::shared_ptr<const TrackSortKeys> createSortKeys(const QCollator &collator, const PlaylistTrack &track)
+{
+    const auto &metaData = track.audioMetaData;
+
+    // Same fallback as the title column, file name without the extension
+    const auto &fileName = track.path.getFileName();
+    const auto title = metaData and not metaData->title.isEmpty() ?
+                           metaData->title :
+                           fileName.left(fileName.lastIndexOf('.'));
+
+    return std::make_shared<const TrackSortKeys>(TrackSortKeys{
+        collator.sortKey(metaData ? metaData->artist : QString{}),
+        collator.sortKey(metaData ? metaData->albumName : QString{}),
+        collator.sortKey(title),
+        metaData ? metaData->discNumber : -1,
+        metaData ? metaData->trackNumber : -1,
+        metaData ? metaData->duration : std::chrono::seconds{ 0 },
+    });
+}
+
+template<typename T>
+int compareValues(const T &l, const T &r)
+{
+    return l < r ? -1 : (r < l ? 1 : 0);
+}
+
+int compareKeys(const TrackSortKeys &l, const TrackSortKeys &r, PlaylistSortKey key)
+{
+    switch(key)
+    {
+    case PlaylistSortKey::Artist:
+        return l.artist.compare(r.artist);
+
+    case PlaylistSortKey::Album:
+        return l.album.compare(r.album);
+
+    case PlaylistSortKey::TrackNumber:
+        return l.discNumber != r.discNumber ? compareValues(l.discNumber, r.discNumber) :
+                                              compareValues(l.trackNumber, r.trackNumber);
+
+    case PlaylistSortKey::Title:
+        return l.title.compare(r.title);
+
+    case PlaylistSortKey::Duration:
+        return compareValues(l.duration, r.duration);
+
+    case PlaylistSortKey::Path:
+        break;
+    }
+
+    return 0;
+}
+} // namespace
+
+std::vector<std::size_t> sortPlaylistTracks(const std::vector<PlaylistTrack> &tracks,
+    const std::vector<PlaylistSortCriterion> &criteria)
+{
+    const auto count = tracks.size();
+
+    std::vector<std::size_t> order(count);
+    std::iota(order.begin(), order.end(), std::size_t{ 0 });
+
+    if(count < 2 or criteria.empty())
+    {
+        return order;
+    }
+
+    const auto chunkCount = getChunkCount(count);
+
+    const auto needsSortKeys = std::any_of(criteria.cbegin(), criteria.cend(),
+        [](const auto &criterion) { return PlaylistSortKey::Path != criterion.key; });
+
+    std::vector<std::shared_ptr<const TrackSortKeys>> keys(needsSortKeys ? count : 0);
+    if(needsSortKeys)
+    {
+        forEachChunk(count, chunkCount,
+            [&tracks, &keys](std::size_t begin, std::size_t end)
+            {
+                // Collators are not shared between threads
+                const QCollator collator;
+
+                for(auto i = begin; i < end; ++i)
+                {
+                    const auto *record = tracks[i].audioMetaData.getRecord();
+                    keys[i] = record and record->sortKeys ? record->sortKeys :
+                                                            createSortKeys(collator, tracks[i]);
+                }
+            });
+
+        // Records can be shared by multiple tracks, they are written only after workers finish
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const auto *record = tracks[i].audioMetaData.getRecord();
+            if(record and not record->sortKeys)
+            {
+                record->sortKeys = keys[i];
+            }
+        }
+    }
+
+    const auto less = [&tracks, &keys, &criteria](std::size_t l, std::size_t r)
+    {
+        for(const auto &criterion : criteria)
+        {
+            const auto result = PlaylistSortKey::Path == criterion.key ?
+                                    tracks[l].path.compare(tracks[r].path) :
+                                    compareKeys(*keys[l], *keys[r], criterion.key);
+
+            if(result != 0)
+            {
+                return Qt::AscendingOrder == criterion.order ? result < 0 : result > 0;
+            }
+        }
+
+        return false;
+    };
+
+    forEachChunk(count, chunkCount,
+        [&order, &less](std::size_t begin, std::size_t end)
+        { std::stable_sort(order.begin() + begin, order.begin() + end, less); });
+
+    // Neighbouring chunks are merged in pairs, the left one first to keep the sort stable
+    for(std::size_t width = 1; width < chunkCount; width *= 2)
+    {
+        const auto mergeCount = (chunkCount + 2 * width - 1) / (2 * width);
+
+        forEachChunk(mergeCount, mergeCount,
+            [&](std::size_t merge, std::size_t)
+            {
+                const auto firstChunk = merge * 2 * width;
+                const auto middleChunk = std::min(firstChunk + width, chunkCount);
+                const auto lastChunk = std::min(firstChunk + 2 * width, chunkCount);
+
+                std::inplace_merge(order.begin() + getChunkBound(count, firstChunk, chunkCount),
+                    order.begin() + getChunkBound(count, middleChunk, chunkCount),
+                    order.begin() + getChunkBound(count, lastChunk, chunkCount), less);
+            });
+    }
+
+    return order;
+}
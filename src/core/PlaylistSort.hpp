@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QCollatorSortKey>
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+struct PlaylistTrack;
+
+enum class PlaylistSortKey
+{
+    Artist,
+    Album,
+    // Disc number first, then track number
+    TrackNumber,
+    Title,
+    Duration,
+    Path,
+};
+
+struct PlaylistSortCriterion
+{
+    PlaylistSortKey key;
+    Qt::SortOrder order{ Qt::AscendingOrder };
+};
+
+// Locale collation keys and numeric fields of a track, compared instead of the metadata itself.
+// Cached in MetaDataRecord until its metadata changes.
+struct TrackSortKeys
+{
+    QCollatorSortKey artist;
+    QCollatorSortKey album;
+    QCollatorSortKey title;
+    int discNumber;
+    int trackNumber;
+    std::chrono::seconds duration;
+};
+
+// Returns indexes of the tracks in sorted order, tracks comparing equal keep their relative order.
+// Missing sort keys are created and cached first, large playlists are sorted on multiple threads.
+[[nodiscard]] std::vector<std::size_t> sortPlaylistTracks(const std::vector<PlaylistTrack> &tracks,
+    const std::vector<PlaylistSortCriterion> &criteria);
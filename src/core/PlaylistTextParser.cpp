@@ -0,0 +1,138 @@
+#include "PlaylistTextParser.hpp"
+
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+class LineSplitter final
+{
+public:
+    explicit LineSplitter(QByteArrayView content)
+    : data_{ content.data() }
+    {
+        // Playlist lines are usually shorter than a hundred bytes
+        lines_.reserve(static_cast<std::size_t>(content.size()) / 64);
+    }
+
+    void addLineEnd(std::size_t end)
+    {
+        auto lineEnd = end;
+        if(lineEnd > begin_ and data_[lineEnd - 1] == '\r')
+        {
+            --lineEnd;
+        }
+
+        if(lineEnd > begin_)
+        {
+            lines_.emplace_back(data_ + begin_, static_cast<qsizetype>(lineEnd - begin_));
+        }
+
+        begin_ = end + 1;
+    }
+
+    // Bit i of the mask marks a new line at offset + i
+    void addLineEnds(std::uint32_t mask, std::size_t offset)
+    {
+        while(mask != 0)
+        {
+            addLineEnd(offset + static_cast<std::size_t>(__builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+
+    std::vector<QByteArrayView> finish(std::size_t size)
+    {
+        if(begin_ < size)
+        {
+            addLineEnd(size);
+        }
+
+        return std::move(lines_);
+    }
+
+private:
+    const char *data_;
+    std::size_t begin_{ 0 };
+    std::vector<QByteArrayView> lines_;
+};
+} // namespace
+
+std::vector<QByteArrayView> splitPlaylistLines(QByteArrayView content)
+{
+    const auto *data = content.data();
+    const auto size = static_cast<std::size_t>(content.size());
+
+    LineSplitter splitter{ content };
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    {
+        constexpr std::size_t lanes = sizeof(__m256i);
+        const auto newLine = _mm256_set1_epi8('\n');
+
+        for(; i + lanes <= size; i += lanes)
+        {
+            const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+            const auto mask =
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newLine)));
+
+            splitter.addLineEnds(mask, i);
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    {
+        constexpr std::size_t lanes = sizeof(__m128i);
+        const auto newLine = _mm_set1_epi8('\n');
+
+        for(; i + lanes <= size; i += lanes)
+        {
+            const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+            const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newLine)));
+
+            splitter.addLineEnds(mask, i);
+        }
+    }
+#endif
+
+    for(; i < size; ++i)
+    {
+        if(data[i] == '\n')
+        {
+            splitter.addLineEnd(i);
+        }
+    }
+
+    return splitter.finish(size);
+}
+
+std::vector<QString> parseTextPlaylist(QByteArrayView content)
+{
+    const auto lines = splitPlaylistLines(content);
+
+    std::vector<QString> decoded;
+    decoded.reserve(lines.size());
+
+    for(const auto line : lines)
+    {
+        decoded.push_back(QString::fromUtf8(line));
+    }
+
+    return decoded;
+}
+
+bool isAbsoluteLocalPath(QStringView line) noexcept
+{
+    if(line.startsWith(u'/'))
+    {
+        return true;
+    }
+
+    // Windows drive letter, backslashes are left to QUrl to normalize
+    return line.size() > 2 and line[0].isLetter() and line[1] == u':' and line[2] == u'/';
+}
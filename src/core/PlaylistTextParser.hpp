@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+
+#include <cstddef>
+#include <vector>
+
+// Splits playlist content into lines, vectorized with SSE2/AVX2 when available.
+// Carriage returns before a new line are dropped, empty lines are skipped.
+[[nodiscard]] std::vector<QByteArrayView> splitPlaylistLines(QByteArrayView content);
+
+// Decoded lines of a text playlist, the content is not copied before decoding
+[[nodiscard]] std::vector<QString> parseTextPlaylist(QByteArrayView content);
+
+// Whether a playlist line is an absolute local path, which is used as is.
+// Anything else (URLs, relative paths) goes through QUrl.
+[[nodiscard]] bool isAbsoluteLocalPath(QStringView line) noexcept;
@@ -0,0 +1,209 @@
+#include "PlaylistTrackIndex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Shifts kept before positions are collected again, sqrt(n) for large playlists so that
+// collecting them is amortized over as many changes as it takes to catch up a path
+std::size_t getShiftLimit(std::size_t trackCount)
+{
+    return std::max<std::size_t>(64, static_cast<std::size_t>(std::sqrt(static_cast<double>(trackCount))));
+}
+} // namespace
+
+void PlaylistTrackIndex::add(const Playlist &playlist)
+{
+    const auto id = playlist.getPlaylistId();
+    remove(id);
+
+    auto &paths = playlists_[id].paths;
+
+    const auto &tracks = playlist.getTracks();
+    for(std::size_t position = 0; position < tracks.size(); ++position)
+    {
+        paths[tracks[position].path].positions.push_back(position);
+    }
+
+    for(const auto &[path, trackPositions] : paths)
+    {
+        addPlaylistOf(path, id);
+    }
+}
+
+void PlaylistTrackIndex::remove(PlaylistId id)
+{
+    const auto playlist = playlists_.find(id);
+    if(playlist == playlists_.end())
+    {
+        return;
+    }
+
+    for(const auto &[path, positions] : playlist->second.paths)
+    {
+        removePlaylistOf(path, id);
+    }
+
+    playlists_.erase(playlist);
+}
+
+void PlaylistTrackIndex::update(const Playlist &playlist, const PlaylistChange &change)
+{
+    const auto id = playlist.getPlaylistId();
+
+    const auto indexed = playlists_.find(id);
+    if(indexed == playlists_.end())
+    {
+        return;
+    }
+
+    auto &indexedPlaylist = indexed->second;
+
+    if(const auto *insertion = std::get_if<PlaylistInsertion>(&change))
+    {
+        insert(id, indexedPlaylist, *insertion, playlist.getTrackCount());
+    }
+    else if(const auto *removal = std::get_if<PlaylistRemoval>(&change))
+    {
+        indexedPlaylist.shifts.push_back(PositionShift{ removal->first, removal->count, true });
+    }
+    else
+    {
+        // Moves and resets reorder tracks arbitrarily
+        add(playlist);
+        return;
+    }
+
+    if(indexedPlaylist.shifts.size() > getShiftLimit(playlist.getTrackCount()))
+    {
+        add(playlist);
+    }
+}
+
+std::vector<PlaylistTrackPositions> PlaylistTrackIndex::find(const TrackPath &path) const
+{
+    const auto playlistIds = playlistsByPath_.find(path);
+    if(playlistIds == playlistsByPath_.end())
+    {
+        return {};
+    }
+
+    std::vector<PlaylistTrackPositions> found;
+    found.reserve(playlistIds->second.size());
+
+    for(const auto id : playlistIds->second)
+    {
+        auto positions = getPositions(playlists_.at(id), path);
+        if(not positions.empty())
+        {
+            found.push_back(PlaylistTrackPositions{ id, std::move(positions) });
+        }
+    }
+
+    std::sort(found.begin(), found.end(),
+        [](const auto &l, const auto &r) { return l.playlistId.value < r.playlistId.value; });
+
+    return found;
+}
+
+bool PlaylistTrackIndex::contains(const TrackPath &path) const
+{
+    const auto playlistIds = playlistsByPath_.find(path);
+    if(playlistIds == playlistsByPath_.end())
+    {
+        return false;
+    }
+
+    return std::any_of(playlistIds->second.cbegin(), playlistIds->second.cend(),
+        [this, &path](const auto id) { return not getPositions(playlists_.at(id), path).empty(); });
+}
+
+void PlaylistTrackIndex::insert(PlaylistId id,
+    IndexedPlaylist &playlist,
+    const PlaylistInsertion &insertion,
+    std::size_t trackCount)
+{
+    const auto insertedCount = insertion.tracks.size();
+
+    // Appending, the common case, does not move any of the tracks
+    if(insertion.position + insertedCount < trackCount)
+    {
+        playlist.shifts.push_back(PositionShift{ insertion.position, insertedCount, false });
+    }
+
+    for(std::size_t i = 0; i < insertedCount; ++i)
+    {
+        const auto &path = insertion.tracks[i];
+        const auto position = insertion.position + i;
+
+        auto [trackPositions, isNew] = playlist.paths.try_emplace(path);
+        auto &entry = trackPositions->second;
+
+        applyShifts(playlist, entry.version, entry.positions);
+        entry.version = playlist.shifts.size();
+
+        entry.positions.insert(std::upper_bound(entry.positions.begin(), entry.positions.end(), position), position);
+
+        if(isNew)
+        {
+            addPlaylistOf(path, id);
+        }
+    }
+}
+
+void PlaylistTrackIndex::applyShifts(const IndexedPlaylist &playlist,
+    std::size_t version,
+    std::vector<std::size_t> &positions)
+{
+    for(auto shift = playlist.shifts.cbegin() + static_cast<std::ptrdiff_t>(version);
+        shift != playlist.shifts.cend() and not positions.empty(); ++shift)
+    {
+        const auto moved = std::lower_bound(positions.begin(), positions.end(), shift->position);
+
+        if(not shift->isRemoval)
+        {
+            std::for_each(moved, positions.end(), [count = shift->count](auto &position) { position += count; });
+            continue;
+        }
+
+        const auto removedEnd = std::lower_bound(moved, positions.end(), shift->position + shift->count);
+        std::for_each(removedEnd, positions.end(), [count = shift->count](auto &position) { position -= count; });
+        positions.erase(moved, removedEnd);
+    }
+}
+
+std::vector<std::size_t> PlaylistTrackIndex::getPositions(const IndexedPlaylist &playlist, const TrackPath &path)
+{
+    const auto entry = playlist.paths.find(path);
+    if(entry == playlist.paths.end())
+    {
+        return {};
+    }
+
+    auto positions = entry->second.positions;
+    applyShifts(playlist, entry->second.version, positions);
+    return positions;
+}
+
+void PlaylistTrackIndex::addPlaylistOf(const TrackPath &path, PlaylistId id)
+{
+    playlistsByPath_[path].push_back(id);
+}
+
+void PlaylistTrackIndex::removePlaylistOf(const TrackPath &path, PlaylistId id)
+{
+    const auto playlistIds = playlistsByPath_.find(path);
+    if(playlistIds == playlistsByPath_.end())
+    {
+        return;
+    }
+
+    auto &ids = playlistIds->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+
+    if(ids.empty())
+    {
+        playlistsByPath_.erase(playlistIds);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Playlist.hpp"
+#include "PlaylistChange.hpp"
+#include "TrackPath.hpp"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+struct PlaylistTrackPositions
+{
+    PlaylistId playlistId;
+    // Ascending
+    std::vector<std::size_t> positions;
+};
+
+// Positions of tracks of loaded playlists by path, updated with every change of a playlist,
+// so that tracks of a file are found without going through all the playlists.
+// Insertions and removals are logged as shifts of positions, paths catch up with them when they
+// are changed or read, so that a change costs as much as the tracks it touches. The positions
+// are collected again once the log grows too long.
+class PlaylistTrackIndex final
+{
+public:
+    // Replaces the positions of the playlist if it was added before
+    void add(const Playlist &);
+    void remove(PlaylistId);
+
+    // Called once the change is applied to the playlist
+    void update(const Playlist &, const PlaylistChange &);
+
+    // Ordered by playlist id, empty if no loaded playlist contains the path
+    [[nodiscard]] std::vector<PlaylistTrackPositions> find(const TrackPath &) const;
+    [[nodiscard]] bool contains(const TrackPath &) const;
+
+private:
+    // Insertion moves positions from the given one on forward, removal drops positions
+    // in range [position, position + count) and moves the following ones back
+    struct PositionShift
+    {
+        std::size_t position;
+        std::size_t count;
+        bool isRemoval;
+    };
+
+    // Positions with the first `version` shifts of the playlist applied
+    struct TrackPositions
+    {
+        std::vector<std::size_t> positions;
+        std::size_t version{ 0 };
+    };
+
+    struct IndexedPlaylist
+    {
+        // Paths whose tracks were all removed stay until the positions are collected again
+        std::unordered_map<TrackPath, TrackPositions, TrackPathHasher> paths;
+        std::vector<PositionShift> shifts;
+    };
+
+    void insert(PlaylistId, IndexedPlaylist &, const PlaylistInsertion &, std::size_t trackCount);
+
+    static void applyShifts(const IndexedPlaylist &, std::size_t version, std::vector<std::size_t> &positions);
+    static std::vector<std::size_t> getPositions(const IndexedPlaylist &, const TrackPath &);
+
+    void addPlaylistOf(const TrackPath &, PlaylistId);
+    void removePlaylistOf(const TrackPath &, PlaylistId);
+
+private:
+    std::unordered_map<PlaylistId, IndexedPlaylist, PlaylistIdHasher> playlists_;
+    // Every playlist containing the path listed once
+    std::unordered_map<TrackPath, std::vector<PlaylistId>, TrackPathHasher> playlistsByPath_;
+};
@@ -0,0 +1,261 @@
+#include "RowSelection.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+std::optional<std::size_t> insertRow(std::optional<std::size_t> row, std::size_t first, std::size_t count)
+{
+    return row and *row >= first ? std::optional{ *row + count } : row;
+}
+
+std::optional<std::size_t> removeRow(std::optional<std::size_t> row, std::size_t first, std::size_t count)
+{
+    if(not row or *row < first)
+    {
+        return row;
+    }
+
+    return *row < first + count ? first : *row - count;
+}
+
+std::optional<std::size_t> moveRow(std::optional<std::size_t> row, const TrackRunMove &move)
+{
+    if(not row)
+    {
+        return row;
+    }
+
+    // Position of the run once it is taken out
+    const auto target = move.destination > move.first ? move.destination - move.count : move.destination;
+
+    if(*row >= move.first and *row < move.first + move.count)
+    {
+        return target + (*row - move.first);
+    }
+
+    return insertRow(removeRow(row, move.first, move.count), target, move.count);
+}
+} // namespace
+
+const std::vector<TrackRange> &RowSelection::getRanges() const
+{
+    return ranges_;
+}
+
+bool RowSelection::contains(std::size_t row) const
+{
+    const auto it = std::upper_bound(ranges_.cbegin(), ranges_.cend(), row,
+        [](std::size_t value, const TrackRange &range) { return value < range.first; });
+
+    if(it == ranges_.cbegin())
+    {
+        return false;
+    }
+
+    const auto &range = *std::prev(it);
+    return row < range.first + range.count;
+}
+
+bool RowSelection::isEmpty() const
+{
+    return ranges_.empty();
+}
+
+std::optional<std::size_t> RowSelection::getCurrent() const
+{
+    return current_;
+}
+
+std::optional<std::size_t> RowSelection::getAnchor() const
+{
+    return anchor_;
+}
+
+void RowSelection::clear()
+{
+    ranges_.clear();
+    current_.reset();
+    anchor_.reset();
+}
+
+void RowSelection::select(std::size_t row)
+{
+    ranges_ = { TrackRange{ row, 1 } };
+    current_ = row;
+    anchor_ = row;
+}
+
+void RowSelection::toggle(std::size_t row)
+{
+    if(contains(row))
+    {
+        subtract(TrackRange{ row, 1 });
+    }
+    else
+    {
+        add(TrackRange{ row, 1 });
+    }
+
+    current_ = row;
+    anchor_ = row;
+}
+
+void RowSelection::extendTo(std::size_t row)
+{
+    const auto anchor = anchor_.value_or(row);
+    const auto first = std::min(anchor, row);
+
+    ranges_ = { TrackRange{ first, std::max(anchor, row) - first + 1 } };
+    current_ = row;
+    anchor_ = anchor;
+}
+
+void RowSelection::selectAll(std::size_t rowCount)
+{
+    ranges_.clear();
+    if(rowCount > 0)
+    {
+        ranges_.push_back(TrackRange{ 0, rowCount });
+    }
+}
+
+void RowSelection::assign(const std::vector<std::size_t> &rows,
+    std::optional<std::size_t> current,
+    std::optional<std::size_t> anchor)
+{
+    std::vector<TrackRange> ranges;
+    ranges.reserve(rows.size());
+    std::transform(rows.cbegin(), rows.cend(), std::back_inserter(ranges),
+        [](std::size_t row) { return TrackRange{ row, 1 }; });
+
+    ranges_ = mergeTrackRanges(std::move(ranges));
+    current_ = current;
+    anchor_ = anchor;
+}
+
+void RowSelection::insertRows(std::size_t first, std::size_t count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    std::vector<TrackRange> ranges;
+    ranges.reserve(ranges_.size() + 1);
+
+    for(const auto &range : ranges_)
+    {
+        if(range.first >= first)
+        {
+            ranges.push_back(TrackRange{ range.first + count, range.count });
+        }
+        else if(range.first + range.count > first)
+        {
+            ranges.push_back(TrackRange{ range.first, first - range.first });
+            ranges.push_back(TrackRange{ first + count, range.first + range.count - first });
+        }
+        else
+        {
+            ranges.push_back(range);
+        }
+    }
+
+    ranges_ = std::move(ranges);
+    current_ = insertRow(current_, first, count);
+    anchor_ = insertRow(anchor_, first, count);
+}
+
+void RowSelection::removeRows(std::size_t first, std::size_t count)
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    subtract(TrackRange{ first, count });
+
+    for(auto &range : ranges_)
+    {
+        if(range.first >= first + count)
+        {
+            range.first -= count;
+        }
+    }
+
+    // Ranges around removed rows become adjacent
+    ranges_ = mergeTrackRanges(std::move(ranges_));
+    current_ = removeRow(current_, first, count);
+    anchor_ = removeRow(anchor_, first, count);
+}
+
+void RowSelection::moveRows(const TrackRunMove &move)
+{
+    if(move.count == 0)
+    {
+        return;
+    }
+
+    // Selected parts of the run, relative to its first row
+    std::vector<TrackRange> moved;
+    for(const auto &range : ranges_)
+    {
+        const auto first = std::max(range.first, move.first);
+        const auto last = std::min(range.first + range.count, move.first + move.count);
+        if(first < last)
+        {
+            moved.push_back(TrackRange{ first - move.first, last - first });
+        }
+    }
+
+    const auto current = moveRow(current_, move);
+    const auto anchor = moveRow(anchor_, move);
+
+    const auto target = move.destination > move.first ? move.destination - move.count : move.destination;
+    removeRows(move.first, move.count);
+    insertRows(target, move.count);
+
+    for(const auto &range : moved)
+    {
+        add(TrackRange{ target + range.first, range.count });
+    }
+
+    current_ = current;
+    anchor_ = anchor;
+}
+
+void RowSelection::add(TrackRange range)
+{
+    ranges_.push_back(range);
+    ranges_ = mergeTrackRanges(std::move(ranges_));
+}
+
+void RowSelection::subtract(TrackRange removed)
+{
+    std::vector<TrackRange> ranges;
+    ranges.reserve(ranges_.size() + 1);
+
+    const auto removedEnd = removed.first + removed.count;
+    for(const auto &range : ranges_)
+    {
+        const auto end = range.first + range.count;
+        if(end <= removed.first or range.first >= removedEnd)
+        {
+            ranges.push_back(range);
+            continue;
+        }
+
+        if(range.first < removed.first)
+        {
+            ranges.push_back(TrackRange{ range.first, removed.first - range.first });
+        }
+
+        if(end > removedEnd)
+        {
+            ranges.push_back(TrackRange{ removedEnd, end - removedEnd });
+        }
+    }
+
+    ranges_ = std::move(ranges);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "TrackIndexMapping.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// Selected rows of a playlist view as sorted disjoint ranges, along with the current row and
+// the anchor of range selection. Follows inserted, removed and moved rows without listing them.
+class RowSelection final
+{
+public:
+    const std::vector<TrackRange> &getRanges() const;
+    bool contains(std::size_t row) const;
+    bool isEmpty() const;
+
+    std::optional<std::size_t> getCurrent() const;
+    std::optional<std::size_t> getAnchor() const;
+
+    // Forgets the selection, the current row and the anchor
+    void clear();
+
+    // Selects only the row, it becomes the current one and the anchor
+    void select(std::size_t row);
+
+    // Adds the row to the selection or removes it, it becomes the current one and the anchor
+    void toggle(std::size_t row);
+
+    // Selects only the rows between the anchor and the row, the row becomes the current one
+    void extendTo(std::size_t row);
+
+    void selectAll(std::size_t rowCount);
+
+    // Replaces the selection by the rows in any order, along with the current row and the anchor
+    void assign(const std::vector<std::size_t> &rows,
+        std::optional<std::size_t> current,
+        std::optional<std::size_t> anchor);
+
+    // Rows inserted inside a selected range are not selected
+    void insertRows(std::size_t first, std::size_t count);
+
+    // Current row and anchor within removed rows move to the row after them
+    void removeRows(std::size_t first, std::size_t count);
+
+    // Moved rows keep their selection
+    void moveRows(const TrackRunMove &);
+
+private:
+    void add(TrackRange);
+    void subtract(TrackRange);
+
+private:
+    std::vector<TrackRange> ranges_;
+    std::optional<std::size_t> current_;
+    std::optional<std::size_t> anchor_;
+};
@@ -0,0 +1,20 @@
+#include "StoredTrack.hpp"
+
+#include "Playlist.hpp"
+
+std::vector<StoredTrack> createStoredTracks(const std::vector<PlaylistTrack> &tracks)
+{
+    std::vector<StoredTrack> storedTracks;
+    storedTracks.reserve(tracks.size());
+
+    for(const auto &track : tracks)
+    {
+        auto &stored = storedTracks.emplace_back(StoredTrack{ track.path, std::nullopt });
+        if(track.audioMetaData and not track.audioMetaData.getRecord()->isHint)
+        {
+            stored.audioMetaData = *track.audioMetaData;
+        }
+    }
+
+    return storedTracks;
+}
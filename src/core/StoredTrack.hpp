@@ -0,0 +1,20 @@
+#pragma once
+
+#include "AudioMetaData.hpp"
+#include "TrackPath.hpp"
+
+#include <optional>
+#include <vector>
+
+struct PlaylistTrack;
+
+// Track as written to a playlist file, metadata is a copy taken when it was written
+struct StoredTrack
+{
+    TrackPath path;
+    std::optional<AudioMetaData> audioMetaData;
+};
+
+// Metadata records are updated in place, so their content is copied.
+// Hinted metadata is not stored, it is replaced once file tags are read.
+[[nodiscard]] std::vector<StoredTrack> createStoredTracks(const std::vector<PlaylistTrack> &);
@@ -0,0 +1,142 @@
+#include "SubstringSearch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+bool equalCodeUnits(const char16_t *l, const char16_t *r, std::size_t count) noexcept
+{
+    return std::memcmp(l, r, count * sizeof(char16_t)) == 0;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+// Candidates are positions where both the first and the last needle character match,
+// only these are compared in full
+bool verifyCandidates(std::uint32_t mask,
+    const char16_t *position,
+    const char16_t *needle,
+    std::size_t needleSize) noexcept
+{
+    // Each 16-bit lane is represented by two bits of the byte mask
+    while(mask != 0)
+    {
+        const auto bit = static_cast<std::size_t>(__builtin_ctz(mask));
+        const auto lane = bit / 2;
+
+        if(equalCodeUnits(position + lane + 1, needle + 1, needleSize - 2))
+        {
+            return true;
+        }
+
+        mask &= mask - 1;
+        mask &= mask - 1;
+    }
+
+    return false;
+}
+#endif
+
+bool containsScalar(const char16_t *haystack,
+    std::size_t haystackSize,
+    const char16_t *needle,
+    std::size_t needleSize) noexcept
+{
+    const auto first = needle[0];
+    const auto lastOffset = needleSize - 1;
+
+    for(std::size_t i = 0; i + needleSize <= haystackSize; ++i)
+    {
+        if(haystack[i] == first and haystack[i + lastOffset] == needle[lastOffset] and
+            equalCodeUnits(haystack + i, needle, needleSize))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+} // namespace
+
+bool containsSubstring(const char16_t *haystack,
+    std::size_t haystackSize,
+    const char16_t *needle,
+    std::size_t needleSize) noexcept
+{
+    if(needleSize == 0)
+    {
+        return true;
+    }
+
+    if(needleSize > haystackSize)
+    {
+        return false;
+    }
+
+    if(needleSize == 1)
+    {
+        return std::char_traits<char16_t>::find(haystack, haystackSize, needle[0]) != nullptr;
+    }
+
+    std::size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    const auto lastOffset = needleSize - 1;
+    const auto candidates = haystackSize - lastOffset;
+#endif
+
+#if defined(__AVX2__)
+    {
+        constexpr std::size_t lanes = sizeof(__m256i) / sizeof(char16_t);
+        const auto first = _mm256_set1_epi16(static_cast<short>(needle[0]));
+        const auto last = _mm256_set1_epi16(static_cast<short>(needle[lastOffset]));
+
+        for(; i + lanes <= candidates; i += lanes)
+        {
+            const auto blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+            const auto blockLast =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + lastOffset));
+
+            const auto matches = _mm256_and_si256(
+                _mm256_cmpeq_epi16(blockFirst, first), _mm256_cmpeq_epi16(blockLast, last));
+            const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(matches));
+
+            if(verifyCandidates(mask, haystack + i, needle, needleSize))
+            {
+                return true;
+            }
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    {
+        constexpr std::size_t lanes = sizeof(__m128i) / sizeof(char16_t);
+        const auto first = _mm_set1_epi16(static_cast<short>(needle[0]));
+        const auto last = _mm_set1_epi16(static_cast<short>(needle[lastOffset]));
+
+        for(; i + lanes <= candidates; i += lanes)
+        {
+            const auto blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+            const auto blockLast =
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + lastOffset));
+
+            const auto matches =
+                _mm_and_si128(_mm_cmpeq_epi16(blockFirst, first), _mm_cmpeq_epi16(blockLast, last));
+            const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(matches));
+
+            if(verifyCandidates(mask, haystack + i, needle, needleSize))
+            {
+                return true;
+            }
+        }
+    }
+#endif
+
+    return containsScalar(haystack + i, haystackSize - i, needle, needleSize);
+}
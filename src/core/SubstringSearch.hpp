@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QStringView>
+
+#include <cstddef>
+
+// Exact search of UTF-16 code units, vectorized with SSE2/AVX2 when available
+[[nodiscard]] bool containsSubstring(const char16_t *haystack,
+    std::size_t haystackSize,
+    const char16_t *needle,
+    std::size_t needleSize) noexcept;
+
+[[nodiscard]] inline bool containsSubstring(QStringView haystack, QStringView needle) noexcept
+{
+    return containsSubstring(haystack.utf16(), static_cast<std::size_t>(haystack.size()),
+        needle.utf16(), static_cast<std::size_t>(needle.size()));
+}
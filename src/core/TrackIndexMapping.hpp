@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// New positions of elements after a reorder.
+// Only elements in range [first, first + newIndexes.size()) changed their positions.
+struct TrackIndexMapping
+{
+    std::size_t first{ 0 };
+    std::vector<std::size_t> newIndexes;
+
+    std::size_t map(std::size_t index) const
+    {
+        const auto offset = index - first;
+        return index >= first and offset < newIndexes.size() ? newIndexes[offset] : index;
+    }
+};
+
+// Contiguous range of positions
+struct TrackRange
+{
+    std::size_t first{ 0 };
+    std::size_t count{ 0 };
+};
+
+// Sorts ranges and merges the overlapping and adjacent ones, empty ranges are dropped
+inline std::vector<TrackRange> mergeTrackRanges(std::vector<TrackRange> ranges)
+{
+    ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [](const auto &range) { return range.count == 0; }),
+        ranges.end());
+    std::sort(ranges.begin(), ranges.end(),
+        [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    std::vector<TrackRange> merged;
+    for(const auto &range : ranges)
+    {
+        if(not merged.empty() and range.first <= merged.back().first + merged.back().count)
+        {
+            const auto end = std::max(merged.back().first + merged.back().count, range.first + range.count);
+            merged.back().count = end - merged.back().first;
+        }
+        else
+        {
+            merged.push_back(range);
+        }
+    }
+
+    return merged;
+}
+
+// Move of a contiguous run of elements in front of the element at destination. Positions are
+// the ones right before the run is moved, as in QAbstractItemModel::beginMoveRows.
+struct TrackRunMove
+{
+    std::size_t first{ 0 };
+    std::size_t count{ 0 };
+    std::size_t destination{ 0 };
+};
+
+// Reorder done by moveElements, also as moves of contiguous runs applied one after another
+struct TrackMoves
+{
+    TrackIndexMapping mapping;
+    std::vector<TrackRunMove> runs;
+};
+
+// Position of the element that ends up right after moved elements, before the move
+inline std::size_t getDropIndex(const std::vector<std::size_t> &sortedIndexes, std::size_t target)
+{
+    auto dropIndex = target;
+    for(const auto index : sortedIndexes)
+    {
+        if(index > dropIndex) break;
+        ++dropIndex;
+    }
+    return dropIndex;
+}
+
+// Same move as moveElements split into moves of contiguous runs, without no-op moves.
+// Runs before the drop position move down starting from the last one, the ones after it move up.
+inline std::vector<TrackRunMove> splitMoveIntoRuns(std::vector<std::size_t> indexes,
+    std::size_t moveToIndex,
+    std::size_t elementCount)
+{
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    indexes.erase(std::lower_bound(indexes.begin(), indexes.end(), elementCount), indexes.end());
+
+    if(indexes.empty())
+    {
+        return {};
+    }
+
+    const auto dropIndex = getDropIndex(indexes, std::min(moveToIndex, elementCount - indexes.size()));
+
+    std::vector<TrackRange> runs;
+    for(const auto index : indexes)
+    {
+        if(not runs.empty() and runs.back().first + runs.back().count == index)
+        {
+            ++runs.back().count;
+        }
+        else
+        {
+            runs.push_back(TrackRange{ index, 1 });
+        }
+    }
+
+    std::vector<TrackRunMove> moves;
+
+    auto destination = dropIndex;
+    for(auto run = runs.rbegin(); run != runs.rend(); ++run)
+    {
+        if(run->first > dropIndex) continue;
+
+        if(run->first + run->count != destination)
+        {
+            moves.push_back(TrackRunMove{ run->first, run->count, destination });
+        }
+        destination -= run->count;
+    }
+
+    destination = dropIndex;
+    for(const auto &run : runs)
+    {
+        if(run.first < dropIndex) continue;
+
+        if(run.first != destination)
+        {
+            moves.push_back(TrackRunMove{ run.first, run.count, destination });
+        }
+        destination += run.count;
+    }
+
+    return moves;
+}
+
+// Moves elements in front of the element at moveToIndex among the elements that are not moved.
+// Single pass over the range between the moved elements and the drop position.
+template<typename T>
+TrackIndexMapping moveElements(std::vector<T> &elements,
+    std::vector<std::size_t> indexes,
+    std::size_t moveToIndex)
+{
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+    indexes.erase(std::lower_bound(indexes.begin(), indexes.end(), elements.size()), indexes.end());
+
+    if(indexes.empty())
+    {
+        return {};
+    }
+
+    const auto target = std::min(moveToIndex, elements.size() - indexes.size());
+
+    const auto dropIndex = getDropIndex(indexes, target);
+
+    // Elements outside of the range keep their positions
+    const auto first = std::min(indexes.front(), dropIndex);
+    const auto last = std::max(indexes.back() + 1, dropIndex);
+
+    std::vector<bool> moved(last - first, false);
+    for(const auto index : indexes)
+    {
+        moved[index - first] = true;
+    }
+
+    TrackIndexMapping mapping{ first, std::vector<std::size_t>(last - first) };
+    std::vector<T> reordered;
+    reordered.reserve(last - first);
+
+    const auto place = [&](std::size_t index)
+    {
+        mapping.newIndexes[index - first] = first + reordered.size();
+        reordered.push_back(std::move(elements[index]));
+    };
+
+    for(auto index = first; index < dropIndex; ++index)
+    {
+        if(not moved[index - first]) place(index);
+    }
+
+    for(const auto index : indexes)
+    {
+        place(index);
+    }
+
+    for(auto index = dropIndex; index < last; ++index)
+    {
+        if(not moved[index - first]) place(index);
+    }
+
+    std::move(reordered.begin(), reordered.end(), elements.begin() + first);
+
+    return mapping;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <QString>
+
+// Local file path or a remote URL
+struct TrackLocation
+{
+    QString path;
+    bool isLocalFile;
+};
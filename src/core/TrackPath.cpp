@@ -0,0 +1,205 @@
+#include "TrackPath.hpp"
+
+#include <QHashFunctions>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+class DirectoryTable final
+{
+public:
+    TrackPath::DirectoryId intern(QStringView directory)
+    {
+        if(directory.isEmpty())
+        {
+            return 0;
+        }
+
+        // Tracks are usually interned directory by directory
+        thread_local TrackPath::DirectoryId lastId{ 0 };
+        thread_local QString lastDirectory;
+        if(lastId != 0 and directory == lastDirectory)
+        {
+            return lastId;
+        }
+
+        auto key = directory.toString();
+
+        {
+            std::shared_lock lock{ mutex_ };
+            if(const auto it = ids_.find(key); it != ids_.end())
+            {
+                lastId = it->second;
+                lastDirectory = std::move(key);
+                return lastId;
+            }
+        }
+
+        std::unique_lock lock{ mutex_ };
+        const auto [it, inserted] =
+            ids_.try_emplace(key, static_cast<TrackPath::DirectoryId>(directories_.size()));
+        if(inserted)
+        {
+            directories_.push_back(key);
+        }
+
+        lastId = it->second;
+        lastDirectory = std::move(key);
+        return lastId;
+    }
+
+    QString get(TrackPath::DirectoryId id) const
+    {
+        std::shared_lock lock{ mutex_ };
+        return id < directories_.size() ? directories_[id] : QString{};
+    }
+
+    std::size_t size() const
+    {
+        std::shared_lock lock{ mutex_ };
+        return directories_.size();
+    }
+
+private:
+    mutable std::shared_mutex mutex_;
+    // Id 0 is reserved for paths without a directory
+    std::deque<QString> directories_{ QString{} };
+    std::unordered_map<QString, TrackPath::DirectoryId> ids_;
+};
+
+DirectoryTable &getDirectoryTable()
+{
+    static DirectoryTable table;
+    return table;
+}
+
+// Compares concatenations (a1 + a2) and (b1 + b2) segment by segment
+int compareConcatenated(QStringView a1, QStringView a2, QStringView b1, QStringView b2)
+{
+    auto a = a1;
+    auto b = b1;
+    bool aExhausted{ false };
+    bool bExhausted{ false };
+
+    while(true)
+    {
+        if(a.isEmpty() and not aExhausted)
+        {
+            a = a2;
+            aExhausted = true;
+            continue;
+        }
+
+        if(b.isEmpty() and not bExhausted)
+        {
+            b = b2;
+            bExhausted = true;
+            continue;
+        }
+
+        if(a.isEmpty() or b.isEmpty())
+        {
+            return static_cast<int>(not a.isEmpty()) - static_cast<int>(not b.isEmpty());
+        }
+
+        const auto length = std::min(a.size(), b.size());
+        if(const auto result = a.first(length).compare(b.first(length)); result != 0)
+        {
+            return result;
+        }
+
+        a = a.sliced(length);
+        b = b.sliced(length);
+    }
+}
+} // namespace
+
+TrackPath::TrackPath(QStringView path)
+{
+    const auto separatorIndex = path.lastIndexOf(u'/');
+    directoryId_ = internDirectory(path.first(separatorIndex + 1));
+    fileName_ = path.sliced(separatorIndex + 1).toString();
+}
+
+TrackPath::TrackPath(DirectoryId directoryId, QString fileName)
+: directoryId_{ directoryId }
+, fileName_{ std::move(fileName) }
+{
+}
+
+QString TrackPath::toString() const
+{
+    if(directoryId_ == 0)
+    {
+        return fileName_;
+    }
+
+    return getDirectory() + fileName_;
+}
+
+QString TrackPath::getDirectory() const
+{
+    return getDirectoryById(directoryId_);
+}
+
+TrackPath::DirectoryId TrackPath::getDirectoryId() const
+{
+    return directoryId_;
+}
+
+const QString &TrackPath::getFileName() const
+{
+    return fileName_;
+}
+
+bool TrackPath::isEmpty() const
+{
+    return directoryId_ == 0 and fileName_.isEmpty();
+}
+
+int TrackPath::compare(const TrackPath &other) const
+{
+    if(directoryId_ == other.directoryId_)
+    {
+        return QStringView{ fileName_ }.compare(other.fileName_);
+    }
+
+    const auto directory = getDirectory();
+    const auto otherDirectory = other.getDirectory();
+    return compareConcatenated(directory, fileName_, otherDirectory, other.fileName_);
+}
+
+TrackPath::DirectoryId TrackPath::internDirectory(QStringView directory)
+{
+    return getDirectoryTable().intern(directory);
+}
+
+QString TrackPath::getDirectoryById(DirectoryId id)
+{
+    return getDirectoryTable().get(id);
+}
+
+std::size_t TrackPath::getDirectoryCount()
+{
+    return getDirectoryTable().size();
+}
+
+bool operator==(const TrackPath &l, const TrackPath &r) noexcept
+{
+    return l.getDirectoryId() == r.getDirectoryId() and l.getFileName() == r.getFileName();
+}
+
+bool operator!=(const TrackPath &l, const TrackPath &r) noexcept
+{
+    return not(l == r);
+}
+
+std::size_t TrackPathHasher::operator()(const TrackPath &path) const noexcept
+{
+    return qHashMulti(0, path.getDirectoryId(), path.getFileName());
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+
+#include <cstdint>
+
+// Track location split into an interned directory and a file name.
+// Directories are stored once per process and shared by every track and
+// playlist referring to them, the full path is only rebuilt on demand.
+class TrackPath final
+{
+public:
+    using DirectoryId = std::uint32_t;
+
+    TrackPath() = default;
+    explicit TrackPath(QStringView path);
+    TrackPath(DirectoryId directoryId, QString fileName);
+
+    [[nodiscard]] QString toString() const;
+
+    [[nodiscard]] QString getDirectory() const;
+    [[nodiscard]] DirectoryId getDirectoryId() const;
+    [[nodiscard]] const QString &getFileName() const;
+
+    [[nodiscard]] bool isEmpty() const;
+
+    // Lexicographical comparison of the full paths without building them
+    [[nodiscard]] int compare(const TrackPath &other) const;
+
+    // Directory is expected to end with a separator, use an empty one
+    // for paths and URLs without a directory component
+    static DirectoryId internDirectory(QStringView directory);
+    static QString getDirectoryById(DirectoryId id);
+    static std::size_t getDirectoryCount();
+
+private:
+    DirectoryId directoryId_{ 0 };
+    QString fileName_;
+};
+
+bool operator==(const TrackPath &l, const TrackPath &r) noexcept;
+bool operator!=(const TrackPath &l, const TrackPath &r) noexcept;
+
+struct TrackPathHasher
+{
+    std::size_t operator()(const TrackPath &path) const noexcept;
+};
@@ -0,0 +1,43 @@
+#include "BinaryPlaylist.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+
+#include <vector>
+
+namespace
+{
+// Albums of 12 tracks, like a typical library
+std::vector<StoredTrack> createTracks(std::size_t count)
+{
+    std::vector<StoredTrack> tracks;
+    tracks.reserve(count);
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const auto album = QString{ "Album %1" }.arg(i / 12);
+        tracks.push_back(StoredTrack{
+            TrackPath{ QString{ "/music/Artist %1/%2/%3 - Title.flac" }.arg(i / 120).arg(album).arg(i % 12) },
+            AudioMetaData{ QString{ "Title %1" }.arg(i), QString{ "Artist %1" }.arg(i / 120), album, 1,
+                static_cast<int>(i % 12), std::chrono::seconds{ 200 } },
+        });
+    }
+
+    return tracks;
+}
+} // namespace
+
+static void BM_BinaryPlaylistParse(benchmark::State &state)
+{
+    const auto content = serializeBinaryPlaylist(createTracks(static_cast<std::size_t>(state.range(0))), 0);
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(parseBinaryPlaylist(content));
+    }
+
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+BENCHMARK(BM_BinaryPlaylistParse)->Arg(10'000)->Arg(300'000)->Unit(benchmark::kMillisecond);
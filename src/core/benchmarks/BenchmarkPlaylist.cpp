@@ -0,0 +1,137 @@
+#include "IPlaylistIO.hpp"
+#include "MetaDataStore.hpp"
+#include "Playlist.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <QString>
+#include <QUrl>
+
+#include <vector>
+
+namespace
+{
+class InMemoryPlaylistIO final : public IPlaylistIO
+{
+public:
+    explicit InMemoryPlaylistIO(std::size_t trackCount)
+    {
+        for(std::size_t i = 0; i < trackCount; ++i)
+        {
+            tracks_.push_back(PlaylistTrack{ TrackPath{ QString{ "/music/%1.flac" }.arg(i) }, std::nullopt });
+        }
+    }
+
+    Playlist load(const QString &filepath) override
+    {
+        return Playlist{ filepath, filepath, *this };
+    }
+
+    std::vector<std::optional<Playlist>> loadAll(const std::vector<QString> &filepaths) override
+    {
+        std::vector<std::optional<Playlist>> playlists;
+        for(const auto &filepath : filepaths)
+        {
+            playlists.emplace_back(load(filepath));
+        }
+        return playlists;
+    }
+
+    bool save(const Playlist &, const PlaylistChange &) override
+    {
+        return true;
+    }
+
+    bool rename(const Playlist &, const QString &) override
+    {
+        return true;
+    }
+
+    bool remove(const Playlist &) override
+    {
+        return true;
+    }
+
+    std::vector<PlaylistTrack> loadTracks(const std::vector<QUrl> &) override
+    {
+        return tracks_;
+    }
+
+    void resolveTracks(const std::vector<TrackPath> &) override
+    {
+    }
+
+    std::optional<std::vector<PlaylistTrack>> importTracks(const QString &) override
+    {
+        return tracks_;
+    }
+
+    bool exportTracks(const Playlist &, const QString &) override
+    {
+        return true;
+    }
+
+private:
+    std::vector<PlaylistTrack> tracks_;
+};
+} // namespace
+
+// Moves every n-th track of a playlist into its middle, like dragging a sparse selection
+static void BM_PlaylistMoveTracks(benchmark::State &state)
+{
+    const auto trackCount = static_cast<std::size_t>(state.range(0));
+    const auto movedCount = static_cast<std::size_t>(state.range(1));
+
+    InMemoryPlaylistIO playlistIO{ trackCount };
+    Playlist playlist{ "Benchmark", "Benchmark", std::vector<QUrl>{}, playlistIO };
+
+    std::vector<std::size_t> indexes;
+    for(std::size_t i = 0; i < movedCount; ++i)
+    {
+        indexes.push_back(i * (trackCount / movedCount));
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(playlist.moveTracks(indexes, trackCount / 2));
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(trackCount));
+}
+
+BENCHMARK(BM_PlaylistMoveTracks)
+    ->Args({ 10'000, 100 })
+    ->Args({ 200'000, 1'000 })
+    ->Args({ 200'000, 10'000 })
+    ->Unit(benchmark::kMillisecond);
+
+// Sorts a playlist by artist, album and track number, reversing the order every iteration
+static void BM_PlaylistSortTracks(benchmark::State &state)
+{
+    const auto trackCount = static_cast<std::size_t>(state.range(0));
+
+    MetaDataStore store;
+    std::vector<PlaylistTrack> tracks;
+    for(std::size_t i = 0; i < trackCount; ++i)
+    {
+        const TrackPath path{ QString{ "/music/%1/%2.flac" }.arg(i % 997).arg(i) };
+        const AudioMetaData audioMetaData{ QString{ "Title %1" }.arg(i), QString{ "Artist %1" }.arg(i % 997),
+            QString{ "Album %1" }.arg(i % 89), 1, static_cast<int>(i % 20), std::chrono::seconds{ 180 } };
+        tracks.push_back(PlaylistTrack{ path, store.acquire(path, audioMetaData) });
+    }
+
+    InMemoryPlaylistIO playlistIO{ 0 };
+    Playlist playlist{ "Benchmark", "Benchmark", std::move(tracks), playlistIO };
+
+    auto order = Qt::AscendingOrder;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(playlist.sortTracks(
+            { { PlaylistSortKey::Artist, order }, { PlaylistSortKey::Album }, { PlaylistSortKey::TrackNumber } }));
+        order = Qt::AscendingOrder == order ? Qt::DescendingOrder : Qt::AscendingOrder;
+    }
+
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(trackCount));
+}
+
+BENCHMARK(BM_PlaylistSortTracks)->Arg(10'000)->Arg(500'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,25 @@
+#include "PlaylistTextParser.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <QByteArray>
+#include <QString>
+
+static void BM_ParseTextPlaylist(benchmark::State &state)
+{
+    QByteArray content;
+    for(std::int64_t i = 0; i < state.range(0); ++i)
+    {
+        const auto line = QString{ "/music/Artist %1/Album %2/%3 - Title.flac\n" }.arg(i / 120).arg(i / 12);
+        content += line.arg(i % 12).toUtf8();
+    }
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(parseTextPlaylist(content));
+    }
+
+    state.SetBytesProcessed(state.iterations() * content.size());
+}
+
+BENCHMARK(BM_ParseTextPlaylist)->Arg(10'000)->Arg(300'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,210 @@
+#include "AutoPlaylistQuery.hpp"
+#include "AutoPlaylistUpdater.hpp"
+#include "MetaDataCache.hpp"
+#include "MetaDataStore.hpp"
+#include "PlaylistManager.hpp"
+
+#include "mocks/PlaylistIOMock.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+constexpr std::chrono::seconds now{ 1'000'000 };
+
+AutoPlaylistQuery createQuery()
+{
+    AutoPlaylistQuery query;
+    query.artist = "Artist";
+    query.pathPrefix = "/music/";
+    return query;
+}
+
+CachedTrack createCachedTrack(const QString &path, const QString &artist)
+{
+    return CachedTrack{
+        path, AudioMetaData{ "Title", artist, "Album", 1, 1, std::chrono::seconds{ 180 } }, now
+    };
+}
+} // namespace
+
+TEST(AutoPlaylistQueryTests, queryIsStoredAsText)
+{
+    auto query = createQuery();
+    query.maxDuration = std::chrono::seconds{ 600 };
+    query.modifiedWithin = std::chrono::hours{ 24 * 30 };
+
+    const auto content = serializeAutoPlaylistQuery(query);
+    EXPECT_TRUE(isAutoPlaylist(content));
+
+    const auto parsed = parseAutoPlaylistQuery(content);
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(query.artist, parsed->artist);
+    EXPECT_FALSE(parsed->album);
+    EXPECT_EQ(query.pathPrefix, parsed->pathPrefix);
+    EXPECT_FALSE(parsed->minDuration);
+    EXPECT_EQ(query.maxDuration, parsed->maxDuration);
+    EXPECT_EQ(query.modifiedWithin, parsed->modifiedWithin);
+
+    EXPECT_FALSE(parseAutoPlaylistQuery("/music/track.flac\n"));
+}
+
+TEST(AutoPlaylistQueryTests, allSetPredicatesHaveToMatch)
+{
+    auto query = createQuery();
+    query.modifiedWithin = std::chrono::seconds{ 60 };
+
+    const AudioMetaData metaData{ "Title", "ARTIST", "Album", 1, 1, std::chrono::seconds{ 180 } };
+
+    EXPECT_TRUE(query.matches("/music/a.flac", metaData, now - std::chrono::seconds{ 60 }, now));
+    EXPECT_FALSE(query.matches("/other/a.flac", metaData, now, now));
+    EXPECT_FALSE(query.matches("/music/a.flac", metaData, now - std::chrono::seconds{ 61 }, now));
+
+    query.minDuration = std::chrono::seconds{ 181 };
+    EXPECT_FALSE(query.matches("/music/a.flac", metaData, now, now));
+}
+
+struct AutoPlaylistUpdaterTests : Test
+{
+    QTemporaryDir directory{};
+    MetaDataStore store{};
+    NiceMock<PlaylistIOMock> playlistIOMock{};
+
+    AutoPlaylistUpdaterTests()
+    {
+        for(const auto *name : { "Auto", "Manual" })
+        {
+            QFile playlistFile{ directory.filePath(name) };
+            EXPECT_TRUE(playlistFile.open(QIODevice::WriteOnly));
+        }
+
+        ON_CALL(playlistIOMock, load)
+            .WillByDefault(
+                [this](const QString &filepath)
+                {
+                    const auto name = QFileInfo{ filepath }.completeBaseName();
+                    std::vector<PlaylistTrack> tracks;
+                    for(const auto *path : { "/music/b.flac", "/music/d.flac" })
+                    {
+                        tracks.push_back(PlaylistTrack{ TrackPath{ QString{ path } }, std::nullopt });
+                    }
+
+                    if(name == "Auto")
+                    {
+                        return Playlist{ name, filepath, createQuery(), std::move(tracks), playlistIOMock };
+                    }
+                    return Playlist{ name, filepath, std::move(tracks), playlistIOMock };
+                });
+    }
+
+    static void loadAll(PlaylistManager &manager)
+    {
+        while(manager.loadNext())
+        {
+            // Loads one playlist per iteration
+        }
+
+        ASSERT_EQ(2, manager.getLoaded().size());
+    }
+
+    static std::vector<QString> getPaths(const Playlist &playlist)
+    {
+        std::vector<QString> paths;
+        for(const auto &track : playlist.getTracks())
+        {
+            paths.push_back(track.path.toString());
+        }
+        return paths;
+    }
+};
+
+TEST_F(AutoPlaylistUpdaterTests, matchingTracksAreInsertedInPathOrder)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+    loadAll(manager);
+
+    AutoPlaylistUpdater updater{ manager, store };
+    const auto changed = updater.update(
+        {
+            createCachedTrack("/music/e.flac", "Someone"),
+            createCachedTrack("/music/c.flac", "Artist"),
+            createCachedTrack("/other/c.flac", "Artist"),
+            createCachedTrack("/music/a.flac", "artist"),
+            createCachedTrack("/music/f.flac", "Artist"),
+        },
+        now);
+
+    const auto autoId = *manager.findByName("Auto");
+    EXPECT_THAT(changed, ElementsAre(Field(&PlaylistId::value, autoId.value)));
+
+    EXPECT_THAT(getPaths(*manager.get(autoId)),
+        ElementsAre("/music/a.flac", "/music/b.flac", "/music/c.flac", "/music/d.flac", "/music/f.flac"));
+    EXPECT_THAT(getPaths(*manager.get(*manager.findByName("Manual"))),
+        ElementsAre("/music/b.flac", "/music/d.flac"));
+
+    EXPECT_TRUE(manager.get(autoId)->getTrack(2)->audioMetaData);
+}
+
+TEST_F(AutoPlaylistUpdaterTests, tracksNoLongerMatchingAreRemoved)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+    loadAll(manager);
+
+    AutoPlaylistUpdater updater{ manager, store };
+    updater.update(
+        {
+            createCachedTrack("/music/b.flac", "Someone"),
+            createCachedTrack("/music/c.flac", "Artist"),
+            createCachedTrack("/music/d.flac", "Someone"),
+        },
+        now);
+
+    EXPECT_THAT(getPaths(*manager.get(*manager.findByName("Auto"))), ElementsAre("/music/c.flac"));
+    EXPECT_TRUE(updater.update({ createCachedTrack("/music/c.flac", "Artist") }, now).empty());
+}
+
+TEST_F(AutoPlaylistUpdaterTests, listenerFollowsEachChange)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+    loadAll(manager);
+
+    const auto autoId = *manager.findByName("Auto");
+    auto mirrored = getPaths(*manager.get(autoId));
+
+    // Views replay the changes on their copy of the rows as they are reported
+    AutoPlaylistUpdater updater{ manager, store };
+    updater.setChangeListener(
+        [&manager, &mirrored](const AutoPlaylistChange &change)
+        {
+            const auto &tracks = manager.get(change.playlistId)->getTracks();
+            const auto removedBegin = mirrored.begin() + static_cast<std::ptrdiff_t>(change.removed.first);
+            mirrored.erase(removedBegin, removedBegin + static_cast<std::ptrdiff_t>(change.removed.count));
+
+            for(auto i = change.inserted.first; i < change.inserted.first + change.inserted.count; ++i)
+            {
+                mirrored.insert(mirrored.begin() + static_cast<std::ptrdiff_t>(i), tracks[i].path.toString());
+            }
+        });
+
+    updater.update(
+        {
+            createCachedTrack("/music/a.flac", "Artist"),
+            createCachedTrack("/music/b.flac", "Someone"),
+            createCachedTrack("/music/c.flac", "Artist"),
+            createCachedTrack("/music/f.flac", "Artist"),
+        },
+        now);
+
+    EXPECT_THAT(mirrored, ElementsAre("/music/a.flac", "/music/c.flac", "/music/d.flac", "/music/f.flac"));
+    EXPECT_EQ(getPaths(*manager.get(autoId)), mirrored);
+}
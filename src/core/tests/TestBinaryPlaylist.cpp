@@ -0,0 +1,82 @@
+#include "BinaryPlaylist.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QString>
+
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+std::vector<StoredTrack> createTracks()
+{
+    return {
+        StoredTrack{ TrackPath{ "/music/album/01.flac" },
+            AudioMetaData{ "Title", "Artist", "Album", 1, 1, std::chrono::seconds{ 180 } } },
+        StoredTrack{ TrackPath{ "/music/album/02.flac" },
+            AudioMetaData{ "Zażółć", "Artist", "Album", 1, 2, std::chrono::seconds{ 200 } } },
+        StoredTrack{ TrackPath{ "https://example.com/stream" }, std::nullopt },
+    };
+}
+} // namespace
+
+TEST(BinaryPlaylistTests, roundTrip)
+{
+    const auto tracks = createTracks();
+    const auto content = serializeBinaryPlaylist(tracks, 42);
+
+    EXPECT_TRUE(isBinaryPlaylist(content));
+
+    const auto playlist = parseBinaryPlaylist(content);
+    ASSERT_TRUE(playlist);
+    EXPECT_EQ(42, playlist->cacheGeneration);
+    ASSERT_EQ(tracks.size(), playlist->tracks.size());
+
+    for(std::size_t i = 0; i < tracks.size(); ++i)
+    {
+        const auto &expected = tracks[i];
+        const auto &actual = playlist->tracks[i];
+
+        EXPECT_EQ(expected.path, actual.path);
+        ASSERT_EQ(expected.audioMetaData.has_value(), actual.audioMetaData.has_value());
+
+        if(expected.audioMetaData)
+        {
+            EXPECT_EQ(expected.audioMetaData->title, actual.audioMetaData->title);
+            EXPECT_EQ(expected.audioMetaData->artist, actual.audioMetaData->artist);
+            EXPECT_EQ(expected.audioMetaData->albumName, actual.audioMetaData->albumName);
+            EXPECT_EQ(expected.audioMetaData->discNumber, actual.audioMetaData->discNumber);
+            EXPECT_EQ(expected.audioMetaData->trackNumber, actual.audioMetaData->trackNumber);
+            EXPECT_EQ(expected.audioMetaData->duration, actual.audioMetaData->duration);
+        }
+    }
+}
+
+TEST(BinaryPlaylistTests, emptyPlaylist)
+{
+    const auto playlist = parseBinaryPlaylist(serializeBinaryPlaylist({}, 0));
+
+    ASSERT_TRUE(playlist);
+    EXPECT_TRUE(playlist->tracks.empty());
+}
+
+TEST(BinaryPlaylistTests, textPlaylistIsNotBinary)
+{
+    const QByteArray content{ "/music/album/01.flac\n" };
+
+    EXPECT_FALSE(isBinaryPlaylist(content));
+    EXPECT_FALSE(parseBinaryPlaylist(content));
+}
+
+TEST(BinaryPlaylistTests, truncatedPlaylistIsRejected)
+{
+    const auto content = serializeBinaryPlaylist(createTracks(), 0);
+
+    for(const auto size : { 4, 32, 40, static_cast<int>(content.size()) - 1 })
+    {
+        EXPECT_FALSE(parseBinaryPlaylist(content.first(size))) << size;
+    }
+}
@@ -0,0 +1,118 @@
+#include "FilterQuery.hpp"
+
+#include "MetaDataStore.hpp"
+#include "Playlist.hpp"
+#include "SubstringSearch.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+using namespace ::testing;
+
+namespace
+{
+AudioMetaData createMetaData()
+{
+    return AudioMetaData{ "Árvíztűrő", "Some Artist", "Great Album", 1, 2, std::chrono::seconds{ 180 } };
+}
+} // namespace
+
+struct FilterQueryTests : Test
+{
+    MetaDataStore store{};
+
+    PlaylistTrack createTrack(const QString &path)
+    {
+        TrackPath trackPath{ path };
+        auto handle = store.acquire(trackPath, createMetaData());
+        return PlaylistTrack{ std::move(trackPath), std::move(handle) };
+    }
+};
+
+TEST_F(FilterQueryTests, emptyQueryMatchesEverything)
+{
+    const FilterQuery query{ "   " };
+
+    EXPECT_TRUE(query.isEmpty());
+    EXPECT_TRUE(query.matches(PlaylistTrack{ TrackPath{ u"/music/track.flac" }, std::nullopt }));
+}
+
+TEST_F(FilterQueryTests, smartCase)
+{
+    EXPECT_FALSE(FilterQuery{ "some artist" }.isCaseSensitive());
+    EXPECT_TRUE(FilterQuery{ "Some" }.isCaseSensitive());
+}
+
+TEST_F(FilterQueryTests, lowercaseQueryIgnoresCaseAndDiacritics)
+{
+    const auto track = createTrack("/music/Artist/01 Track.flac");
+
+    EXPECT_TRUE(FilterQuery{ "arviztur" }.matches(track));
+    EXPECT_TRUE(FilterQuery{ "árvíz" }.matches(track));
+    EXPECT_TRUE(FilterQuery{ "some great" }.matches(track));
+    EXPECT_FALSE(FilterQuery{ "some missing" }.matches(track));
+}
+
+TEST_F(FilterQueryTests, uppercaseQueryIsCaseSensitive)
+{
+    const auto track = createTrack("/music/Artist/01 Track.flac");
+
+    EXPECT_TRUE(FilterQuery{ "Some Great" }.matches(track));
+    EXPECT_FALSE(FilterQuery{ "SOME" }.matches(track));
+    EXPECT_TRUE(FilterQuery{ "Artist/01" }.matches(track));
+}
+
+TEST_F(FilterQueryTests, lowercaseQueryMatchesWholePath)
+{
+    const auto track = createTrack("/music/Artist/01 Track.flac");
+
+    EXPECT_TRUE(FilterQuery{ "music" }.matches(track));
+    EXPECT_TRUE(FilterQuery{ "01 track" }.matches(track));
+    EXPECT_TRUE(FilterQuery{ "artist/01" }.matches(track));
+    EXPECT_FALSE(FilterQuery{ "artist/02" }.matches(track));
+}
+
+TEST_F(FilterQueryTests, trackWithoutMetaDataMatchesPath)
+{
+    const PlaylistTrack track{ TrackPath{ u"/music/Artist/01 Track.flac" }, std::nullopt };
+
+    EXPECT_TRUE(FilterQuery{ "track" }.matches(track));
+    EXPECT_FALSE(FilterQuery{ "album" }.matches(track));
+}
+
+TEST_F(FilterQueryTests, searchKeyFollowsMetaDataUpdate)
+{
+    const auto track = createTrack("/music/track.flac");
+
+    auto metadata = createMetaData();
+    metadata.title = "Renamed";
+    store.update(track.path, metadata);
+
+    EXPECT_TRUE(FilterQuery{ "renamed" }.matches(track));
+}
+
+TEST_F(FilterQueryTests, refinement)
+{
+    const FilterQuery previous{ "art alb" };
+
+    EXPECT_TRUE(FilterQuery{ "arti alb" }.isRefinementOf(previous));
+    EXPECT_TRUE(FilterQuery{ "alb art 2000" }.isRefinementOf(previous));
+    EXPECT_TRUE(FilterQuery{ "album-art" }.isRefinementOf(previous));
+    EXPECT_FALSE(FilterQuery{ "ar alb" }.isRefinementOf(previous));
+    EXPECT_FALSE(FilterQuery{ "art" }.isRefinementOf(previous));
+    EXPECT_FALSE(FilterQuery{ "Art alb" }.isRefinementOf(previous));
+    EXPECT_FALSE(FilterQuery{ "art" }.isRefinementOf(FilterQuery{}));
+}
+
+TEST(SubstringSearchTests, containsSubstring)
+{
+    const QString haystack{ "a rather long haystack to cover all vectorized blocks, needle at the end" };
+
+    EXPECT_TRUE(containsSubstring(haystack, u"needle"));
+    EXPECT_TRUE(containsSubstring(haystack, u"a rather"));
+    EXPECT_TRUE(containsSubstring(haystack, u"end"));
+    EXPECT_TRUE(containsSubstring(haystack, u""));
+    EXPECT_FALSE(containsSubstring(haystack, u"needles"));
+    EXPECT_FALSE(containsSubstring(u"short", u"longer than haystack"));
+}
@@ -0,0 +1,192 @@
+#include "MetaDataStore.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+AudioMetaData createMetaData(QString title)
+{
+    return AudioMetaData{ std::move(title), "Artist", "Album", 1, 2, std::chrono::seconds{ 180 } };
+}
+} // namespace
+
+TEST(MetaDataStoreTests, recordIsSharedBetweenHandles)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto first = store.acquire(path, createMetaData("Title"));
+    const auto second = store.acquire(path);
+
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_EQ(first.getRecord(), second.getRecord());
+    EXPECT_EQ(1, store.getRecordCount());
+}
+
+TEST(MetaDataStoreTests, emptyRecordHasNoMetaData)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto handle = store.acquire(path);
+
+    EXPECT_FALSE(handle);
+    EXPECT_FALSE(store.find(path));
+}
+
+TEST(MetaDataStoreTests, updateIsVisibleThroughAllHandles)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto first = store.acquire(path, createMetaData("Old"));
+    const auto second = store.acquire(path);
+
+    ASSERT_TRUE(store.update(path, createMetaData("New")));
+
+    EXPECT_EQ(QString{ "New" }, first->title);
+    EXPECT_EQ(QString{ "New" }, second->title);
+}
+
+TEST(MetaDataStoreTests, revisionChangesOnlyWithMetaData)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto handle = store.acquireHint(path, createMetaData("Hint"));
+    const auto hintRevision = handle.getRecord()->revision;
+
+    store.acquire(path);
+    store.markResolved(path);
+    EXPECT_EQ(hintRevision, handle.getRecord()->revision);
+
+    store.acquire(path, createMetaData("Title"));
+    EXPECT_NE(hintRevision, handle.getRecord()->revision);
+
+    const auto fileRevision = handle.getRecord()->revision;
+    ASSERT_TRUE(store.update(path, createMetaData("New")));
+    EXPECT_NE(fileRevision, handle.getRecord()->revision);
+}
+
+TEST(MetaDataStoreTests, updateOfUnknownPathFails)
+{
+    MetaDataStore store;
+    EXPECT_FALSE(store.update(TrackPath{ u"/music/track.flac" }, createMetaData("Title")));
+}
+
+TEST(MetaDataStoreTests, artistAndAlbumAreInterned)
+{
+    MetaDataStore store;
+
+    const auto first = store.acquire(TrackPath{ u"/music/first.flac" }, createMetaData("First"));
+    const auto second = store.acquire(TrackPath{ u"/music/second.flac" }, createMetaData("Second"));
+
+    EXPECT_EQ(first->artist.constData(), second->artist.constData());
+    EXPECT_EQ(first->albumName.constData(), second->albumName.constData());
+}
+
+TEST(MetaDataStoreTests, internedStringsAreReleasedWithRecords)
+{
+    MetaDataStore store;
+    const auto acquire = [&store](int number)
+    {
+        auto metaData = createMetaData("Title");
+        metaData.artist = QString{ "Artist %1" }.arg(number);
+        return store.acquire(TrackPath{ QString{ "/music/%1.flac" }.arg(number) }, metaData);
+    };
+
+    std::vector<MetaDataHandle> handles;
+    for(auto number = 0; number < 1000; ++number)
+    {
+        handles.push_back(acquire(number));
+    }
+
+    const auto internedCount = store.getInternedStringCount();
+    EXPECT_EQ(1001, internedCount);
+
+    // Records are cleaned up as the store grows, strings of dropped handles go with them
+    handles.clear();
+    for(auto number = 1000; number < 2100; ++number)
+    {
+        acquire(number);
+    }
+
+    EXPECT_LT(store.getInternedStringCount(), internedCount);
+}
+
+TEST(MetaDataStoreTests, releasedRecordIsNotFound)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    {
+        const auto handle = store.acquire(path, createMetaData("Title"));
+    }
+
+    EXPECT_FALSE(store.find(path));
+}
+
+TEST(MetaDataStoreTests, hintIsReplacedByFileMetaData)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto handle = store.acquireHint(path, createMetaData("Hint"));
+
+    ASSERT_TRUE(handle);
+    EXPECT_TRUE(handle.getRecord()->isHint);
+    EXPECT_FALSE(store.find(path));
+
+    store.acquire(path, createMetaData("Title"));
+
+    EXPECT_EQ(QString{ "Title" }, handle->title);
+    EXPECT_FALSE(handle.getRecord()->isHint);
+    EXPECT_TRUE(store.find(path));
+}
+
+TEST(MetaDataStoreTests, hintDoesNotReplaceFileMetaData)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto handle = store.acquire(path, createMetaData("Title"));
+    store.acquireHint(path, createMetaData("Hint"));
+
+    EXPECT_EQ(QString{ "Title" }, handle->title);
+    EXPECT_FALSE(handle.getRecord()->isHint);
+}
+
+TEST(MetaDataStoreTests, unresolvedRecordIsResolvedByMetaData)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+
+    const auto handle = store.acquireUnresolved(path);
+    EXPECT_FALSE(handle.getRecord()->isResolved);
+
+    store.acquire(path, createMetaData("Title"));
+    EXPECT_TRUE(handle.getRecord()->isResolved);
+    EXPECT_TRUE(handle);
+}
+
+TEST(MetaDataStoreTests, knownMetaDataIsNotUnresolved)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+    const TrackPath missingPath{ u"/music/missing.flac" };
+
+    store.acquire(path, createMetaData("Title"));
+    EXPECT_TRUE(store.acquireUnresolved(path).getRecord()->isResolved);
+
+    const auto missing = store.acquireUnresolved(missingPath);
+    store.markResolved(missingPath);
+    EXPECT_TRUE(missing.getRecord()->isResolved);
+    EXPECT_FALSE(missing);
+}
@@ -1,3 +1,4 @@
+#include "MetaDataStore.hpp"
 #include "Playlist.hpp"
 
 #include "mocks/PlaylistIOMock.hpp"
@@ -18,7 +19,8 @@ std::vector<PlaylistTrack> createTracks(std::size_t count)
     std::vector<PlaylistTrack> newTracks;
     for(std::size_t i = 0; i < count; ++i)
     {
-        newTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(i), std::nullopt });
+        newTracks.emplace_back(
+            PlaylistTrack{ TrackPath{ QString{ "NewTrack%1" }.arg(i) }, std::nullopt });
     }
     return newTracks;
 }
@@ -30,7 +32,7 @@ void validateTracks(const Playlist &playlist, std::vector<QString> trackPaths)
 
     for(std::size_t i = 0; i < tracks.size(); ++i)
     {
-        EXPECT_EQ(trackPaths[i], tracks[i].path);
+        EXPECT_EQ(trackPaths[i], tracks[i].path.toString());
     }
 }
 } // namespace
@@ -133,6 +135,88 @@ TEST_F(PlaylistTests, moveTracksOnNonexistentIndex)
     validateTracks(playlist, { "NewTrack1", "NewTrack3", "NewTrack0", "NewTrack2", "NewTrack4" });
 }
 
+TEST_F(PlaylistTests, moveTracksReturnsIndexMapping)
+{
+    const std::vector<QUrl> tracksToLoad{};
+    const auto newTracksCount{ 8 };
+    const auto newTracks = createTracks(newTracksCount);
+
+    EXPECT_CALL(playlistIOMock, loadTracks).WillOnce(Return(newTracks));
+    EXPECT_CALL(playlistIOMock, save).Times(1).WillRepeatedly(Return(true));
+
+    Playlist playlist{ "TestName", "TestPath", tracksToLoad, playlistIOMock };
+    playlist.setCurrentTrackIndex(5);
+
+    const std::vector<std::size_t> indexesToMove{ 5, 2, 5 };
+    constexpr std::size_t moveToPosition{ 4 };
+    const auto mapping = playlist.moveTracks(indexesToMove, moveToPosition).mapping;
+
+    validateTracks(playlist,
+        { "NewTrack0", "NewTrack1", "NewTrack3", "NewTrack4", "NewTrack2", "NewTrack5", "NewTrack6",
+            "NewTrack7" });
+
+    EXPECT_EQ(2, mapping.first);
+    EXPECT_EQ(4, mapping.newIndexes.size());
+    EXPECT_EQ(0, mapping.map(0));
+    EXPECT_EQ(4, mapping.map(2));
+    EXPECT_EQ(2, mapping.map(3));
+    EXPECT_EQ(7, mapping.map(7));
+    EXPECT_EQ(5, playlist.getCurrentTrackIndex());
+}
+
+TEST_F(PlaylistTests, moveTracksReturnsContiguousRunMoves)
+{
+    const std::vector<QUrl> tracksToLoad{};
+    const auto newTracksCount{ 10 };
+    const auto newTracks = createTracks(newTracksCount);
+
+    EXPECT_CALL(playlistIOMock, loadTracks).WillOnce(Return(newTracks));
+    EXPECT_CALL(playlistIOMock, save).Times(1).WillRepeatedly(Return(true));
+
+    Playlist playlist{ "TestName", "TestPath", tracksToLoad, playlistIOMock };
+
+    std::vector<QString> expected;
+    for(const auto &track : playlist.getTracks())
+    {
+        expected.push_back(track.path.toString());
+    }
+
+    const auto moves = playlist.moveTracks({ 1, 2, 5, 8, 9 }, 4);
+
+    // Runs applied one after another give the same order
+    for(const auto &run : moves.runs)
+    {
+        std::vector<QString> block(expected.begin() + run.first, expected.begin() + run.first + run.count);
+        expected.erase(expected.begin() + run.first, expected.begin() + run.first + run.count);
+
+        const auto destination = run.destination > run.first ? run.destination - run.count : run.destination;
+        expected.insert(expected.begin() + destination, block.begin(), block.end());
+    }
+
+    EXPECT_EQ(3, moves.runs.size());
+    validateTracks(playlist, expected);
+}
+
+TEST_F(PlaylistTests, moveTracksUpdatesCurrentTrackIndex)
+{
+    const std::vector<QUrl> tracksToLoad{};
+    const auto newTracksCount{ 5 };
+    const auto newTracks = createTracks(newTracksCount);
+
+    EXPECT_CALL(playlistIOMock, loadTracks).WillOnce(Return(newTracks));
+    EXPECT_CALL(playlistIOMock, save).Times(1).WillRepeatedly(Return(true));
+
+    Playlist playlist{ "TestName", "TestPath", tracksToLoad, playlistIOMock };
+    playlist.setCurrentTrackIndex(3);
+
+    const std::vector<std::size_t> indexesToMove{ 3, 4 };
+    constexpr std::size_t moveToPosition{ 0 };
+    playlist.moveTracks(indexesToMove, moveToPosition);
+
+    validateTracks(playlist, { "NewTrack3", "NewTrack4", "NewTrack0", "NewTrack1", "NewTrack2" });
+    EXPECT_EQ(0, playlist.getCurrentTrackIndex());
+}
+
 TEST_F(PlaylistTests, getNextTrackIndexOnEmptyPlaylist)
 {
     const Playlist playlist{ "TestName", "TestPath", playlistIOMock };
@@ -271,12 +355,12 @@ TEST_F(PlaylistTests, removeDuplicates)
     EXPECT_EQ(0, playlist.getTrackCount());
 
     std::vector<PlaylistTrack> loadedTracks;
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(1), std::nullopt });
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(2), std::nullopt });
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(1), std::nullopt });
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(2), std::nullopt });
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(3), std::nullopt });
-    loadedTracks.emplace_back(PlaylistTrack{ QString{ "NewTrack%1" }.arg(1), std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack1" }, std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack2" }, std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack1" }, std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack2" }, std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack3" }, std::nullopt });
+    loadedTracks.emplace_back(PlaylistTrack{ TrackPath{ u"NewTrack1" }, std::nullopt });
 
     EXPECT_CALL(playlistIOMock, loadTracks(SizeIs(loadedTracks.size()))).WillOnce(Return(loadedTracks));
     EXPECT_CALL(playlistIOMock, save);
@@ -285,6 +369,40 @@ TEST_F(PlaylistTests, removeDuplicates)
     EXPECT_EQ(loadedTracks.size(), playlist.getTrackCount());
 
     EXPECT_CALL(playlistIOMock, save);
-    playlist.removeDuplicates();
+    const auto removed = playlist.removeDuplicates();
     EXPECT_EQ(3, playlist.getTrackCount());
+
+    ASSERT_EQ(2, removed.size());
+    EXPECT_EQ(2, removed[0].first);
+    EXPECT_EQ(2, removed[0].count);
+    EXPECT_EQ(5, removed[1].first);
+    EXPECT_EQ(1, removed[1].count);
+}
+
+TEST_F(PlaylistTests, resolveTracksLooksUpOnlyUnresolvedTracksInRange)
+{
+    MetaDataStore store;
+    const TrackPath resolvedPath{ u"/music/resolved.flac" };
+    store.acquire(resolvedPath, AudioMetaData{ "Title", "Artist", "Album", 1, 1, std::chrono::seconds{ 1 } });
+
+    std::vector<PlaylistTrack> tracks;
+    for(const auto *path : { u"/music/0.flac", u"/music/resolved.flac", u"/music/2.flac", u"/music/3.flac" })
+    {
+        tracks.emplace_back(PlaylistTrack{ TrackPath{ path }, store.acquireUnresolved(TrackPath{ path }) });
+    }
+
+    Playlist playlist{ "TestName", "TestPath", std::move(tracks), playlistIOMock };
+
+    EXPECT_CALL(playlistIOMock, resolveTracks(ElementsAre(TrackPath{ u"/music/0.flac" }, TrackPath{ u"/music/2.flac" })))
+        .WillOnce([&store](const std::vector<TrackPath> &paths)
+            {
+                for(const auto &path : paths)
+                {
+                    store.markResolved(path);
+                }
+            });
+
+    EXPECT_TRUE(playlist.resolveTracks(0, 3));
+    EXPECT_FALSE(playlist.resolveTracks(0, 3));
+    EXPECT_FALSE(playlist.resolveTracks(10, 3));
 }
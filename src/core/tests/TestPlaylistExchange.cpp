@@ -0,0 +1,177 @@
+#include "PlaylistExchange.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <vector>
+
+using namespace ::testing;
+
+struct PlaylistExchangeTests : Test
+{
+    QTemporaryDir directory{};
+
+    QString writePlaylist(const QString &name, const QByteArray &content)
+    {
+        const auto filepath = directory.filePath(name);
+
+        QFile playlistFile{ filepath };
+        EXPECT_TRUE(playlistFile.open(QIODevice::WriteOnly));
+        playlistFile.write(content);
+        return filepath;
+    }
+
+    static std::vector<ImportedTrack> readAll(PlaylistImporter &importer)
+    {
+        std::vector<ImportedTrack> tracks;
+        for(auto batch = importer.read(2); not batch.empty(); batch = importer.read(2))
+        {
+            EXPECT_LE(batch.size(), 2);
+            tracks.insert(tracks.end(), batch.begin(), batch.end());
+        }
+        return tracks;
+    }
+};
+
+TEST_F(PlaylistExchangeTests, formatIsRecognizedByExtension)
+{
+    EXPECT_EQ(PlaylistExchangeFormat::M3u, getPlaylistExchangeFormat("/a/b.m3u"));
+    EXPECT_EQ(PlaylistExchangeFormat::M3u, getPlaylistExchangeFormat("/a/b.M3U8"));
+    EXPECT_EQ(PlaylistExchangeFormat::Pls, getPlaylistExchangeFormat("/a/b.pls"));
+    EXPECT_EQ(PlaylistExchangeFormat::Xspf, getPlaylistExchangeFormat("/a/b.xspf"));
+    EXPECT_FALSE(getPlaylistExchangeFormat("/a/b"));
+}
+
+TEST_F(PlaylistExchangeTests, importsM3uWithHints)
+{
+    const auto filepath = writePlaylist("list.m3u8",
+        "#EXTM3U\n"
+        "#EXTINF:215 tvg-name=\"a,b\",Artist - Title\n"
+        "Music/01.flac\n"
+        "\n"
+        "..\\Other\\02.flac\n"
+        "/absolute/03.flac\n"
+        "https://example.com/stream\n");
+
+    PlaylistImporter importer{ filepath };
+    ASSERT_TRUE(importer.isOpen());
+
+    const auto tracks = readAll(importer);
+    ASSERT_EQ(4, tracks.size());
+
+    EXPECT_EQ(directory.filePath("Music/01.flac"), tracks[0].location.path);
+    EXPECT_TRUE(tracks[0].location.isLocalFile);
+    ASSERT_TRUE(tracks[0].hint);
+    EXPECT_EQ(QString{ "Title" }, tracks[0].hint->title);
+    EXPECT_EQ(QString{ "Artist" }, tracks[0].hint->artist);
+    EXPECT_EQ(std::chrono::seconds{ 215 }, tracks[0].hint->duration);
+
+    EXPECT_EQ(QDir::cleanPath(directory.filePath("../Other/02.flac")), tracks[1].location.path);
+    EXPECT_FALSE(tracks[1].hint);
+
+    EXPECT_EQ(QString{ "/absolute/03.flac" }, tracks[2].location.path);
+
+    EXPECT_EQ(QString{ "https://example.com/stream" }, tracks[3].location.path);
+    EXPECT_FALSE(tracks[3].location.isLocalFile);
+}
+
+TEST_F(PlaylistExchangeTests, importsPls)
+{
+    const auto filepath = writePlaylist("list.pls",
+        "[playlist]\n"
+        "File1=01.flac\n"
+        "Title1=First\n"
+        "Length1=100\n"
+        "File2=https://example.com/stream\n"
+        "Title2=Radio\n"
+        "Length2=-1\n"
+        "File3=/absolute/03.flac\n"
+        "NumberOfEntries=3\n"
+        "Version=2\n");
+
+    PlaylistImporter importer{ filepath };
+    const auto tracks = readAll(importer);
+    ASSERT_EQ(3, tracks.size());
+
+    EXPECT_EQ(directory.filePath("01.flac"), tracks[0].location.path);
+    ASSERT_TRUE(tracks[0].hint);
+    EXPECT_EQ(QString{ "First" }, tracks[0].hint->title);
+    EXPECT_EQ(std::chrono::seconds{ 100 }, tracks[0].hint->duration);
+
+    EXPECT_FALSE(tracks[1].location.isLocalFile);
+    ASSERT_TRUE(tracks[1].hint);
+    EXPECT_EQ(std::chrono::seconds{ 0 }, tracks[1].hint->duration);
+
+    EXPECT_EQ(QString{ "/absolute/03.flac" }, tracks[2].location.path);
+    EXPECT_FALSE(tracks[2].hint);
+}
+
+TEST_F(PlaylistExchangeTests, importsXspf)
+{
+    const auto filepath = writePlaylist("list.xspf", R"(<?xml version="1.0" encoding="UTF-8"?>
+<playlist version="1" xmlns="http://xspf.org/ns/0/">
+  <title>Ignored</title>
+  <trackList>
+    <track>
+      <location>Music/01%20One.flac</location>
+      <title>One</title>
+      <creator>Artist</creator>
+      <album>Album</album>
+      <trackNum>1</trackNum>
+      <duration>61000</duration>
+      <extension application="x"><title>Nested</title></extension>
+    </track>
+    <track><location>file:///absolute/02.flac</location></track>
+    <track><title>Without location</title></track>
+  </trackList>
+</playlist>
+)");
+
+    PlaylistImporter importer{ filepath };
+    const auto tracks = readAll(importer);
+    ASSERT_EQ(2, tracks.size());
+
+    EXPECT_EQ(directory.filePath("Music/01 One.flac"), tracks[0].location.path);
+    ASSERT_TRUE(tracks[0].hint);
+    EXPECT_EQ(QString{ "One" }, tracks[0].hint->title);
+    EXPECT_EQ(QString{ "Artist" }, tracks[0].hint->artist);
+    EXPECT_EQ(QString{ "Album" }, tracks[0].hint->albumName);
+    EXPECT_EQ(1, tracks[0].hint->trackNumber);
+    EXPECT_EQ(std::chrono::seconds{ 61 }, tracks[0].hint->duration);
+
+    EXPECT_EQ(QString{ "/absolute/02.flac" }, tracks[1].location.path);
+    EXPECT_FALSE(tracks[1].hint);
+}
+
+TEST_F(PlaylistExchangeTests, exportedPlaylistsCanBeImported)
+{
+    const std::vector<StoredTrack> tracks{
+        StoredTrack{ TrackPath{ "/music/01 Zażółć.flac" },
+            AudioMetaData{ "Title", "Artist", "Album", 1, 1, std::chrono::seconds{ 180 } } },
+        StoredTrack{ TrackPath{ "/music/02.flac" }, std::nullopt },
+    };
+
+    for(const auto *name : { "list.m3u8", "list.pls", "list.xspf" })
+    {
+        const auto filepath = directory.filePath(name);
+        ASSERT_TRUE(exportPlaylist(filepath, *getPlaylistExchangeFormat(filepath), tracks)) << name;
+
+        PlaylistImporter importer{ filepath };
+        const auto imported = readAll(importer);
+        ASSERT_EQ(tracks.size(), imported.size()) << name;
+
+        EXPECT_EQ(tracks[0].path.toString(), imported[0].location.path) << name;
+        ASSERT_TRUE(imported[0].hint) << name;
+        EXPECT_EQ(QString{ "Title" }, imported[0].hint->title) << name;
+        EXPECT_EQ(QString{ "Artist" }, imported[0].hint->artist) << name;
+        EXPECT_EQ(std::chrono::seconds{ 180 }, imported[0].hint->duration) << name;
+
+        EXPECT_EQ(tracks[1].path.toString(), imported[1].location.path) << name;
+        EXPECT_FALSE(imported[1].hint) << name;
+    }
+}
@@ -0,0 +1,136 @@
+#include "PlaylistFilterEngine.hpp"
+
+#include "MetaDataStore.hpp"
+#include "Playlist.hpp"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include <map>
+#include <mutex>
+
+using namespace ::testing;
+
+struct PlaylistFilterEngineTests : Test
+{
+    std::mutex mutex;
+    std::map<PlaylistFilterEngine::Generation, std::vector<std::size_t>> matches;
+    std::vector<PlaylistFilterEngine::Generation> finishedGenerations;
+
+    PlaylistFilterEngine engine{
+        [this](PlaylistFilterEngine::Generation generation, std::vector<std::size_t> chunk, bool finished)
+        {
+            std::lock_guard lock{ mutex };
+            auto &generationMatches = matches[generation];
+            generationMatches.insert(generationMatches.end(), chunk.cbegin(), chunk.cend());
+            if(finished) finishedGenerations.push_back(generation);
+        }
+    };
+
+    std::shared_ptr<const PlaylistFilterSnapshot> createSnapshot(std::size_t trackCount)
+    {
+        std::vector<PlaylistTrack> tracks;
+        for(std::size_t i = 0; i < trackCount; ++i)
+        {
+            const auto name = i % 3 == 0 ? QString{ "/music/match%1.flac" } :
+                                           QString{ "/music/other%1.flac" };
+            tracks.push_back(PlaylistTrack{ TrackPath{ name.arg(i) }, std::nullopt });
+        }
+
+        return PlaylistFilterEngine::createSnapshot(tracks);
+    }
+};
+
+TEST_F(PlaylistFilterEngineTests, matchesAreDeliveredInOrder)
+{
+    const auto snapshot = createSnapshot(50'000);
+
+    const auto generation = engine.filter(snapshot, FilterQuery{ "match" });
+    engine.waitForDone();
+
+    ASSERT_THAT(finishedGenerations, ElementsAre(generation));
+
+    const auto &generationMatches = matches[generation];
+    ASSERT_EQ(16'667, generationMatches.size());
+    EXPECT_TRUE(std::is_sorted(generationMatches.cbegin(), generationMatches.cend()));
+    EXPECT_TRUE(std::all_of(
+        generationMatches.cbegin(), generationMatches.cend(), [](auto i) { return i % 3 == 0; }));
+}
+
+TEST_F(PlaylistFilterEngineTests, emptySnapshotFinishes)
+{
+    const auto generation = engine.filter(createSnapshot(0), FilterQuery{ "match" });
+    engine.waitForDone();
+
+    EXPECT_THAT(finishedGenerations, ElementsAre(generation));
+    EXPECT_THAT(matches[generation], IsEmpty());
+}
+
+TEST_F(PlaylistFilterEngineTests, onlyCandidatesAreChecked)
+{
+    const auto snapshot = createSnapshot(10);
+
+    const auto generation = engine.filter(snapshot, FilterQuery{ "match" }, { 1, 3, 6, 7 });
+    engine.waitForDone();
+
+    EXPECT_THAT(matches[generation], ElementsAre(3, 6));
+}
+
+TEST_F(PlaylistFilterEngineTests, rangeSnapshotMatchesAreRelativeToItsFirstTrack)
+{
+    std::vector<PlaylistTrack> tracks;
+    for(const auto *name : { "/music/match.flac", "/music/other.flac", "/music/match.flac", "/music/other.flac" })
+    {
+        tracks.push_back(PlaylistTrack{ TrackPath{ QString{ name } }, std::nullopt });
+    }
+
+    const auto snapshot = PlaylistFilterEngine::createSnapshot(tracks, 1, 2);
+    ASSERT_EQ(2, snapshot->size());
+
+    const auto generation = engine.filter(snapshot, FilterQuery{ "match" });
+    engine.waitForDone();
+
+    EXPECT_THAT(matches[generation], ElementsAre(1));
+    EXPECT_THAT(*PlaylistFilterEngine::createSnapshot(tracks, 3, 5), SizeIs(1));
+}
+
+TEST_F(PlaylistFilterEngineTests, snapshotKeepsMetaDataOfItsTime)
+{
+    MetaDataStore store;
+    const TrackPath path{ u"/music/track.flac" };
+    const std::vector<PlaylistTrack> tracks{ PlaylistTrack{ path,
+        store.acquire(path, AudioMetaData{ "Before", "Artist", "Album", 1, 1, std::chrono::seconds{ 180 } }) } };
+
+    const auto snapshot = PlaylistFilterEngine::createSnapshot(tracks);
+    EXPECT_EQ(tracks[0].audioMetaData.getRecord()->values, snapshot->at(0).values);
+
+    store.update(path, AudioMetaData{ "After", "Artist", "Album", 1, 1, std::chrono::seconds{ 180 } });
+
+    const auto before = engine.filter(snapshot, FilterQuery{ "before" });
+    engine.waitForDone();
+    const auto after = engine.filter(PlaylistFilterEngine::createSnapshot(tracks), FilterQuery{ "before" });
+    engine.waitForDone();
+
+    EXPECT_THAT(matches[before], ElementsAre(0));
+    EXPECT_THAT(matches[after], IsEmpty());
+}
+
+TEST_F(PlaylistFilterEngineTests, newQueryCancelsPrevious)
+{
+    const auto snapshot = createSnapshot(50'000);
+
+    const auto previous = engine.filter(snapshot, FilterQuery{ "other" });
+    const auto current = engine.filter(snapshot, FilterQuery{ "match1" });
+    engine.waitForDone();
+
+    EXPECT_FALSE(engine.isCurrent(previous));
+    EXPECT_TRUE(engine.isCurrent(current));
+    EXPECT_THAT(finishedGenerations, Contains(current));
+
+    const auto &currentMatches = matches[current];
+    EXPECT_THAT(currentMatches, Not(IsEmpty()));
+    EXPECT_TRUE(std::all_of(
+        currentMatches.cbegin(), currentMatches.cend(), [](auto i) { return i % 3 == 0; }));
+}
@@ -0,0 +1,103 @@
+#include "PlaylistJournal.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <optional>
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+const QByteArray playlistContent{ "/music/a.flac\n/music/b.flac\n/music/c.flac\n" };
+
+QString toString(const TrackPath &path)
+{
+    return path.toString();
+}
+} // namespace
+
+struct PlaylistJournalTests : Test
+{
+    QTemporaryDir directory{};
+    QString playlistPath{ directory.filePath("Playlist") };
+
+    std::vector<QString> paths{ "/music/a.flac", "/music/b.flac", "/music/c.flac" };
+
+    PlaylistJournalTests()
+    {
+        writePlaylist(playlistContent);
+    }
+
+    void writePlaylist(const QByteArray &content)
+    {
+        QFile playlistFile{ playlistPath };
+        ASSERT_TRUE(playlistFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        playlistFile.write(content);
+    }
+};
+
+TEST_F(PlaylistJournalTests, journalIsHidden)
+{
+    EXPECT_EQ(directory.filePath(".Playlist.journal"), getPlaylistJournalPath(playlistPath));
+}
+
+TEST_F(PlaylistJournalTests, replayAppliesChangesInOrder)
+{
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath,
+        { PlaylistInsertion{ 1, { TrackPath{ "/music/d.flac" }, TrackPath{ "/music/e.flac" } } },
+            PlaylistRemoval{ 0, 1 } }));
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistMove{ { 3 }, 0 } }));
+
+    EXPECT_THAT(replayPlaylistJournal(playlistPath, playlistContent, paths, &toString), Optional(4));
+    EXPECT_THAT(paths, ElementsAre("/music/c.flac", "/music/d.flac", "/music/e.flac", "/music/b.flac"));
+}
+
+TEST_F(PlaylistJournalTests, journalOfDifferentContentIsIgnored)
+{
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistRemoval{ 0, 1 } }));
+
+    // Playlist was compacted, but the journal was not removed
+    const QByteArray compactedContent{ "/music/b.flac\n/music/c.flac\n" };
+    writePlaylist(compactedContent);
+    paths.erase(paths.begin());
+
+    // Appended changes would follow the stale ones, the playlist has to be written in full
+    EXPECT_EQ(std::nullopt, replayPlaylistJournal(playlistPath, compactedContent, paths, &toString));
+    EXPECT_THAT(paths, ElementsAre("/music/b.flac", "/music/c.flac"));
+}
+
+TEST_F(PlaylistJournalTests, replayStopsAtTruncatedRecord)
+{
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistRemoval{ 0, 1 } }));
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistRemoval{ 0, 1 } }));
+
+    QFile journal{ getPlaylistJournalPath(playlistPath) };
+    ASSERT_TRUE(journal.resize(journal.size() - 1));
+
+    EXPECT_THAT(replayPlaylistJournal(playlistPath, playlistContent, paths, &toString), Optional(1));
+    EXPECT_THAT(paths, ElementsAre("/music/b.flac", "/music/c.flac"));
+}
+
+TEST_F(PlaylistJournalTests, changesAppendedAfterTruncatedRecordAreReplayed)
+{
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistRemoval{ 0, 1 } }));
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistRemoval{ 0, 1 } }));
+
+    QFile journal{ getPlaylistJournalPath(playlistPath) };
+    ASSERT_TRUE(journal.resize(journal.size() - 1));
+
+    auto replayed = paths;
+    ASSERT_THAT(replayPlaylistJournal(playlistPath, playlistContent, replayed, &toString), Optional(1));
+
+    ASSERT_TRUE(appendPlaylistJournal(playlistPath, { PlaylistInsertion{ 0, { TrackPath{ "/music/d.flac" } } } }));
+
+    EXPECT_THAT(replayPlaylistJournal(playlistPath, playlistContent, paths, &toString), Optional(2));
+    EXPECT_THAT(paths, ElementsAre("/music/d.flac", "/music/b.flac", "/music/c.flac"));
+}
@@ -0,0 +1,184 @@
+#include "PlaylistManager.hpp"
+
+#include "mocks/PlaylistIOMock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+
+#include <optional>
+#include <vector>
+
+using namespace ::testing;
+
+struct PlaylistManagerTests : Test
+{
+    QTemporaryDir directory{};
+    StrictMock<PlaylistIOMock> playlistIOMock{};
+
+    PlaylistManagerTests()
+    {
+        for(const auto *name : { "Second", "First", "Third" })
+        {
+            QFile playlistFile{ directory.filePath(name) };
+            EXPECT_TRUE(playlistFile.open(QIODevice::WriteOnly));
+        }
+    }
+
+    // Every playlist has as many tracks as letters in its name
+    Playlist createPlaylist(const QString &filepath)
+    {
+        const auto playlistName = QFileInfo{ filepath }.completeBaseName();
+        std::vector<PlaylistTrack> tracks(playlistName.size());
+        return Playlist{ playlistName, filepath, std::move(tracks), playlistIOMock };
+    }
+
+    void expectLoad(const QString &name)
+    {
+        EXPECT_CALL(playlistIOMock, load(directory.filePath(name)))
+            .WillOnce([this](const QString &filepath) { return createPlaylist(filepath); });
+    }
+
+    void expectLoadAll(const std::vector<QString> &names)
+    {
+        std::vector<QString> filepaths;
+        for(const auto &name : names)
+        {
+            filepaths.push_back(directory.filePath(name));
+        }
+
+        EXPECT_CALL(playlistIOMock, loadAll(filepaths))
+            .WillOnce(
+                [this](const std::vector<QString> &paths)
+                {
+                    std::vector<std::optional<Playlist>> playlists;
+                    for(const auto &filepath : paths)
+                    {
+                        playlists.emplace_back(createPlaylist(filepath));
+                    }
+                    return playlists;
+                });
+    }
+
+    static std::vector<QString> getNames(const std::vector<PlaylistInfo> &infos)
+    {
+        std::vector<QString> names;
+        for(const auto &info : infos)
+        {
+            names.push_back(info.name);
+        }
+        return names;
+    }
+};
+
+TEST_F(PlaylistManagerTests, playlistsAreListedWithoutLoading)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+
+    const auto infos = manager.getPlaylistInfos();
+    EXPECT_THAT(getNames(infos), ElementsAre("First", "Second", "Third"));
+
+    for(const auto &info : infos)
+    {
+        EXPECT_FALSE(info.isLoaded);
+        EXPECT_FALSE(info.trackCount);
+    }
+}
+
+TEST_F(PlaylistManagerTests, playlistIsLoadedOnFirstAccess)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+    const auto id = manager.findByName("Second");
+    ASSERT_TRUE(id);
+
+    expectLoad("Second");
+
+    auto *playlist = manager.get(*id);
+    ASSERT_NE(nullptr, playlist);
+    EXPECT_EQ(QString{ "Second" }, playlist->getName());
+    EXPECT_EQ(id->value, playlist->getPlaylistId().value);
+
+    EXPECT_EQ(playlist, manager.get(*id));
+}
+
+TEST_F(PlaylistManagerTests, remainingPlaylistsAreLoadedInOrder)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+
+    expectLoad("Second");
+    manager.get(*manager.findByName("Second"));
+
+    InSequence s{};
+    expectLoad("First");
+    expectLoad("Third");
+
+    EXPECT_EQ(manager.findByName("First")->value, manager.loadNext()->value);
+    EXPECT_EQ(manager.findByName("Third")->value, manager.loadNext()->value);
+    EXPECT_FALSE(manager.loadNext());
+}
+
+TEST_F(PlaylistManagerTests, remainingPlaylistsAreLoadedTogether)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+
+    expectLoad("Second");
+    manager.get(*manager.findByName("Second"));
+
+    EXPECT_CALL(playlistIOMock,
+        loadAll(ElementsAre(directory.filePath("First"), directory.filePath("Third"))))
+        .WillOnce(
+            [this](const std::vector<QString> &paths)
+            {
+                std::vector<std::optional<Playlist>> playlists;
+                playlists.emplace_back(std::nullopt);
+                playlists.emplace_back(createPlaylist(paths[1]));
+                return playlists;
+            });
+
+    manager.loadAll();
+
+    const auto infos = manager.getPlaylistInfos();
+    EXPECT_THAT(getNames(infos), ElementsAre("Second", "Third"));
+
+    const auto *third = manager.get(infos[1].id);
+    ASSERT_NE(nullptr, third);
+    EXPECT_EQ(infos[1].id.value, third->getPlaylistId().value);
+    EXPECT_FALSE(manager.loadNext());
+}
+
+TEST_F(PlaylistManagerTests, trackCountsAreKnownFromManifest)
+{
+    {
+        PlaylistManager manager{ playlistIOMock, directory.path() };
+
+        expectLoadAll({ "First", "Second", "Third" });
+        EXPECT_EQ(3, manager.getAll().size());
+
+        ASSERT_TRUE(manager.saveManifest());
+    }
+
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+
+    std::vector<std::optional<std::size_t>> trackCounts;
+    for(const auto &info : manager.getPlaylistInfos())
+    {
+        trackCounts.push_back(info.trackCount);
+    }
+
+    EXPECT_THAT(trackCounts, ElementsAre(5, 6, 5));
+}
+
+TEST_F(PlaylistManagerTests, pendingPlaylistIsRemovedWithoutLoading)
+{
+    PlaylistManager manager{ playlistIOMock, directory.path() };
+
+    EXPECT_CALL(playlistIOMock, remove(Property(&Playlist::getPath, directory.filePath("Third"))))
+        .WillOnce(Return(true));
+
+    manager.removeByName("Third");
+
+    EXPECT_THAT(getNames(manager.getPlaylistInfos()), ElementsAre("First", "Second"));
+}
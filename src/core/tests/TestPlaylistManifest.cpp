@@ -0,0 +1,60 @@
+#include "PlaylistJournal.hpp"
+#include "PlaylistManifest.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+using namespace ::testing;
+
+struct PlaylistManifestTests : Test
+{
+    QTemporaryDir directory{};
+    QDir playlistDirectory{ directory.path() };
+
+    QString writePlaylist(const QString &name, const QByteArray &content)
+    {
+        const auto filepath = playlistDirectory.absoluteFilePath(name);
+
+        QFile playlistFile{ filepath };
+        EXPECT_TRUE(playlistFile.open(QIODevice::WriteOnly | QIODevice::Append));
+        playlistFile.write(content);
+        return filepath;
+    }
+};
+
+TEST_F(PlaylistManifestTests, trackCountsAreRead)
+{
+    const auto first = writePlaylist("First", "/a.flac\n/b.flac\n");
+    const auto second = writePlaylist("Second name", "");
+
+    ASSERT_TRUE(writePlaylistManifest(playlistDirectory, { { first, 2 }, { second, 0 } }));
+
+    EXPECT_THAT(readPlaylistManifest(playlistDirectory),
+        UnorderedElementsAre(Pair(first, 2), Pair(second, 0)));
+}
+
+TEST_F(PlaylistManifestTests, modifiedPlaylistsAreLeftOut)
+{
+    const auto changed = writePlaylist("Changed", "/a.flac\n");
+    const auto journaled = writePlaylist("Journaled", "/a.flac\n");
+    const auto unchanged = writePlaylist("Unchanged", "/a.flac\n");
+
+    ASSERT_TRUE(writePlaylistManifest(playlistDirectory, { { changed, 1 }, { journaled, 1 }, { unchanged, 1 } }));
+
+    writePlaylist("Changed", "/b.flac\n");
+    ASSERT_TRUE(appendPlaylistJournal(journaled, { PlaylistRemoval{ 0, 1 } }));
+
+    EXPECT_THAT(readPlaylistManifest(playlistDirectory), ElementsAre(Pair(unchanged, 1)));
+}
+
+TEST_F(PlaylistManifestTests, missingManifestIsEmpty)
+{
+    writePlaylist("Playlist", "/a.flac\n");
+
+    EXPECT_TRUE(readPlaylistManifest(playlistDirectory).empty());
+}
@@ -0,0 +1,134 @@
+#include "PlaylistSaveScheduler.hpp"
+
+#include "Playlist.hpp"
+#include "mocks/PlaylistIOMock.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QString>
+#include <QUrl>
+
+#include <mutex>
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+std::vector<PlaylistTrack> createTracks(std::size_t count)
+{
+    std::vector<PlaylistTrack> tracks;
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        tracks.emplace_back(PlaylistTrack{ TrackPath{ QString{ "/music/%1.flac" }.arg(i) }, std::nullopt });
+    }
+    return tracks;
+}
+} // namespace
+
+struct PlaylistSaveSchedulerTests : Test
+{
+    // Scheduler timer needs an event dispatcher
+    char applicationName[11]{ "core-tests" };
+    char *argv[2]{ applicationName, nullptr };
+    int argc{ 1 };
+    QCoreApplication application{ argc, argv };
+
+    NiceMock<PlaylistIOMock> playlistIOMock{};
+
+    std::mutex mutex;
+    std::vector<std::pair<QString, std::size_t>> writes;
+    std::vector<std::pair<QString, std::size_t>> appends;
+
+    PlaylistSaveScheduler scheduler{
+        [this](const QString &filepath, const std::vector<StoredTrack> &tracks)
+        {
+            std::lock_guard lock{ mutex };
+            writes.emplace_back(filepath, tracks.size());
+            return true;
+        },
+        [this](const QString &filepath, const std::vector<PlaylistChange> &changes)
+        {
+            std::lock_guard lock{ mutex };
+            appends.emplace_back(filepath, changes.size());
+            return true;
+        },
+        std::chrono::hours{ 1 },
+    };
+
+    PlaylistSaveSchedulerTests()
+    {
+        ON_CALL(playlistIOMock, loadTracks).WillByDefault(Return(createTracks(3)));
+    }
+};
+
+TEST_F(PlaylistSaveSchedulerTests, changesAreCoalescedIntoJournal)
+{
+    const Playlist playlist{ "Name", "Path", std::vector<QUrl>{}, playlistIOMock };
+
+    scheduler.schedule(playlist, PlaylistRemoval{ 0, 1 });
+    scheduler.schedule(playlist, PlaylistMove{ { 0 }, 1 });
+    EXPECT_TRUE(scheduler.isPending(playlist));
+
+    scheduler.flushAll();
+
+    EXPECT_FALSE(scheduler.isPending(playlist));
+    EXPECT_THAT(appends, ElementsAre(Pair(QString{ "Path" }, 2)));
+    EXPECT_THAT(writes, IsEmpty());
+}
+
+TEST_F(PlaylistSaveSchedulerTests, resetWritesWholePlaylist)
+{
+    const Playlist playlist{ "Name", "Path", std::vector<QUrl>{}, playlistIOMock };
+
+    scheduler.schedule(playlist, PlaylistRemoval{ 0, 1 });
+    scheduler.schedule(playlist, PlaylistReset{});
+    scheduler.flushAll();
+
+    EXPECT_THAT(appends, IsEmpty());
+    EXPECT_THAT(writes, ElementsAre(Pair(QString{ "Path" }, 3)));
+}
+
+TEST_F(PlaylistSaveSchedulerTests, largeJournalIsCompacted)
+{
+    const Playlist playlist{ "Name", "Path", std::vector<QUrl>{}, playlistIOMock };
+
+    scheduler.setJournalSize("Path", 4096);
+    scheduler.schedule(playlist, PlaylistRemoval{ 0, 1 });
+    scheduler.flushAll();
+
+    EXPECT_THAT(writes, ElementsAre(Pair(QString{ "Path" }, 3)));
+
+    scheduler.schedule(playlist, PlaylistRemoval{ 0, 1 });
+    scheduler.flushAll();
+
+    EXPECT_THAT(appends, ElementsAre(Pair(QString{ "Path" }, 1)));
+}
+
+TEST_F(PlaylistSaveSchedulerTests, cancelDropsPendingSave)
+{
+    const Playlist playlist{ "Name", "Path", std::vector<QUrl>{}, playlistIOMock };
+
+    scheduler.schedule(playlist, PlaylistRemoval{ 0, 1 });
+    scheduler.cancel(playlist);
+    scheduler.flushAll();
+
+    EXPECT_THAT(writes, IsEmpty());
+    EXPECT_THAT(appends, IsEmpty());
+}
+
+TEST_F(PlaylistSaveSchedulerTests, compactWritesOnlyGivenPlaylist)
+{
+    const Playlist first{ "First", "FirstPath", std::vector<QUrl>{}, playlistIOMock };
+    const Playlist second{ "Second", "SecondPath", std::vector<QUrl>{}, playlistIOMock };
+
+    scheduler.schedule(first, PlaylistRemoval{ 0, 1 });
+    scheduler.schedule(second, PlaylistRemoval{ 0, 1 });
+    scheduler.compact(second);
+
+    EXPECT_THAT(writes, ElementsAre(Pair(QString{ "SecondPath" }, 3)));
+    EXPECT_TRUE(scheduler.isPending(first));
+
+    scheduler.cancel(first);
+}
@@ -0,0 +1,113 @@
+#include "MetaDataStore.hpp"
+#include "Playlist.hpp"
+#include "PlaylistSort.hpp"
+
+#include "mocks/PlaylistIOMock.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QString>
+
+#include <vector>
+
+using namespace ::testing;
+
+struct PlaylistSortTests : Test
+{
+    MetaDataStore store{};
+    StrictMock<PlaylistIOMock> playlistIOMock{};
+
+    PlaylistTrack createTrack(QString path, QString artist, QString album, int trackNumber, QString title)
+    {
+        const TrackPath trackPath{ path };
+        return PlaylistTrack{ trackPath,
+            store.acquire(trackPath,
+                AudioMetaData{ std::move(title), std::move(artist), std::move(album), 1, trackNumber,
+                    std::chrono::seconds{ 60 * trackNumber } }) };
+    }
+
+    std::vector<PlaylistTrack> createTracks()
+    {
+        return {
+            createTrack("/b/2.flac", "Beta", "Second", 2, "Two"),
+            createTrack("/a/2.flac", "Alpha", "First", 2, "Two"),
+            createTrack("/b/1.flac", "Beta", "Second", 1, "One"),
+            createTrack("/a/1.flac", "Alpha", "First", 1, "One"),
+            PlaylistTrack{ TrackPath{ u"/c/Untitled.flac" }, std::nullopt },
+        };
+    }
+
+    static std::vector<QString> getPaths(const Playlist &playlist)
+    {
+        std::vector<QString> paths;
+        for(const auto &track : playlist.getTracks())
+        {
+            paths.push_back(track.path.toString());
+        }
+        return paths;
+    }
+};
+
+TEST_F(PlaylistSortTests, sortsByMultipleKeys)
+{
+    const auto tracks = createTracks();
+
+    const auto order = sortPlaylistTracks(tracks,
+        { { PlaylistSortKey::Artist }, { PlaylistSortKey::Album }, { PlaylistSortKey::TrackNumber } });
+
+    // Track without metadata has an empty artist
+    EXPECT_THAT(order, ElementsAre(4, 3, 1, 2, 0));
+}
+
+TEST_F(PlaylistSortTests, equalTracksKeepTheirOrder)
+{
+    const auto tracks = createTracks();
+
+    EXPECT_THAT(sortPlaylistTracks(tracks, { { PlaylistSortKey::Title, Qt::DescendingOrder } }),
+        ElementsAre(4, 0, 1, 2, 3));
+    EXPECT_THAT(sortPlaylistTracks(tracks, { { PlaylistSortKey::Path } }), ElementsAre(3, 1, 2, 0, 4));
+}
+
+TEST_F(PlaylistSortTests, sortKeysAreResetOnMetaDataChange)
+{
+    const auto tracks = createTracks();
+    const auto *record = tracks[0].audioMetaData.getRecord();
+
+    (void)sortPlaylistTracks(tracks, { { PlaylistSortKey::Artist } });
+    EXPECT_TRUE(record->sortKeys);
+
+    ASSERT_TRUE(store.update(tracks[0].path, AudioMetaData{ "Two", "Aardvark", "Second", 1, 2, {} }));
+    EXPECT_FALSE(record->sortKeys);
+
+    EXPECT_THAT(sortPlaylistTracks(tracks, { { PlaylistSortKey::Artist } }), ElementsAre(4, 0, 1, 3, 2));
+}
+
+TEST_F(PlaylistSortTests, playlistSortIsAppliedAsPermutation)
+{
+    Playlist playlist{ "TestName", "TestPath", createTracks(), playlistIOMock };
+    playlist.setCurrentTrackIndex(2);
+
+    EXPECT_CALL(playlistIOMock, save(_, VariantWith<PlaylistReset>(_))).WillOnce(Return(true));
+
+    const auto mapping = playlist.sortTracks({ { PlaylistSortKey::Path } });
+
+    EXPECT_THAT(getPaths(playlist),
+        ElementsAre("/a/1.flac", "/a/2.flac", "/b/1.flac", "/b/2.flac", "/c/Untitled.flac"));
+    EXPECT_EQ(2, playlist.getCurrentTrackIndex());
+    EXPECT_EQ(3, mapping.map(0));
+    EXPECT_EQ(0, mapping.map(3));
+    EXPECT_EQ(4, mapping.map(4));
+}
+
+TEST_F(PlaylistSortTests, sortedPlaylistIsNotSaved)
+{
+    Playlist playlist{ "TestName", "TestPath", createTracks(), playlistIOMock };
+
+    EXPECT_CALL(playlistIOMock, save).Times(1).WillRepeatedly(Return(true));
+
+    playlist.sortTracks({ { PlaylistSortKey::Path } });
+    const auto mapping = playlist.sortTracks({ { PlaylistSortKey::Path } });
+
+    EXPECT_TRUE(mapping.newIndexes.empty());
+}
@@ -0,0 +1,55 @@
+#include "PlaylistTextParser.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QByteArray>
+#include <QString>
+
+using namespace ::testing;
+
+TEST(PlaylistTextParserTests, splitsLines)
+{
+    const QByteArray content{ "/music/a.flac\n\n/music/b.flac\r\n/music/c.flac" };
+
+    EXPECT_THAT(parseTextPlaylist(content), ElementsAre("/music/a.flac", "/music/b.flac", "/music/c.flac"));
+}
+
+TEST(PlaylistTextParserTests, splitsLinesAcrossVectorBlocks)
+{
+    QByteArray content;
+    std::vector<QString> expected;
+
+    for(int i = 0; i < 100; ++i)
+    {
+        const auto line = QString{ "/music/%1/%2.flac" }.arg(QString(i, u'x')).arg(i);
+        content += line.toUtf8() + (i % 3 == 0 ? "\r\n" : "\n");
+        expected.push_back(line);
+    }
+
+    EXPECT_EQ(expected, parseTextPlaylist(content));
+}
+
+TEST(PlaylistTextParserTests, decodesUtf8)
+{
+    const QByteArray content{ "/music/Zażółć gęślą jaźń.flac\n" };
+
+    EXPECT_THAT(parseTextPlaylist(content), ElementsAre(QString{ "/music/Zażółć gęślą jaźń.flac" }));
+}
+
+TEST(PlaylistTextParserTests, emptyContent)
+{
+    EXPECT_THAT(parseTextPlaylist(QByteArray{}), IsEmpty());
+    EXPECT_THAT(parseTextPlaylist(QByteArray{ "\n\r\n\n" }), IsEmpty());
+}
+
+TEST(PlaylistTextParserTests, absoluteLocalPaths)
+{
+    EXPECT_TRUE(isAbsoluteLocalPath(u"/music/a.flac"));
+    EXPECT_TRUE(isAbsoluteLocalPath(u"C:/music/a.flac"));
+
+    EXPECT_FALSE(isAbsoluteLocalPath(u"file:///music/a.flac"));
+    EXPECT_FALSE(isAbsoluteLocalPath(u"https://example.com/stream"));
+    EXPECT_FALSE(isAbsoluteLocalPath(u"music/a.flac"));
+    EXPECT_FALSE(isAbsoluteLocalPath(u"C:\\music\\a.flac"));
+}
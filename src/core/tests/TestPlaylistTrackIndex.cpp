@@ -0,0 +1,173 @@
+#include "Playlist.hpp"
+#include "PlaylistTrackIndex.hpp"
+
+#include "mocks/PlaylistIOMock.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <QString>
+#include <QUrl>
+
+#include <vector>
+
+using namespace ::testing;
+
+namespace
+{
+std::vector<PlaylistTrack> createTracks(const std::vector<QString> &paths)
+{
+    std::vector<PlaylistTrack> tracks;
+    for(const auto &path : paths)
+    {
+        tracks.push_back(PlaylistTrack{ TrackPath{ path }, std::nullopt });
+    }
+    return tracks;
+}
+
+std::vector<QUrl> createUrls(const std::vector<QString> &paths)
+{
+    std::vector<QUrl> urls;
+    for(const auto &path : paths)
+    {
+        urls.push_back(QUrl::fromLocalFile(path));
+    }
+    return urls;
+}
+} // namespace
+
+struct PlaylistTrackIndexTests : Test
+{
+    PlaylistTrackIndex index{};
+    NiceMock<PlaylistIOMock> playlistIOMock{};
+
+    PlaylistTrackIndexTests()
+    {
+        // Index follows saved changes, as it does for playlists of PlaylistManager
+        ON_CALL(playlistIOMock, save)
+            .WillByDefault(
+                [this](const Playlist &playlist, const PlaylistChange &change)
+                {
+                    index.update(playlist, change);
+                    return true;
+                });
+
+        ON_CALL(playlistIOMock, loadTracks)
+            .WillByDefault(
+                [](const std::vector<QUrl> &urls)
+                {
+                    std::vector<QString> paths;
+                    for(const auto &url : urls)
+                    {
+                        paths.push_back(url.toLocalFile());
+                    }
+                    return createTracks(paths);
+                });
+    }
+
+    Playlist createPlaylist(std::uint32_t id, const std::vector<QString> &paths)
+    {
+        Playlist playlist{ "TestName", "TestPath", createTracks(paths), playlistIOMock };
+        playlist.setPlaylistId(PlaylistId{ id });
+        index.add(playlist);
+        return playlist;
+    }
+
+    // Positions of every track of the playlist are compared with the index
+    void validateIndex(const Playlist &playlist)
+    {
+        const auto &tracks = playlist.getTracks();
+        for(std::size_t position = 0; position < tracks.size(); ++position)
+        {
+            const auto found = index.find(tracks[position].path);
+            ASSERT_EQ(1, found.size());
+
+            std::vector<std::size_t> expected;
+            for(std::size_t i = 0; i < tracks.size(); ++i)
+            {
+                if(tracks[i].path == tracks[position].path)
+                {
+                    expected.push_back(i);
+                }
+            }
+
+            EXPECT_EQ(expected, found[0].positions) << tracks[position].path.toString().toStdString();
+        }
+    }
+};
+
+TEST_F(PlaylistTrackIndexTests, findsPositionsInAllPlaylists)
+{
+    const auto first = createPlaylist(2, { "/a.flac", "/b.flac", "/a.flac" });
+    const auto second = createPlaylist(1, { "/c.flac", "/a.flac" });
+
+    const auto found = index.find(TrackPath{ u"/a.flac" });
+    ASSERT_EQ(2, found.size());
+    EXPECT_EQ(1, found[0].playlistId.value);
+    EXPECT_THAT(found[0].positions, ElementsAre(1));
+    EXPECT_EQ(2, found[1].playlistId.value);
+    EXPECT_THAT(found[1].positions, ElementsAre(0, 2));
+
+    EXPECT_TRUE(index.find(TrackPath{ u"/d.flac" }).empty());
+    EXPECT_FALSE(index.contains(TrackPath{ u"/d.flac" }));
+}
+
+TEST_F(PlaylistTrackIndexTests, positionsFollowPlaylistChanges)
+{
+    auto playlist = createPlaylist(1, { "/a.flac", "/b.flac", "/c.flac", "/a.flac", "/d.flac" });
+
+    playlist.insertTracks(1, createUrls({ "/e.flac", "/a.flac" }));
+    validateIndex(playlist);
+
+    playlist.insertTracks(createUrls({ "/b.flac" }));
+    validateIndex(playlist);
+
+    playlist.moveTracks({ 0, 4 }, 6);
+    validateIndex(playlist);
+
+    playlist.removeTracks(1, 3);
+    validateIndex(playlist);
+
+    playlist.removeDuplicates();
+    validateIndex(playlist);
+}
+
+TEST_F(PlaylistTrackIndexTests, removedTracksAreNotFound)
+{
+    auto playlist = createPlaylist(1, { "/a.flac", "/b.flac", "/c.flac" });
+    const auto other = createPlaylist(2, { "/b.flac" });
+
+    playlist.removeTracks(1, 1);
+
+    EXPECT_THAT(index.find(TrackPath{ u"/c.flac" }).at(0).positions, ElementsAre(1));
+    ASSERT_EQ(1, index.find(TrackPath{ u"/b.flac" }).size());
+
+    index.remove(PlaylistId{ 2 });
+    EXPECT_FALSE(index.contains(TrackPath{ u"/b.flac" }));
+    EXPECT_TRUE(index.contains(TrackPath{ u"/a.flac" }));
+}
+
+TEST_F(PlaylistTrackIndexTests, positionsFollowManyShiftingChanges)
+{
+    auto playlist = createPlaylist(1, { "/a.flac", "/b.flac", "/c.flac" });
+
+    for(int i = 0; i < 150; ++i)
+    {
+        playlist.insertTracks(static_cast<std::size_t>(i % 3), createUrls({ QString{ "/%1.flac" }.arg(i % 7) }));
+        if(i % 2 == 0)
+        {
+            playlist.removeTracks(playlist.getTrackCount() / 2, 1);
+        }
+
+        if(i % 50 == 0)
+        {
+            validateIndex(playlist);
+        }
+    }
+
+    validateIndex(playlist);
+
+    playlist.removeTracks(0, playlist.getTrackCount());
+    EXPECT_FALSE(index.contains(TrackPath{ u"/1.flac" }));
+    EXPECT_TRUE(index.find(TrackPath{ u"/1.flac" }).empty());
+}
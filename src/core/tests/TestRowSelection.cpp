@@ -0,0 +1,82 @@
+#include "RowSelection.hpp"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace ::testing;
+
+namespace
+{
+auto rangeIs(std::size_t first, std::size_t count)
+{
+    return AllOf(Field(&TrackRange::first, first), Field(&TrackRange::count, count));
+}
+} // namespace
+
+TEST(RowSelectionTests, rowsAreKeptAsDisjointRanges)
+{
+    RowSelection selection;
+    selection.select(2);
+    selection.toggle(3);
+    selection.toggle(5);
+    selection.toggle(4);
+
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(2, 4)));
+
+    selection.toggle(3);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(2, 1), rangeIs(4, 2)));
+    EXPECT_FALSE(selection.contains(3));
+    EXPECT_TRUE(selection.contains(5));
+    EXPECT_EQ(3, selection.getCurrent());
+
+    selection.extendTo(0);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(0, 4)));
+    EXPECT_EQ(0, selection.getCurrent());
+}
+
+TEST(RowSelectionTests, selectionFollowsInsertedAndRemovedRows)
+{
+    RowSelection selection;
+    selection.select(2);
+    selection.extendTo(5);
+
+    selection.insertRows(4, 2);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(2, 2), rangeIs(6, 2)));
+    EXPECT_EQ(7, selection.getCurrent());
+
+    selection.removeRows(3, 4);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(2, 2)));
+    EXPECT_EQ(3, selection.getCurrent());
+}
+
+TEST(RowSelectionTests, movedRowsStaySelected)
+{
+    RowSelection selection;
+    selection.select(1);
+    selection.toggle(2);
+    selection.toggle(8);
+
+    // Rows 1 and 2 in front of row 6
+    selection.moveRows(TrackRunMove{ 1, 2, 6 });
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(4, 2), rangeIs(8, 1)));
+    EXPECT_EQ(8, selection.getCurrent());
+
+    // Row 8 in front of row 0
+    selection.moveRows(TrackRunMove{ 8, 1, 0 });
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(0, 1), rangeIs(5, 2)));
+    EXPECT_EQ(0, selection.getCurrent());
+}
+
+TEST(RowSelectionTests, assignedRowsAreMerged)
+{
+    RowSelection selection;
+    selection.select(1);
+
+    selection.assign({ 7, 3, 4, 9, 8 }, 4, 9);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(3, 2), rangeIs(7, 3)));
+    EXPECT_EQ(4, selection.getCurrent());
+    EXPECT_EQ(9, selection.getAnchor());
+
+    selection.extendTo(7);
+    EXPECT_THAT(selection.getRanges(), ElementsAre(rangeIs(7, 3)));
+}
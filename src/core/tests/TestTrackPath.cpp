@@ -0,0 +1,76 @@
+#include "TrackPath.hpp"
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+using namespace ::testing;
+
+TEST(TrackPathTests, splitsDirectoryAndFileName)
+{
+    const TrackPath path{ u"/music/album/01 - track.flac" };
+
+    EXPECT_EQ(QString{ "/music/album/" }, path.getDirectory());
+    EXPECT_EQ(QString{ "01 - track.flac" }, path.getFileName());
+    EXPECT_EQ(QString{ "/music/album/01 - track.flac" }, path.toString());
+}
+
+TEST(TrackPathTests, pathWithoutDirectory)
+{
+    const TrackPath path{ u"track.mp3" };
+
+    EXPECT_EQ(0, path.getDirectoryId());
+    EXPECT_TRUE(path.getDirectory().isEmpty());
+    EXPECT_EQ(QString{ "track.mp3" }, path.toString());
+}
+
+TEST(TrackPathTests, emptyPath)
+{
+    EXPECT_TRUE(TrackPath{}.isEmpty());
+    EXPECT_TRUE(TrackPath{ u"" }.isEmpty());
+    EXPECT_FALSE(TrackPath{ u"/" }.isEmpty());
+}
+
+TEST(TrackPathTests, tracksShareDirectory)
+{
+    const TrackPath first{ u"/music/shared/first.flac" };
+    const auto directoryCount = TrackPath::getDirectoryCount();
+    const TrackPath second{ u"/music/shared/second.flac" };
+
+    EXPECT_EQ(first.getDirectoryId(), second.getDirectoryId());
+    EXPECT_EQ(directoryCount, TrackPath::getDirectoryCount());
+    EXPECT_NE(first, second);
+}
+
+TEST(TrackPathTests, equality)
+{
+    const TrackPath path{ u"/music/album/track.flac" };
+
+    EXPECT_EQ(path, TrackPath{ u"/music/album/track.flac" });
+    EXPECT_NE(path, TrackPath{ u"/music/other/track.flac" });
+    EXPECT_EQ(TrackPathHasher{}(path), TrackPathHasher{}(TrackPath{ u"/music/album/track.flac" }));
+}
+
+TEST(TrackPathTests, compareMatchesFullPathOrder)
+{
+    const TrackPath paths[] = {
+        TrackPath{ u"/a/z.mp3" },
+        TrackPath{ u"/a/b/c.mp3" },
+        TrackPath{ u"/a/b.mp3" },
+        TrackPath{ u"/a/" },
+        TrackPath{ u"relative.mp3" },
+    };
+
+    for(const auto &l : paths)
+    {
+        for(const auto &r : paths)
+        {
+            const auto expected = l.toString().compare(r.toString());
+            const auto result = l.compare(r);
+            const auto message = QString{ "%1 vs %2" }.arg(l.toString(), r.toString()).toStdString();
+
+            EXPECT_EQ(expected < 0, result < 0) << message;
+            EXPECT_EQ(expected == 0, result == 0) << message;
+        }
+    }
+}
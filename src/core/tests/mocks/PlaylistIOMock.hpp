@@ -8,7 +8,12 @@ class PlaylistIOMock : public IPlaylistIO
 {
 public:
     MOCK_METHOD(Playlist, load, (const QString &), (override));
-    MOCK_METHOD(bool, save, (const Playlist &), (override));
+    MOCK_METHOD(std::vector<std::optional<Playlist>>, loadAll, (const std::vector<QString> &), (override));
+    MOCK_METHOD(bool, save, (const Playlist &, const PlaylistChange &), (override));
     MOCK_METHOD(bool, rename, (const Playlist &, const QString &), (override));
+    MOCK_METHOD(bool, remove, (const Playlist &), (override));
     MOCK_METHOD(std::vector<PlaylistTrack>, loadTracks, (const std::vector<QUrl> &), (override));
+    MOCK_METHOD(void, resolveTracks, (const std::vector<TrackPath> &), (override));
+    MOCK_METHOD(std::optional<std::vector<PlaylistTrack>>, importTracks, (const QString &), (override));
+    MOCK_METHOD(bool, exportTracks, (const Playlist &, const QString &), (override));
 };
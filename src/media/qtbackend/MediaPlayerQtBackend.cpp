@@ -107,7 +107,7 @@ void MediaPlayerQtBackend::setVolume(float volume, const char *eventSource)
 
 void MediaPlayerQtBackend::setTrack(const PlaylistTrack &playlistTrack)
 {
-    impl->player.setSource(playlistTrack.path);
+    impl->player.setSource(playlistTrack.path.toString());
     emit trackChanged(playlistTrack);
 }
 
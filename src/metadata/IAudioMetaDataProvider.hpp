@@ -11,6 +11,7 @@ class IAudioMetaDataProvider
 {
 public:
     virtual ~IAudioMetaDataProvider() = default;
+    // Called from multiple threads at once, tags of playlists are read in parallel
     virtual std::optional<ProvidedMetadata> getMetaData(const QString &filepath) = 0;
     virtual std::optional<CoverArt> readCoverFromDirectory(QDir directory) = 0;
 };
@@ -1,6 +1,7 @@
 #include "MetaDataCache.hpp"
 
 #include <QDebug>
+#include <QRandomGenerator>
 #include <QVariant>
 #include <QtSql>
 
@@ -10,8 +11,9 @@
 class MetaDataCache::Impl
 {
 public:
-    Impl(QSqlDatabase database)
+    Impl(QSqlDatabase database, std::uint64_t generation)
     : database{ database }
+    , generation{ generation }
     {
     }
 
@@ -19,6 +21,8 @@ public:
     const Impl &operator=(const Impl &) = delete;
 
     QSqlDatabase database;
+    std::uint64_t generation;
+    MetaDataCache::ChangeListener changeListener;
 };
 
 
@@ -36,7 +40,7 @@ MetaDataCache::MetaDataCache(QString databaseFile)
 
     createTable();
 
-    impl = std::make_unique<Impl>(std::move(database));
+    impl = std::make_unique<Impl>(std::move(database), readGeneration());
 }
 
 MetaDataCache::~MetaDataCache() = default;
@@ -108,6 +112,11 @@ std::unordered_map<QString, std::optional<Metadata>> MetaDataCache::batchFindByP
     return cachedMetadata;
 }
 
+std::uint64_t MetaDataCache::getGeneration() const
+{
+    return impl->generation;
+}
+
 std::vector<CachedCoverHash> MetaDataCache::getCoverArtHashCache()
 {
     QSqlQuery query;
@@ -166,6 +175,12 @@ INSERT INTO metadata (path, title, artist, albumName, albumDiscNumber, albumTrac
 VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
 )");
 
+    std::vector<CachedTrack> changes;
+    if(impl->changeListener)
+    {
+        changes.reserve(entries.size());
+    }
+
     for(const auto &it : entries)
     {
         query.addBindValue(it.first);
@@ -182,6 +197,10 @@ VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
         {
             qWarning() << "Could not cache entry" << query.lastError();
         }
+        else if(impl->changeListener)
+        {
+            changes.push_back(CachedTrack{ it.first, it.second.audioMetadata, it.second.lastModified });
+        }
     }
 
     if(!impl->database.commit())
@@ -195,9 +214,49 @@ VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
         return false;
     }
 
+    if(impl->changeListener and not changes.empty())
+    {
+        impl->changeListener(changes);
+    }
+
     return true;
 }
 
+void MetaDataCache::forEachTrack(const std::function<void(const CachedTrack &)> &function)
+{
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare("SELECT path, title, artist, albumName, albumDiscNumber, albumTrackNumber, "
+                  "duration, lastModified FROM metadata");
+
+    if(!query.exec())
+    {
+        qWarning() << "Could not query tracks:" << query.lastError().databaseText();
+        return;
+    }
+
+    while(query.next())
+    {
+        function(CachedTrack{
+            query.value(0).toString(),
+            AudioMetaData{
+                query.value(1).toString(),
+                query.value(2).toString(),
+                query.value(3).toString(),
+                query.value(4).toInt(),
+                query.value(5).toInt(),
+                std::chrono::seconds(query.value(6).toLongLong()),
+            },
+            std::chrono::seconds(query.value(7).toLongLong()),
+        });
+    }
+}
+
+void MetaDataCache::setChangeListener(ChangeListener listener)
+{
+    impl->changeListener = std::move(listener);
+}
+
 std::vector<Album> MetaDataCache::getAlbums()
 {
     QSqlQuery query;
@@ -279,4 +338,40 @@ CREATE TABLE IF NOT EXISTS "covers" (
     {
         qWarning() << "Could not create a covers table:" << query.lastError().databaseText();
     }
+
+    query.prepare(R"(
+CREATE TABLE IF NOT EXISTS "properties" (
+    "key" TEXT PRIMARY KEY,
+    "value" INTEGER NOT NULL
+);
+)");
+
+    if(!query.exec())
+    {
+        qWarning() << "Could not create a properties table:" << query.lastError().databaseText();
+    }
+}
+
+std::uint64_t MetaDataCache::readGeneration()
+{
+    QSqlQuery query;
+    query.prepare(R"(SELECT value FROM properties WHERE key = 'generation';)");
+
+    if(query.exec() && query.first())
+    {
+        return static_cast<std::uint64_t>(query.value(0).toLongLong());
+    }
+
+    // New database, nothing written before can refer to its content
+    const auto generation = QRandomGenerator::global()->generate64();
+
+    query.prepare(R"(INSERT INTO properties (key, value) VALUES ('generation', ?);)");
+    query.addBindValue(static_cast<qint64>(generation));
+
+    if(!query.exec())
+    {
+        qWarning() << "Could not store cache generation:" << query.lastError().databaseText();
+    }
+
+    return generation;
 }
@@ -7,10 +7,14 @@
 #include <QByteArray>
 #include <QString>
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 struct CachedCoverHash
 {
@@ -18,6 +22,13 @@ struct CachedCoverHash
     QByteArray hash;
 };
 
+struct CachedTrack
+{
+    QString path;
+    AudioMetaData audioMetadata;
+    std::chrono::seconds lastModified;
+};
+
 class MetaDataCache final
 {
 public:
@@ -31,16 +42,28 @@ public:
 
     std::unordered_map<QString, std::optional<Metadata>> batchFindByPath(std::set<QString> paths);
 
+    // Identifies the cached content, metadata copied out of the cache (e.g. into
+    // playlist files) is valid only as long as the generation stays the same
+    std::uint64_t getGeneration() const;
+
     std::vector<CachedCoverHash> getCoverArtHashCache();
     std::optional<uint64_t> cache(const QByteArray &data, const QByteArray &hash);
 
     bool cache(const std::unordered_map<QString, UncachedMetadata> &entries);
 
+    // Single pass over all cached tracks, in no particular order
+    void forEachTrack(const std::function<void(const CachedTrack &)> &function);
+
+    // Called with the entries written by every successful cache(entries)
+    using ChangeListener = std::function<void(const std::vector<CachedTrack> &)>;
+    void setChangeListener(ChangeListener listener);
+
     std::vector<Album> getAlbums();
     std::optional<QByteArray> getCoverDataById(quint64 id);
 
 private:
     void createTable();
+    std::uint64_t readGeneration();
 
 private:
     class Impl;
@@ -80,12 +80,13 @@ void emitPropertyChanged(const QString &key, const QVariant &value, const char *
 
 QVariantMap convert(const PlaylistTrack &track)
 {
-    auto length = std::chrono::duration<quint64, std::milli>(track.audioMetaData->duration).count();
+    const auto duration = track.audioMetaData ? track.audioMetaData->duration : std::chrono::seconds{ 0 };
+    const auto length = std::chrono::duration<quint64, std::milli>(duration).count();
 
     if(track.audioMetaData && !track.audioMetaData->title.isEmpty())
     {
         return {
-            { "xesam:url", track.path },
+            { "xesam:url", track.path.toString() },
             { "xesam:title", track.audioMetaData->title },
             { "xesam:artist", track.audioMetaData->artist },
             { "xesam:album", track.audioMetaData->albumName },
@@ -97,8 +98,8 @@ QVariantMap convert(const PlaylistTrack &track)
     else
     {
         return {
-            { "xesam:url", track.path },
-            { "xesam:title", QFileInfo(track.path).completeBaseName() },
+            { "xesam:url", track.path.toString() },
+            { "xesam:title", QFileInfo(track.path.getFileName()).completeBaseName() },
             { "mpris:length", length },
         };
     }